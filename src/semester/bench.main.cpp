@@ -0,0 +1,311 @@
+/**
+ * Benchmarks for the hot paths of the data and walk APIs: construction, copy,
+ * move, equality, visit, walk pipelines, and decoding, over synthetic
+ * JSON-shaped trees.
+ *
+ * Usage: bench [--filter <text>] [--min-time <seconds>]
+ *
+ * Only benchmarks whose name contains the filter text are run. Results are
+ * written to stdout as a JSON document, and progress is written to stderr.
+ */
+
+#include <semester/cbor.hpp>
+#include <semester/json.hpp>
+#include <semester/json_parse.hpp>
+#include <semester/json_serialize.hpp>
+#include <semester/sink.hpp>
+#include <semester/tape.hpp>
+#include <semester/walk.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+/// Results are accumulated here so that the measured work cannot be discarded
+volatile std::size_t g_sink = 0;
+
+/**
+ * The shape of a synthetic tree. Levels of mappings and arrays alternate down
+ * to `depth`, and the values below the last level are scalars.
+ */
+struct tree_shape {
+    const char* name;
+    /// The number of elements in each array
+    int width;
+    /// The number of keys in each mapping
+    int keys;
+    /// The number of levels of containers
+    int depth;
+    /// Whether the root is an array rather than a mapping
+    bool array_root;
+};
+
+constexpr tree_shape shapes[] = {
+    {"records", 2000, 8, 2, true},
+    {"wide-mapping", 1, 5000, 1, false},
+    {"deep", 2, 2, 12, false},
+    {"mixed", 10, 10, 4, false},
+};
+
+template <typename Data>
+Data make_leaf(int n) {
+    switch (n % 4) {
+    case 0:
+        return Data(static_cast<double>(n));
+    case 1:
+        return Data("value " + std::to_string(n));
+    case 2:
+        return Data(n % 3 == 0);
+    default:
+        return Data(semester::null);
+    }
+}
+
+template <typename Data>
+Data make_tree(const tree_shape& shape, int level, int& counter) {
+    if (level == shape.depth) {
+        return make_leaf<Data>(counter++);
+    }
+    if ((level % 2 == 0) == shape.array_root) {
+        typename Data::array_type arr;
+        for (int i = 0; i < shape.width; ++i) {
+            arr.push_back(make_tree<Data>(shape, level + 1, counter));
+        }
+        return Data(std::move(arr));
+    }
+    typename Data::mapping_type map;
+    for (int i = 0; i < shape.keys; ++i) {
+        map.emplace("key-" + std::to_string(i), make_tree<Data>(shape, level + 1, counter));
+    }
+    return Data(std::move(map));
+}
+
+template <typename Data>
+Data make_tree(const tree_shape& shape) {
+    int counter = 0;
+    return make_tree<Data>(shape, 0, counter);
+}
+
+template <typename Data>
+std::size_t count_nodes(const Data& dat) {
+    return dat.visit([](const auto& val) -> std::size_t {
+        using type = std::remove_cvref_t<decltype(val)>;
+        if constexpr (std::is_same_v<type, typename Data::mapping_type>) {
+            std::size_t n = 1;
+            for (const auto& [key, child] : val) {
+                n += count_nodes(child);
+            }
+            return n;
+        } else if constexpr (std::is_same_v<type, typename Data::array_type>) {
+            std::size_t n = 1;
+            for (const auto& child : val) {
+                n += count_nodes(child);
+            }
+            return n;
+        } else {
+            return 1;
+        }
+    });
+}
+
+/// The records that are extracted from data by the walk benchmark
+struct record {
+    double                   id = 0;
+    std::string              name;
+    std::vector<std::string> tags;
+    bool                     active = false;
+};
+
+template <typename Data>
+Data make_records(int count) {
+    typename Data::array_type arr;
+    for (int i = 0; i < count; ++i) {
+        typename Data::array_type tags;
+        for (int t = 0; t < i % 4; ++t) {
+            tags.push_back(Data("tag-" + std::to_string(t)));
+        }
+        typename Data::mapping_type map;
+        map.emplace("id", Data(static_cast<double>(i)));
+        map.emplace("name", Data("record " + std::to_string(i)));
+        map.emplace("tags", Data(std::move(tags)));
+        map.emplace("active", Data(i % 2 == 0));
+        arr.push_back(Data(std::move(map)));
+    }
+    return Data(std::move(arr));
+}
+
+template <typename Data>
+std::vector<record> walk_records(const Data& dat) {
+    using namespace semester::walk_ops;
+    std::vector<record> out;
+    semester::walk(dat, for_each{[&](const Data& item) {
+                       record& rec = out.emplace_back();
+                       return semester::walk.try_walk(
+                           item,
+                           mapping{
+                               required_key{"id"_key, "An 'id' is required", put_into(rec.id)},
+                               if_key{"name"_key, put_into(rec.name)},
+                               if_key{"tags"_key, for_each{put_into(std::back_inserter(rec.tags))}},
+                               if_key{"active"_key, put_into(rec.active)},
+                           });
+                   }});
+    return out;
+}
+
+struct options {
+    std::string_view filter;
+    double           min_time = 0.5;
+};
+
+struct runner {
+    options                         opts;
+    semester::json_data::array_type results;
+
+    bool wanted(std::string_view name) const {
+        return name.find(opts.filter) != std::string_view::npos;
+    }
+
+    /**
+     * Run `fn` in batches, growing the batch until it takes a fifth of the
+     * minimum time. Five batches of that size are measured, and the median and
+     * best time per iteration are recorded.
+     */
+    template <typename Fn>
+    void measure(std::string_view group,
+                 std::string_view data_name,
+                 const char*      shape,
+                 std::size_t      nodes,
+                 Fn&&             fn) {
+        const std::string name = std::string(group) + "/" + std::string(data_name) + "/" + shape;
+        if (!wanted(name)) {
+            return;
+        }
+        std::fprintf(stderr, "%s ...\n", name.c_str());
+
+        const auto run_batch = [&](std::size_t n) {
+            const auto start = clock_type::now();
+            for (std::size_t i = 0; i < n; ++i) {
+                fn();
+            }
+            return std::chrono::duration<double>(clock_type::now() - start).count();
+        };
+
+        std::size_t batch = 1;
+        while (run_batch(batch) < opts.min_time / 5 && batch < (std::size_t(1) << 30)) {
+            batch *= 2;
+        }
+        std::vector<double> per_iter;
+        for (int i = 0; i < 5; ++i) {
+            per_iter.push_back(run_batch(batch) * 1e9 / static_cast<double>(batch));
+        }
+        std::sort(per_iter.begin(), per_iter.end());
+
+        results.push_back(semester::json_data::mapping_type{
+            {"name", name},
+            {"group", std::string(group)},
+            {"data", std::string(data_name)},
+            {"shape", shape},
+            {"nodes", static_cast<double>(nodes)},
+            {"iterations", static_cast<double>(batch * per_iter.size())},
+            {"ns_per_iter", per_iter[per_iter.size() / 2]},
+            {"best_ns_per_iter", per_iter.front()},
+        });
+    }
+};
+
+template <typename Data>
+void run_data_benchmarks(runner& r, std::string_view data_name) {
+    for (const auto& shape : shapes) {
+        const Data        tree  = make_tree<Data>(shape);
+        const std::size_t nodes = count_nodes(tree);
+
+        r.measure("construct", data_name, shape.name, nodes, [&] {
+            g_sink = g_sink + make_tree<Data>(shape).is_mapping();
+        });
+        r.measure("copy", data_name, shape.name, nodes, [&] {
+            Data copy = tree;
+            g_sink    = g_sink + copy.is_mapping();
+        });
+        Data moving = tree;
+        r.measure("move", data_name, shape.name, nodes, [&] {
+            Data tmp = std::move(moving);
+            moving   = std::move(tmp);
+            g_sink   = g_sink + moving.is_mapping();
+        });
+        const Data same = tree;
+        r.measure("equal", data_name, shape.name, nodes, [&] {
+            g_sink = g_sink + (tree == same);
+        });
+        r.measure("visit", data_name, shape.name, nodes, [&] {
+            g_sink = g_sink + count_nodes(tree);
+        });
+    }
+
+    const Data records = make_records<Data>(5000);
+    r.measure("walk", data_name, "records", count_nodes(records), [&] {
+        g_sink = g_sink + walk_records(records).size();
+    });
+}
+
+void run_tape_benchmarks(runner& r) {
+    const auto records = semester::json_data(make_records<semester::json_data>(5000));
+    const auto tape    = semester::tape_document::from_data(records);
+    r.measure("construct", "tape", "records", tape.entry_count(), [&] {
+        g_sink = g_sink + semester::tape_document::from_data(records).entry_count();
+    });
+    r.measure("walk", "tape", "records", tape.entry_count(), [&] {
+        g_sink = g_sink + walk_records(tape.root()).size();
+    });
+}
+
+void run_decode_benchmarks(runner& r) {
+    const auto records = semester::json_data(make_records<semester::json_data>(5000));
+    const auto text    = semester::to_json_string(records);
+    const auto cbor    = semester::to_cbor_string(records);
+    const auto nodes   = count_nodes(records);
+    r.measure("decode", "json_text", "records", nodes, [&] {
+        g_sink = g_sink + semester::parse_json(text).is_array();
+    });
+    r.measure("decode", "cbor", "records", nodes, [&] {
+        g_sink = g_sink + semester::read_cbor(cbor).is_array();
+    });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    runner r;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            r.opts.filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            r.opts.min_time = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--filter <text>] [--min-time <seconds>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    run_data_benchmarks<semester::json_data>(r, "json_data");
+    run_data_benchmarks<semester::json_flat_data>(r, "json_flat_data");
+    run_data_benchmarks<semester::json_cow_data>(r, "json_cow_data");
+    run_tape_benchmarks(r);
+    run_decode_benchmarks(r);
+
+    semester::json_data doc = semester::json_data::mapping_type{
+        {"min_time", r.opts.min_time},
+        {"benchmarks", std::move(r.results)},
+    };
+    semester::write_json(doc, semester::fd_sink(1), {.pretty = true});
+    std::fputs("\n", stdout);
+}
@@ -0,0 +1,710 @@
+#pragma once
+
+#include <semester/config.hpp>
+#include <semester/data.hpp>
+#include <semester/json.hpp>
+#include <semester/json_parse.hpp>
+#include <semester/json_serialize.hpp>
+#include <semester/sink.hpp>
+#include <semester/source.hpp>
+
+#include <neo/fwd.hpp>
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace semester {
+
+/**
+ * Error conditions that can be encountered while decoding CBOR.
+ */
+enum class cbor_errc {
+    none = 0,
+    unexpected_end,
+    invalid_header,
+    unsupported_item,
+    non_string_key,
+    too_deep,
+    trailing_bytes,
+};
+
+/**
+ * Get a human-readable description of a CBOR decoding error
+ */
+constexpr const char* describe(cbor_errc ec) noexcept {
+    switch (ec) {
+    case cbor_errc::none:
+        return "No error";
+    case cbor_errc::unexpected_end:
+        return "Unexpected end of input";
+    case cbor_errc::invalid_header:
+        return "Invalid item header";
+    case cbor_errc::unsupported_item:
+        return "Item has no representation in the data";
+    case cbor_errc::non_string_key:
+        return "Map key is not a text string";
+    case cbor_errc::too_deep:
+        return "Maximum nesting depth exceeded";
+    case cbor_errc::trailing_bytes:
+        return "Trailing bytes after CBOR item";
+    }
+    return "Unknown error";
+}
+
+/**
+ * Exception thrown by read_cbor() when given invalid or unsupported CBOR.
+ */
+struct cbor_error : std::runtime_error {
+    cbor_errc   code;
+    std::size_t offset;
+
+    cbor_error(cbor_errc ec, std::size_t off)
+        : runtime_error("Invalid CBOR at offset " + std::to_string(off) + ": " + describe(ec))
+        , code(ec)
+        , offset(off) {}
+};
+
+/**
+ * The result of try_read_cbor(). If decoding failed, `error` and `offset`
+ * describe the failure and `value` is unspecified.
+ */
+template <typename Data>
+struct cbor_read_result {
+    Data        value;
+    cbor_errc   error  = cbor_errc::none;
+    std::size_t offset = 0;
+
+    explicit operator bool() const noexcept { return error == cbor_errc::none; }
+};
+
+/**
+ * Options to control CBOR decoding.
+ */
+struct cbor_read_options {
+    /// The maximum nesting of arrays and maps that will be accepted
+    std::size_t max_depth = 1024;
+};
+
+// clang-format off
+/**
+ * Matches JSON-shaped data that can also store binary strings, in an
+ * alternative named by `bytes_type`. Without one, binary strings are decoded
+ * into the `string_type` alternative.
+ */
+template <typename Data>
+concept cbor_bytes_data = json_shaped_data<Data> && requires {
+    typename Data::traits_type::bytes_type;
+};
+// clang-format on
+
+namespace detail {
+
+// clang-format off
+/// A contiguous sequence of std::byte, encoded as a CBOR byte string
+template <typename T>
+concept cbor_byte_string = requires(const T& bytes) {
+    { std::data(bytes) } -> std::same_as<const std::byte*>;
+    { std::size(bytes) } -> std::convertible_to<std::size_t>;
+};
+// clang-format on
+
+/// The major types of CBOR data items
+enum class cbor_major : std::uint8_t {
+    uint   = 0,
+    negint = 1,
+    bytes  = 2,
+    text   = 3,
+    array  = 4,
+    map    = 5,
+    tag    = 6,
+    simple = 7,
+};
+
+/// The additional information value that marks an indefinite length
+constexpr std::uint8_t cbor_indefinite = 31;
+/// The byte that ends an indefinite-length item
+constexpr std::uint8_t cbor_break = 0xff;
+
+/**
+ * Writes data items in CBOR (RFC 8949). Integers and lengths are written in
+ * their shortest form. A floating-point number is written as a single-precision
+ * float if that is exact, and otherwise as a double.
+ */
+template <typename Writer>
+class cbor_encoder {
+    Writer& _out;
+
+    void _head(cbor_major major, std::uint64_t arg) {
+        constexpr std::size_t max_len = 9;
+        const auto            mt      = static_cast<std::uint8_t>(static_cast<int>(major) << 5);
+        auto                  buf     = reinterpret_cast<unsigned char*>(_out.reserve(max_len));
+        std::size_t           n_bytes = 0;
+        if (arg < 24) {
+            buf[0] = static_cast<unsigned char>(mt | arg);
+        } else if (arg <= 0xff) {
+            buf[0]  = static_cast<unsigned char>(mt | 24);
+            n_bytes = 1;
+        } else if (arg <= 0xffff) {
+            buf[0]  = static_cast<unsigned char>(mt | 25);
+            n_bytes = 2;
+        } else if (arg <= 0xffff'ffff) {
+            buf[0]  = static_cast<unsigned char>(mt | 26);
+            n_bytes = 4;
+        } else {
+            buf[0]  = static_cast<unsigned char>(mt | 27);
+            n_bytes = 8;
+        }
+        for (std::size_t i = 0; i < n_bytes; ++i) {
+            buf[n_bytes - i] = static_cast<unsigned char>(arg >> (8 * i));
+        }
+        _out.commit(n_bytes + 1);
+    }
+
+    template <typename Float>
+    void _float(Float n) {
+        const auto single = static_cast<float>(n);
+        if (static_cast<Float>(single) == n) {
+            std::uint32_t bits = 0;
+            std::memcpy(&bits, &single, sizeof bits);
+            _head_bits(26, bits, 4);
+        } else {
+            const auto    dbl  = static_cast<double>(n);
+            std::uint64_t bits = 0;
+            std::memcpy(&bits, &dbl, sizeof bits);
+            _head_bits(27, bits, 8);
+        }
+    }
+
+    /// Write a simple value header followed by exactly `n_bytes` of `bits`
+    void _head_bits(std::uint8_t info, std::uint64_t bits, std::size_t n_bytes) {
+        auto buf = reinterpret_cast<unsigned char*>(_out.reserve(n_bytes + 1));
+        buf[0]   = static_cast<unsigned char>(0xe0 | info);
+        for (std::size_t i = 0; i < n_bytes; ++i) {
+            buf[n_bytes - i] = static_cast<unsigned char>(bits >> (8 * i));
+        }
+        _out.commit(n_bytes + 1);
+    }
+
+    void _string(cbor_major major, const char* data, std::size_t size) {
+        _head(major, size);
+        _out.write(data, size);
+    }
+
+public:
+    explicit cbor_encoder(Writer& out) noexcept
+        : _out(out) {}
+
+    template <typename Data>
+    void value(const Data& dat) {
+        dat.visit([&](const auto& item) { this->item<Data>(item); });
+    }
+
+    template <typename Data, typename T>
+    void item(const T& item) {
+        if constexpr (std::same_as<T, null_t>) {
+            _out.put(static_cast<char>(0xf6));
+        } else if constexpr (std::same_as<T, bool>) {
+            _out.put(static_cast<char>(item ? 0xf5 : 0xf4));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            _float(item);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            if (item < 0) {
+                // The argument of a negative integer n is -1 - n, which is ~n
+                _head(cbor_major::negint, ~static_cast<std::uint64_t>(item));
+            } else {
+                _head(cbor_major::uint, static_cast<std::uint64_t>(item));
+            }
+        } else if constexpr (std::is_integral_v<T>) {
+            _head(cbor_major::uint, item);
+        } else if constexpr (std::convertible_to<const T&, std::string_view>) {
+            const auto str = std::string_view(item);
+            _string(cbor_major::text, str.data(), str.size());
+        } else if constexpr (cbor_byte_string<T>) {
+            _string(cbor_major::bytes,
+                    reinterpret_cast<const char*>(std::data(item)),
+                    static_cast<std::size_t>(std::size(item)));
+        } else if constexpr (json_mapping_like<T, Data>) {
+            _head(cbor_major::map, item.size());
+            for (const auto& [key, child] : item) {
+                const auto key_str = std::string_view(key);
+                _string(cbor_major::text, key_str.data(), key_str.size());
+                value(child);
+            }
+        } else if constexpr (json_array_like<T, Data>) {
+            _head(cbor_major::array, item.size());
+            for (const auto& child : item) {
+                value(child);
+            }
+        } else {
+            static_assert(std::is_void_v<T>, "No CBOR representation for this data alternative");
+        }
+    }
+};
+
+/// Convert the bits of an IEEE 754 half-precision float to a double
+inline double cbor_half_to_double(std::uint16_t half) noexcept {
+    const int exp  = (half >> 10) & 0x1f;
+    const int mant = half & 0x3ff;
+    double    val  = 0;
+    if (exp == 0) {
+        val = std::ldexp(mant, -24);
+    } else if (exp != 31) {
+        val = std::ldexp(mant + 1024, exp - 25);
+    } else {
+        val = mant == 0 ? std::numeric_limits<double>::infinity()
+                        : std::numeric_limits<double>::quiet_NaN();
+    }
+    return (half & 0x8000) ? -val : val;
+}
+
+/**
+ * Decodes a CBOR data item into JSON-shaped data, taking its input from a
+ * Reader (memory_reader or buffered_reader). Errors are reported through
+ * `error`; the decoder itself never throws (except for allocation failure, and
+ * whatever the reader's source may throw).
+ */
+template <json_shaped_data Data, typename Reader>
+class cbor_decoder {
+public:
+    using traits_type  = typename Data::traits_type;
+    using null_type    = typename traits_type::null_type;
+    using bool_type    = typename traits_type::bool_type;
+    using number_type  = typename traits_type::number_type;
+    using string_type  = typename traits_type::string_type;
+    using array_type   = array_type_t<Data>;
+    using mapping_type = mapping_type_t<Data>;
+
+    cbor_errc error = cbor_errc::none;
+
+private:
+    Reader&           _in;
+    cbor_read_options _opts;
+
+    bool _fail(cbor_errc ec) noexcept {
+        error = ec;
+        return false;
+    }
+
+    bool _byte(std::uint8_t& b) {
+        char c = 0;
+        if (!_in.get(c)) {
+            return _fail(cbor_errc::unexpected_end);
+        }
+        b = static_cast<std::uint8_t>(c);
+        return true;
+    }
+
+    /**
+     * Read the argument that follows an initial byte. An indefinite length is
+     * not an argument, and is rejected here.
+     */
+    bool _arg(std::uint8_t initial, std::uint64_t& arg) {
+        const std::uint8_t info = initial & 0x1f;
+        if (info < 24) {
+            arg = info;
+            return true;
+        }
+        if (info > 27) {
+            return _fail(cbor_errc::invalid_header);
+        }
+        const std::size_t n_bytes = std::size_t(1) << (info - 24);
+        unsigned char     buf[8];
+        if (!_in.read(reinterpret_cast<char*>(buf), n_bytes)) {
+            return _fail(cbor_errc::unexpected_end);
+        }
+        arg = 0;
+        for (std::size_t i = 0; i < n_bytes; ++i) {
+            arg = (arg << 8) | buf[i];
+        }
+        return true;
+    }
+
+    /// Append `size` bytes of input to `out`, without trusting `size` for an allocation
+    template <typename String>
+    bool _append(String& out, std::uint64_t size) {
+        using char_type = typename String::value_type;
+        if (size <= std::numeric_limits<std::size_t>::max()) {
+            // Copy straight from the input if it is at hand
+            if (const char* ptr = _in.take(static_cast<std::size_t>(size))) {
+                const auto first = reinterpret_cast<const char_type*>(ptr);
+                out.insert(out.end(), first, first + size);
+                return true;
+            }
+        }
+        constexpr std::uint64_t chunk = 64 * 1024;
+        while (size) {
+            const auto n   = static_cast<std::size_t>(size < chunk ? size : chunk);
+            const auto old = out.size();
+            out.resize(old + n);
+            if (!_in.read(reinterpret_cast<char*>(out.data()) + old, n)) {
+                return _fail(cbor_errc::unexpected_end);
+            }
+            size -= n;
+        }
+        return true;
+    }
+
+    /// Read the content of a text or byte string, which may be in chunks
+    template <typename String>
+    bool _string_body(String& out, std::uint8_t initial) {
+        if ((initial & 0x1f) != cbor_indefinite) {
+            std::uint64_t size = 0;
+            return _arg(initial, size) && _append(out, size);
+        }
+        while (true) {
+            std::uint8_t chunk_initial = 0;
+            if (!_byte(chunk_initial)) {
+                return false;
+            }
+            if (chunk_initial == cbor_break) {
+                return true;
+            }
+            // Each chunk must be a definite string of the same major type
+            if ((chunk_initial >> 5) != (initial >> 5)
+                || (chunk_initial & 0x1f) == cbor_indefinite) {
+                return _fail(cbor_errc::invalid_header);
+            }
+            std::uint64_t size = 0;
+            if (!_arg(chunk_initial, size) || !_append(out, size)) {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * Call `fn` for each item of an array or map whose initial byte is
+     * `initial`, with the initial byte of the item. `fn` returns `false` to
+     * stop. If the number of items is known, room is reserved for them in
+     * `into`.
+     */
+    template <typename Container, typename Func>
+    bool _each_item(std::uint8_t initial, Container& into, Func&& fn) {
+        if ((initial & 0x1f) == cbor_indefinite) {
+            while (true) {
+                std::uint8_t item_initial = 0;
+                if (!_byte(item_initial)) {
+                    return false;
+                }
+                if (item_initial == cbor_break) {
+                    return true;
+                }
+                if (!fn(item_initial)) {
+                    return false;
+                }
+            }
+        }
+        std::uint64_t count = 0;
+        if (!_arg(initial, count)) {
+            return false;
+        }
+        if constexpr (requires { into.reserve(std::size_t()); }) {
+            // Every item takes at least a byte, so do not reserve more than the input at hand
+            const auto at_hand = static_cast<std::uint64_t>(_in.available());
+            into.reserve(static_cast<std::size_t>(count < at_hand ? count : at_hand));
+        }
+        for (; count; --count) {
+            std::uint8_t item_initial = 0;
+            if (!_byte(item_initial) || !fn(item_initial)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool _integer(Data& out, bool negative, std::uint64_t arg) {
+        if constexpr (json_int_numbers<Data>) {
+            using int_type  = typename traits_type::int_type;
+            using uint_type = typename traits_type::uint_type;
+            if (arg <= static_cast<std::uint64_t>((std::numeric_limits<int_type>::max)())) {
+                const auto n = static_cast<std::int64_t>(arg);
+                out.template emplace<int_type>(static_cast<int_type>(negative ? -1 - n : n));
+                return true;
+            }
+            if (!negative) {
+                out.template emplace<uint_type>(static_cast<uint_type>(arg));
+                return true;
+            }
+        }
+        const auto n = static_cast<double>(arg);
+        out.template emplace<number_type>(static_cast<number_type>(negative ? -1.0 - n : n));
+        return true;
+    }
+
+    bool _simple(Data& out, std::uint8_t initial) {
+        const std::uint8_t info = initial & 0x1f;
+        switch (info) {
+        case 20:
+            out.template emplace<bool_type>(false);
+            return true;
+        case 21:
+            out.template emplace<bool_type>(true);
+            return true;
+        case 22:
+            out.template emplace<null_type>();
+            return true;
+        case 25:
+        case 26:
+        case 27: {
+            std::uint64_t bits = 0;
+            if (!_arg(initial, bits)) {
+                return false;
+            }
+            double val = 0;
+            if (info == 25) {
+                val = cbor_half_to_double(static_cast<std::uint16_t>(bits));
+            } else if (info == 26) {
+                const auto single_bits = static_cast<std::uint32_t>(bits);
+                float      single      = 0;
+                std::memcpy(&single, &single_bits, sizeof single);
+                val = single;
+            } else {
+                std::memcpy(&val, &bits, sizeof val);
+            }
+            out.template emplace<number_type>(static_cast<number_type>(val));
+            return true;
+        }
+        case 28:
+        case 29:
+        case 30:
+        case cbor_indefinite:
+            // Reserved, or a break that does not end an indefinite-length item
+            return _fail(cbor_errc::invalid_header);
+        default:
+            // 'undefined', and the unassigned simple values
+            return _fail(cbor_errc::unsupported_item);
+        }
+    }
+
+    bool _array(Data& out, std::uint8_t initial, std::size_t depth) {
+        auto& arr = out.template emplace<array_type>();
+        return _each_item(initial, arr, [&](std::uint8_t item_initial) {
+            return decode_item(arr.emplace_back(), item_initial, depth);
+        });
+    }
+
+    bool _mapping(Data& out, std::uint8_t initial, std::size_t depth) {
+        auto&                                 map = out.template emplace<mapping_type>();
+        detail::mapping_builder<mapping_type> members{map};
+        const bool ok = _each_item(initial, members, [&](std::uint8_t key_initial) {
+            if (static_cast<cbor_major>(key_initial >> 5) != cbor_major::text) {
+                return _fail(cbor_errc::non_string_key);
+            }
+            // Keys use the allocator of the mapping that will hold them
+            auto key = std::make_obj_using_allocator<string_type>(map.get_allocator());
+            if (!_string_body(key, key_initial)) {
+                return false;
+            }
+            std::uint8_t value_initial = 0;
+            if (!_byte(value_initial)) {
+                return false;
+            }
+            return decode_item(members.add(std::move(key)), value_initial, depth);
+        });
+        if (ok) {
+            members.finish();
+        }
+        return ok;
+    }
+
+    bool _bytes(Data& out, std::uint8_t initial) {
+        if constexpr (cbor_bytes_data<Data>) {
+            return _string_body(out.template emplace<typename traits_type::bytes_type>(),
+                                initial);
+        } else {
+            return _string_body(out.template emplace<string_type>(), initial);
+        }
+    }
+
+public:
+    cbor_decoder(Reader& in, cbor_read_options opts) noexcept
+        : _in(in)
+        , _opts(opts) {
+        static_assert(!json_view_strings<Data>,
+                      "Decoding CBOR into string views of the input is not supported");
+    }
+
+    /**
+     * Decode a single item, of which the initial byte has already been read
+     */
+    bool decode_item(Data& out, std::uint8_t initial, std::size_t depth) {
+        // Tags give a meaning to the item that follows them, which is kept as-is
+        while (static_cast<cbor_major>(initial >> 5) == cbor_major::tag) {
+            std::uint64_t tag = 0;
+            if (!_arg(initial, tag) || !_byte(initial)) {
+                return false;
+            }
+        }
+        const auto major = static_cast<cbor_major>(initial >> 5);
+        if (major == cbor_major::simple) {
+            return _simple(out, initial);
+        }
+        const bool indefinite = (initial & 0x1f) == cbor_indefinite;
+        if (indefinite && major != cbor_major::bytes && major != cbor_major::text
+            && major != cbor_major::array && major != cbor_major::map) {
+            return _fail(cbor_errc::invalid_header);
+        }
+        switch (major) {
+        case cbor_major::uint:
+        case cbor_major::negint: {
+            std::uint64_t arg = 0;
+            return _arg(initial, arg) && _integer(out, major == cbor_major::negint, arg);
+        }
+        case cbor_major::bytes:
+            return _bytes(out, initial);
+        case cbor_major::text:
+            return _string_body(out.template emplace<string_type>(), initial);
+        case cbor_major::array:
+        case cbor_major::map:
+            if (depth == _opts.max_depth) {
+                return _fail(cbor_errc::too_deep);
+            }
+            return major == cbor_major::array ? _array(out, initial, depth + 1)
+                                              : _mapping(out, initial, depth + 1);
+        default:
+            return _fail(cbor_errc::invalid_header);
+        }
+    }
+
+    /**
+     * Decode the entire input as a single item
+     */
+    bool decode_document(Data& out) {
+        std::uint8_t initial = 0;
+        if (!_byte(initial) || !decode_item(out, initial, 0)) {
+            return false;
+        }
+        char extra = 0;
+        if (_in.get(extra)) {
+            return _fail(cbor_errc::trailing_bytes);
+        }
+        return true;
+    }
+};
+
+template <typename Data, typename Reader>
+void read_cbor_into(cbor_read_result<Data>& ret, Reader& in, cbor_read_options opts) {
+    cbor_decoder<Data, Reader> dec{in, opts};
+    if (!dec.decode_document(ret.value)) {
+        ret.error  = dec.error;
+        ret.offset = in.offset();
+    }
+}
+
+}  // namespace detail
+
+/**
+ * Write the given data as a CBOR data item into the given output sink. Output
+ * is collected in a large buffer and passed to the sink in chunks.
+ */
+template <typename Data, output_sink Sink>
+void write_cbor(const Data& dat, Sink&& sink) {
+    buffered_writer<Sink&> out{sink};
+    detail::cbor_encoder   enc{out};
+    enc.value(dat);
+    out.flush();
+}
+
+/**
+ * Encode the given data as CBOR, returning the bytes in a string.
+ */
+template <typename Data>
+std::string to_cbor_string(const Data& dat) {
+    std::string str;
+    write_cbor(dat, string_sink{str});
+    return str;
+}
+
+/**
+ * Decode a single CBOR data item that fills `bytes`. The input is read in place,
+ * without copying it into a buffer. On failure, returns a result with `error`
+ * set rather than throwing.
+ */
+template <json_shaped_data Data = json_data>
+cbor_read_result<Data> try_read_cbor(std::string_view bytes, cbor_read_options opts = {}) {
+    cbor_read_result<Data> ret;
+    memory_reader          in{bytes};
+    detail::read_cbor_into(ret, in, opts);
+    return ret;
+}
+
+/**
+ * Decode a CBOR data item into a data object that allocates using `alloc`.
+ * Every node, key, and string of the document is created with the allocator,
+ * so a pmr allocator over a monotonic buffer decodes into an arena.
+ */
+template <json_shaped_data Data, typename Alloc>
+requires std::uses_allocator_v<Data, Alloc>  //
+    cbor_read_result<Data> try_read_cbor(std::string_view  bytes,
+                                         const Alloc&      alloc,
+                                         cbor_read_options opts = {}) {
+    cbor_read_result<Data> ret{Data(std::allocator_arg, alloc)};
+    memory_reader          in{bytes};
+    detail::read_cbor_into(ret, in, opts);
+    return ret;
+}
+
+/**
+ * Decode a single CBOR data item that fills the input of `source`. The input is
+ * taken from the source in large blocks by a buffered_reader.
+ */
+template <json_shaped_data Data = json_data, input_source Source>
+cbor_read_result<Data> try_read_cbor(Source&& source, cbor_read_options opts = {}) {
+    cbor_read_result<Data>  ret;
+    buffered_reader<Source> in{NEO_FWD(source)};
+    detail::read_cbor_into(ret, in, opts);
+    return ret;
+}
+
+/**
+ * Decode a CBOR data item from `source` into a data object that allocates using
+ * `alloc`.
+ */
+template <json_shaped_data Data, input_source Source, typename Alloc>
+requires std::uses_allocator_v<Data, Alloc>  //
+    cbor_read_result<Data> try_read_cbor(Source&&          source,
+                                         const Alloc&      alloc,
+                                         cbor_read_options opts = {}) {
+    cbor_read_result<Data>  ret{Data(std::allocator_arg, alloc)};
+    buffered_reader<Source> in{NEO_FWD(source)};
+    detail::read_cbor_into(ret, in, opts);
+    return ret;
+}
+
+/**
+ * Decode a single CBOR data item that fills `bytes`. Throws cbor_error if the
+ * input is not a valid data item, or if the item cannot be represented.
+ */
+template <json_shaped_data Data = json_data>
+Data read_cbor(std::string_view bytes, cbor_read_options opts = {}) {
+    auto result = try_read_cbor<Data>(bytes, opts);
+    if (!result) {
+        SEMESTER_THROW(cbor_error(result.error, result.offset));
+    }
+    return std::move(result.value);
+}
+
+/**
+ * Decode a CBOR data item into a data object that allocates using `alloc`.
+ * Throws cbor_error if the input is not a valid data item.
+ */
+template <json_shaped_data Data, typename Alloc>
+requires std::uses_allocator_v<Data, Alloc>  //
+    Data read_cbor(std::string_view bytes, const Alloc& alloc, cbor_read_options opts = {}) {
+    auto result = try_read_cbor<Data>(bytes, alloc, opts);
+    if (!result) {
+        SEMESTER_THROW(cbor_error(result.error, result.offset));
+    }
+    return std::move(result.value);
+}
+
+}  // namespace semester
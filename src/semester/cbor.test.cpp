@@ -0,0 +1,186 @@
+#include <semester/cbor.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace {
+
+std::string bytes(std::initializer_list<int> il) {
+    std::string ret;
+    for (auto b : il) {
+        ret.push_back(static_cast<char>(b));
+    }
+    return ret;
+}
+
+/// JSON data with exact integers, and an alternative for binary strings
+struct json_bytes_traits {
+    template <typename Data>
+    struct traits : semester::json_int_traits::traits<Data> {
+        using base_traits = semester::json_int_traits::traits<Data>;
+
+        using bytes_type = std::vector<std::byte>;
+
+        using variant_type = std::variant<typename base_traits::null_type,
+                                          typename base_traits::string_type,
+                                          typename base_traits::int_type,
+                                          typename base_traits::uint_type,
+                                          typename base_traits::number_type,
+                                          typename base_traits::bool_type,
+                                          bytes_type,
+                                          typename base_traits::array_type,
+                                          typename base_traits::mapping_type>;
+    };
+};
+
+using json_bytes_data = semester::basic_data<json_bytes_traits>;
+
+}  // namespace
+
+TEST_CASE("Encode CBOR items") {
+    using semester::json_int_data;
+    using semester::to_cbor_string;
+    CHECK(to_cbor_string(json_int_data(0)) == bytes({0x00}));
+    CHECK(to_cbor_string(json_int_data(23)) == bytes({0x17}));
+    CHECK(to_cbor_string(json_int_data(24)) == bytes({0x18, 0x18}));
+    CHECK(to_cbor_string(json_int_data(1000)) == bytes({0x19, 0x03, 0xe8}));
+    CHECK(to_cbor_string(json_int_data(1000000)) == bytes({0x1a, 0x00, 0x0f, 0x42, 0x40}));
+    CHECK(to_cbor_string(json_int_data(18446744073709551615u))
+          == bytes({0x1b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}));
+    CHECK(to_cbor_string(json_int_data(-1)) == bytes({0x20}));
+    CHECK(to_cbor_string(json_int_data(-1000)) == bytes({0x39, 0x03, 0xe7}));
+    CHECK(to_cbor_string(json_int_data(1.5)) == bytes({0xfa, 0x3f, 0xc0, 0x00, 0x00}));
+    CHECK(to_cbor_string(json_int_data(1.1))
+          == bytes({0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a}));
+    CHECK(to_cbor_string(json_int_data(true)) == bytes({0xf5}));
+    CHECK(to_cbor_string(json_int_data(semester::null)) == bytes({0xf6}));
+    CHECK(to_cbor_string(json_int_data("IETF")) == bytes({0x64, 'I', 'E', 'T', 'F'}));
+
+    json_int_data arr = semester::empty_array;
+    arr.as_array()    = {1, 2, 3};
+    CHECK(to_cbor_string(arr) == bytes({0x83, 0x01, 0x02, 0x03}));
+    json_int_data map = semester::empty_mapping;
+    map.as_mapping()  = {{"a", 1}, {"b", semester::empty_array}};
+    CHECK(to_cbor_string(map) == bytes({0xa2, 0x61, 'a', 0x01, 0x61, 'b', 0x80}));
+}
+
+TEST_CASE("Round-trip JSON data through CBOR") {
+    auto doc = semester::parse_json<semester::json_int_data>(R"({
+        "id": 18446744073709551615,
+        "neg": -9223372036854775808,
+        "ratio": 0.1,
+        "name": "a string long enough that it will not fit in a small string buffer",
+        "list": [null, true, false, [], {}, 1e300],
+        "empty": ""
+    })");
+    const auto enc = semester::to_cbor_string(doc);
+    CHECK(enc.size() < semester::to_json_string(doc).size());
+    CHECK(semester::read_cbor<semester::json_int_data>(enc) == doc);
+
+    // Without integer alternatives, every number is decoded as a double
+    auto plain = semester::read_cbor(enc);
+    CHECK(plain.as_mapping().at("neg") == -9223372036854775808.0);
+    CHECK(plain.as_mapping().at("ratio") == 0.1);
+
+    // Flat mappings are sorted once when they are decoded
+    auto flat = semester::read_cbor<semester::json_flat_data>(enc);
+    CHECK(flat.as_mapping().begin()->first == "empty");
+    CHECK(flat.as_mapping().at("list").as_array().size() == 6);
+    auto dup = semester::read_cbor<semester::json_flat_data>(
+        bytes({0xa3, 0x61, 'b', 0x01, 0x61, 'a', 0x02, 0x61, 'b', 0x03}));
+    CHECK(dup.as_mapping() == semester::json_flat_data::mapping_type{{"a", 2}, {"b", 3}});
+}
+
+TEST_CASE("Decode CBOR items") {
+    using semester::json_int_data;
+    auto read = [](const std::string& b) { return semester::read_cbor<json_int_data>(b); };
+    // Half-precision floats
+    CHECK(read(bytes({0xf9, 0x3e, 0x00})) == 1.5);
+    CHECK(read(bytes({0xf9, 0x00, 0x01})) == 5.960464477539063e-8);
+    CHECK(read(bytes({0xf9, 0xc4, 0x00})) == -4.0);
+    // Negative integers beyond int64 become doubles
+    CHECK(read(bytes({0x3b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}))
+          == -18446744073709551616.0);
+    // Indefinite-length items
+    CHECK(read(bytes({0x9f, 0x01, 0x9f, 0xff, 0xff})) == read(bytes({0x82, 0x01, 0x80})));
+    CHECK(read(bytes({0x7f, 0x62, 's', 't', 0x63, 'r', 'e', 'a', 0xff})) == "strea");
+    CHECK(read(bytes({0xbf, 0x61, 'a', 0x01, 0xff})).as_mapping().at("a") == 1);
+    // Tags are skipped
+    CHECK(read(bytes({0xc1, 0x1a, 0x51, 0x4b, 0x67, 0xb0})) == 1363896240);
+    // Binary strings become strings when the data has no alternative for them
+    CHECK(read(bytes({0x43, 'a', 'b', 'c'})) == "abc");
+}
+
+TEST_CASE("Keep binary strings in CBOR") {
+    json_bytes_data dat = semester::empty_array;
+    dat.as_array().emplace_back(std::vector<std::byte>{std::byte{0}, std::byte{0xff}});
+    dat.as_array().emplace_back("text");
+    const auto enc = semester::to_cbor_string(dat);
+    CHECK(enc == bytes({0x82, 0x42, 0x00, 0xff, 0x64, 't', 'e', 'x', 't'}));
+    CHECK(semester::read_cbor<json_bytes_data>(enc) == dat);
+}
+
+TEST_CASE("Reject invalid CBOR") {
+    using semester::cbor_errc;
+    auto error = [](const std::string& b) {
+        return semester::try_read_cbor<semester::json_int_data>(b).error;
+    };
+    CHECK(error("") == cbor_errc::unexpected_end);
+    CHECK(error(bytes({0x19, 0x03})) == cbor_errc::unexpected_end);
+    CHECK(error(bytes({0x82, 0x01})) == cbor_errc::unexpected_end);
+    CHECK(error(bytes({0x7a, 0xff, 0xff, 0xff, 0xff})) == cbor_errc::unexpected_end);
+    CHECK(error(bytes({0x1c})) == cbor_errc::invalid_header);
+    CHECK(error(bytes({0x1f})) == cbor_errc::invalid_header);
+    CHECK(error(bytes({0xff})) == cbor_errc::invalid_header);
+    CHECK(error(bytes({0x7f, 0x41, 'a', 0xff})) == cbor_errc::invalid_header);
+    CHECK(error(bytes({0xf7})) == cbor_errc::unsupported_item);
+    CHECK(error(bytes({0xa1, 0x01, 0x02})) == cbor_errc::non_string_key);
+    CHECK(error(bytes({0x01, 0x02})) == cbor_errc::trailing_bytes);
+
+    const auto deep   = std::string(2000, static_cast<char>(0x81)) + bytes({0x01});
+    auto       result = semester::try_read_cbor<semester::json_int_data>(deep);
+    CHECK(result.error == cbor_errc::too_deep);
+    CHECK(result.offset == 1025);
+#if !SEMESTER_NO_EXCEPTIONS
+    CHECK_THROWS_AS(semester::read_cbor(bytes({0x82})), semester::cbor_error);
+#endif
+}
+
+TEST_CASE("Decode CBOR into an arena") {
+    std::pmr::monotonic_buffer_resource mr;
+    std::pmr::polymorphic_allocator<>   alloc{&mr};
+
+    semester::json_data doc = semester::parse_json(
+        R"({"name": "a string long enough to need a heap allocation", "list": [{}]})");
+    auto dat = semester::read_cbor<semester::json_pmr_data>(semester::to_cbor_string(doc), alloc);
+    CHECK(dat.get_allocator() == alloc);
+    auto& map = dat.as_mapping();
+    CHECK(map.get_allocator() == alloc);
+    CHECK(map.begin()->first.get_allocator() == alloc);
+    CHECK(map.at("name").as_string().get_allocator() == alloc);
+    CHECK(map.at("list").as_array().get_allocator() == alloc);
+    CHECK(map.at("list").as_array().front().as_mapping().get_allocator() == alloc);
+}
+
+TEST_CASE("Stream CBOR through sinks and sources") {
+    auto doc = semester::parse_json<semester::json_int_data>(R"([1, "two", {"three": 3.5}])");
+
+    std::string enc;
+    semester::write_cbor(doc, semester::string_sink{enc});
+    CHECK(enc == semester::to_cbor_string(doc));
+
+    auto result = semester::try_read_cbor<semester::json_int_data>(semester::string_source{enc});
+    REQUIRE(result);
+    CHECK(result.value == doc);
+
+    result = semester::try_read_cbor<semester::json_int_data>(
+        semester::string_source{std::string_view(enc).substr(0, 8)});
+    CHECK(result.error == semester::cbor_errc::unexpected_end);
+    CHECK(result.offset == 8);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdlib>
+#include <version>
+
+/**
+ * SEMESTER_NO_EXCEPTIONS selects the non-throwing mode of the library. It is
+ * detected from the compiler (e.g. `-fno-exceptions`), and may be defined to 1
+ * to select the mode even when exceptions are available.
+ *
+ * In the non-throwing mode, the operations that report errors by other means
+ * (try_walk(), checked_get(), try_parse_json(), etc.) behave as they always do.
+ * The operations that can only report an error by throwing (walk(), get(),
+ * parse_json(), etc.) call std::abort() instead.
+ */
+#if !defined(SEMESTER_NO_EXCEPTIONS)
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define SEMESTER_NO_EXCEPTIONS 0
+#else
+#define SEMESTER_NO_EXCEPTIONS 1
+#endif
+#endif
+
+#if SEMESTER_NO_EXCEPTIONS
+#define SEMESTER_THROW(...) ((void)(__VA_ARGS__), ::std::abort())
+#define SEMESTER_RETHROW ::std::abort()
+#define SEMESTER_TRY if (true)
+#define SEMESTER_CATCH_ALL if (false)
+#else
+#define SEMESTER_THROW(...) throw __VA_ARGS__
+#define SEMESTER_RETHROW throw
+#define SEMESTER_TRY try
+#define SEMESTER_CATCH_ALL catch (...)
+#endif
+
+/**
+ * SEMESTER_HAVE_FLOAT_CHARCONV is 1 if std::from_chars and std::to_chars can
+ * convert floating-point numbers. It is detected from the standard library,
+ * and may be defined to 0 to use the library's own locale-independent
+ * conversions instead (as is done for libstdc++ before GCC 11).
+ */
+#if !defined(SEMESTER_HAVE_FLOAT_CHARCONV)
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define SEMESTER_HAVE_FLOAT_CHARCONV 1
+#else
+#define SEMESTER_HAVE_FLOAT_CHARCONV 0
+#endif
+#endif
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <neo/declval.hpp>
+#include <neo/fwd.hpp>
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace semester {
+
+/**
+ * A reference-counted, copy-on-write box for a value. Copying a box shares the
+ * value, and a shared value is copied only when a mutable reference to it is
+ * requested with get_mut(). A box is never empty: if `T` is default-
+ * constructible, a box that has been moved from holds a default-constructed
+ * `T`, which is allocated only if the box is modified. Otherwise, a moved-from
+ * box shares the value of the box that it was moved to. Either way, moving a
+ * box does not allocate or throw.
+ *
+ * When a variant alternative of a data type is a cow_box<T>, the data presents
+ * the alternative as a `T`: try_get<T>(), visit() and the as_*() accessors see
+ * through the box (see detail::data_box). Reading through a data object never
+ * copies. Mutable access is given only by mutate<T>() and the as_mapping() and
+ * as_array() accessors, which copy the value first if it is shared. Because
+ * the children of a container are themselves boxed, a copy of a document is
+ * O(1), and modifying a copy only clones the containers along the path to the
+ * modified node.
+ *
+ * Boxes may be shared between threads. Readers never write to a shared value,
+ * and the reference count is atomic. A box that is found to be unique is
+ * synchronized with the release of every other reference to its value, so
+ * get_mut() may modify the value in place. As with any object, a single box
+ * must not be modified while another thread reads it.
+ */
+template <typename T>
+class cow_box {
+    /// Null only in a moved-from box of a default-constructible `T`
+    std::shared_ptr<T> _ptr;
+
+    constexpr static bool _nullable = std::is_default_constructible_v<T>;
+
+    static const T& _empty() noexcept {
+        static const T value{};
+        return value;
+    }
+
+    static std::shared_ptr<T> _take(cow_box& other) noexcept {
+        if constexpr (_nullable) {
+            return std::move(other._ptr);
+        } else {
+            return other._ptr;
+        }
+    }
+
+    bool _unique() const noexcept {
+        if (_ptr.use_count() != 1) {
+            return false;
+        }
+        // use_count() is a relaxed load. Pair it with the release performed by
+        // the other boxes when they dropped their references, so that their
+        // reads of the value happen before we modify it.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+
+public:
+    using value_type = T;
+
+    cow_box()
+        : _ptr(std::make_shared<T>()) {}
+
+    cow_box(const T& value)
+        : _ptr(std::make_shared<T>(value)) {}
+
+    cow_box(T&& value)
+        : _ptr(std::make_shared<T>(std::move(value))) {}
+
+    template <typename... Args>
+    explicit cow_box(std::in_place_t, Args&&... args)
+        : _ptr(std::make_shared<T>(NEO_FWD(args)...)) {}
+
+    cow_box(const cow_box&) = default;
+    cow_box& operator=(const cow_box&) = default;
+
+    cow_box(cow_box&& other) noexcept
+        : _ptr(_take(other)) {}
+
+    cow_box& operator=(cow_box&& other) noexcept {
+        _ptr = _take(other);
+        return *this;
+    }
+
+    /// Get the value for reading
+    const T& get() const noexcept {
+        if constexpr (_nullable) {
+            return _ptr ? *_ptr : _empty();
+        } else {
+            return *_ptr;
+        }
+    }
+
+    /// Get the value for modification, copying it first if it is shared
+    T& get_mut() {
+        if constexpr (_nullable) {
+            if (!_ptr) {
+                _ptr = std::make_shared<T>();
+                return *_ptr;
+            }
+        }
+        if (!_unique()) {
+            _ptr = std::make_shared<T>(std::as_const(*_ptr));
+        }
+        return *_ptr;
+    }
+
+    /// Check whether the value is shared with another box
+    bool is_shared() const noexcept { return _ptr && !_unique(); }
+
+    /// Boxes that share a value are equal without comparing the value
+    friend bool operator==(const cow_box& left, const cow_box& right) noexcept(
+        noexcept(NEO_DECLVAL(const T&) == NEO_DECLVAL(const T&))) {
+        return left._ptr == right._ptr || left.get() == right.get();
+    }
+};
+
+}  // namespace semester
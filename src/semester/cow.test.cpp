@@ -0,0 +1,163 @@
+#include <semester/cow.hpp>
+
+#include <semester/hash.hpp>
+#include <semester/json.hpp>
+#include <semester/json_parse.hpp>
+#include <semester/s_expr.hpp>
+#include <semester/s_expr_read.hpp>
+#include <semester/s_expr_write.hpp>
+#include <semester/walk.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+#include <vector>
+
+using semester::json_cow_data;
+
+namespace {
+
+template <typename T, typename Data>
+bool is_shared(const Data& dat) {
+    return std::get<semester::cow_box<T>>(dat.variant()).is_shared();
+}
+
+}  // namespace
+
+TEST_CASE("Box a value") {
+    semester::cow_box<std::vector<int>> box = std::vector<int>{1, 2, 3};
+    CHECK_FALSE(box.is_shared());
+
+    auto copy = box;
+    CHECK(box.is_shared());
+    CHECK(&copy.get() == &box.get());
+    CHECK(copy == box);
+
+    copy.get_mut().push_back(4);
+    CHECK_FALSE(box.is_shared());
+    CHECK(box.get().size() == 3);
+    CHECK(copy.get().size() == 4);
+    CHECK(copy != box);
+
+    // A moved-from box holds an empty value
+    auto moved = std::move(box);
+    CHECK(moved.get().size() == 3);
+    CHECK(box.get().empty());
+    CHECK_FALSE(box.is_shared());
+    CHECK(box != moved);
+    box.get_mut().push_back(9);
+    CHECK(box.get() == std::vector<int>{9});
+}
+
+TEST_CASE("Copy-on-write JSON data") {
+    json_cow_data doc = json_cow_data::mapping_type{
+        {"name", "widget"},
+        {"sizes", json_cow_data::array_type{1.0, 2.0, 3.0}},
+    };
+    CHECK(doc.is_mapping());
+    CHECK(doc.as_mapping().size() == 2);
+
+    // Copies share their containers
+    const json_cow_data copy = doc;
+    CHECK(is_shared<json_cow_data::mapping_type>(doc));
+    CHECK(&copy.as_mapping() == &std::as_const(doc).as_mapping());
+    CHECK(copy == doc);
+
+    // Reading through const data does not unshare
+    const auto& sizes = copy.as_mapping().find("sizes")->second;
+    CHECK(sizes.as_array().size() == 3);
+    CHECK(semester::try_get<json_cow_data::array_type>(sizes));
+    CHECK(is_shared<json_cow_data::mapping_type>(doc));
+
+    // Modifying the original clones only the path to the modified node
+    doc.as_mapping().find("sizes")->second.as_array().push_back(4.0);
+    CHECK(doc.as_mapping().find("sizes")->second.as_array().size() == 4);
+    CHECK(sizes.as_array().size() == 3);
+    CHECK(copy != doc);
+    CHECK(&doc.as_mapping().find("name")->second != &copy.as_mapping().find("name")->second);
+
+    // Modifying an unshared container does not copy it
+    auto* map = &doc.as_mapping();
+    doc.as_mapping()["new"] = true;
+    CHECK(map == &doc.as_mapping());
+    CHECK(doc.as_mapping().size() == 3);
+
+    json_cow_data arr = semester::empty_array;
+    arr.as_array().push_back("hello");
+    CHECK(arr.as_array()[0] == "hello");
+    CHECK(std::hash<json_cow_data>{}(arr) == std::hash<json_cow_data>{}(json_cow_data(arr)));
+}
+
+TEST_CASE("Use moved-from copy-on-write JSON data") {
+    json_cow_data a = json_cow_data::mapping_type{{"name", "widget"}};
+    json_cow_data b = std::move(a);
+    CHECK_FALSE(a == b);
+    CHECK(std::hash<json_cow_data>{}(a) == std::hash<json_cow_data>{}(a));
+    CHECK(a.as_mapping().empty());
+    CHECK(b.as_mapping().at("name") == "widget");
+}
+
+TEST_CASE("Parse and walk copy-on-write JSON data") {
+    auto doc = semester::parse_json<json_cow_data>(R"({"values": [1, 2, 3], "name": "cow"})");
+    CHECK(doc.as_mapping().find("values")->second.as_array().size() == 3);
+
+    using namespace semester::walk_ops;
+    std::vector<double> values;
+    std::string         name;
+    semester::walk(std::as_const(doc),
+                   mapping{
+                       if_key{"values"_key, for_each{put_into(std::back_inserter(values))}},
+                       if_key{"name"_key, put_into(name)},
+                   });
+    CHECK(values == std::vector<double>{1, 2, 3});
+    CHECK(name == "cow");
+}
+
+TEST_CASE("Share a copy-on-write document between threads") {
+    json_cow_data::array_type items;
+    for (int i = 0; i < 1000; ++i) {
+        items.push_back(json_cow_data::mapping_type{{"n", i}});
+    }
+    const json_cow_data doc = std::move(items);
+
+    std::vector<std::thread> threads;
+    std::vector<double>      sums(4);
+    for (std::size_t t = 0; t < sums.size(); ++t) {
+        threads.emplace_back([&, t] {
+            json_cow_data mine = doc;
+            for (const auto& item : std::as_const(mine).as_array()) {
+                sums[t] += item.as_mapping().find("n")->second.as_double();
+            }
+            mine.as_array().push_back(semester::null);
+        });
+    }
+    for (auto& thr : threads) {
+        thr.join();
+    }
+    for (double sum : sums) {
+        CHECK(sum == 999 * 1000 / 2);
+    }
+    CHECK(doc.as_array().size() == 1000);
+}
+
+TEST_CASE("Copy-on-write s-expression data") {
+    using pair_type = semester::s_expr_cow_data::traits_type::pair_type;
+
+    auto list = semester::read_s_expr<semester::s_expr_cow_data>("(a (b c) d)");
+    CHECK(semester::to_s_expr_string(list) == "(a (b c) d)");
+
+    auto copy = list;
+    CHECK(is_shared<pair_type>(list));
+    list.mutate<pair_type>().left() = "z";
+    CHECK(semester::to_s_expr_string(list) == "(z (b c) d)");
+    CHECK(semester::to_s_expr_string(copy) == "(a (b c) d)");
+    // The rest of the list is still shared
+    CHECK(&semester::get<pair_type>(std::as_const(list)).right()
+          != &semester::get<pair_type>(std::as_const(copy)).right());
+    CHECK(is_shared<pair_type>(semester::get<pair_type>(std::as_const(list)).right()));
+
+    // Pairs have no default value, so a moved-from box shares the moved value
+    auto moved = std::move(copy);
+    CHECK(copy == moved);
+    CHECK(semester::to_s_expr_string(copy) == "(a (b c) d)");
+}
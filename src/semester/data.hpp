@@ -1,5 +1,6 @@
 #pragma once
 
+#include <semester/config.hpp>
 #include <semester/get.hpp>
 
 #include <neo/concepts.hpp>
@@ -7,9 +8,14 @@
 #include <neo/fwd.hpp>
 
 #include <cinttypes>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace semester {
 
@@ -120,6 +126,16 @@ struct data_conv_mems_for<Derived, std::basic_string<char, Traits, Alloc>> {
     DECL_CONV_MEMS(string, string_type);
 };
 
+/**
+ * Convenience methods for std::basic_string_view for `char`
+ */
+template <typename Derived, typename Traits>
+struct data_conv_mems_for<Derived, std::basic_string_view<char, Traits>> {
+    using string_type = std::basic_string_view<char, Traits>;
+
+    DECL_CONV_MEMS(string, string_type);
+};
+
 /**
  * Convenience members for std::basic_string for `wchar_t`
  */
@@ -155,6 +171,307 @@ template <typename Traits, typename... Ts>
 struct data_conv_mems<data_impl<Traits>, std::variant<Ts...>>
     : data_conv_mems_for<data_impl<Traits>, Ts>... {};
 
+/// Matches if the traits specify an allocator for the data
+template <typename Traits>
+concept traits_has_allocator = requires {
+    typename Traits::allocator_type;
+};
+
+/// Matches if the traits specify an allocator that must be stored in each node
+template <typename Traits>
+concept traits_has_stateful_allocator = traits_has_allocator<Traits>  //
+    && !std::allocator_traits<typename Traits::allocator_type>::is_always_equal::value;
+
+/**
+ * Construct a copy of the given variant in which every alternative that uses
+ * an allocator has been given `alloc`. The nested data nodes within containers
+ * receive the allocator through uses-allocator construction.
+ */
+template <typename Variant, typename Alloc>
+std::remove_cvref_t<Variant> variant_with_allocator(const Alloc& alloc, Variant&& var) {
+    using variant_type = std::remove_cvref_t<Variant>;
+    return std::visit(
+        [&](auto&& alt) {
+            using alt_type = std::remove_cvref_t<decltype(alt)>;
+            return variant_type(std::in_place_type<alt_type>,
+                                std::make_obj_using_allocator<alt_type>(alloc, NEO_FWD(alt)));
+        },
+        NEO_FWD(var));
+}
+
+/**
+ * Select the alternative of a variant that would be initialized by a
+ * converting construction from `Arg`.
+ */
+template <typename... Ts>
+struct alternative_selector {
+    static void select();
+};
+
+template <typename T, typename... Ts>
+struct alternative_selector<T, Ts...> : alternative_selector<Ts...> {
+    using alternative_selector<Ts...>::select;
+    static std::type_identity<T> select(T);
+};
+
+template <typename Variant, typename Arg>
+struct selected_alternative;
+
+template <typename... Ts, typename Arg>
+struct selected_alternative<std::variant<Ts...>, Arg> {
+    using type = typename decltype(alternative_selector<Ts...>::select(NEO_DECLVAL(Arg)))::type;
+};
+
+// clang-format off
+/**
+ * Matches a variant alternative that holds its value indirectly, such as a
+ * cow_box. Data nodes present a boxed alternative as its `value_type`, which
+ * can be read through get(). It can be modified only through get_mut(), which
+ * may need to allocate unless the value is not shared.
+ */
+template <typename Box>
+concept data_box = requires(Box& box, const Box& cbox) {
+    typename Box::value_type;
+    { cbox.get() } noexcept -> std::same_as<const typename Box::value_type&>;
+    { box.get_mut() } -> std::same_as<typename Box::value_type&>;
+    { cbox.is_shared() } noexcept -> std::same_as<bool>;
+};
+
+/// Matches an lvalue reference to a data node of type Node, or a class derived from it
+template <typename Ref, typename Node>
+concept node_ref = std::is_lvalue_reference_v<Ref>
+    && std::derived_from<std::remove_cvref_t<Ref>, Node>;
+
+/// Matches an alternative that is a pair of child nodes, such as an s-expression pair
+template <typename T, typename Node>
+concept node_pair = requires(T& pair) {
+    { pair.left() } -> node_ref<Node>;
+    { pair.right() } -> node_ref<Node>;
+};
+
+/// Matches an alternative that is an ordered mapping of keys to child nodes
+template <typename T, typename Node>
+concept node_mapping = requires(T& map) {
+    typename T::key_compare;
+    { map.begin()->second } -> node_ref<Node>;
+    { map.size() } -> std::convertible_to<std::size_t>;
+};
+
+/// Matches an alternative that is a sequence of child nodes
+template <typename T, typename Node>
+concept node_array = !node_mapping<T, Node> && requires(T& arr) {
+    { *arr.begin() } -> node_ref<Node>;
+    { arr.size() } -> std::convertible_to<std::size_t>;
+};
+// clang-format on
+
+template <typename T, typename Alt>
+constexpr bool is_box_of = false;
+
+template <typename T, data_box Alt>
+constexpr bool is_box_of<T, Alt> = std::is_same_v<typename Alt::value_type, T>;
+
+/// Find the alternative of a variant that boxes a `T`. The type is `void` if there is none.
+template <typename T, typename... Alts>
+struct find_box {
+    using type = void;
+};
+
+template <typename T, typename Alt, typename... Alts>
+struct find_box<T, Alt, Alts...>
+    : std::conditional_t<is_box_of<T, Alt>, std::type_identity<Alt>, find_box<T, Alts...>> {};
+
+template <typename Variant, typename T>
+struct variant_box_for;
+
+template <typename... Ts, typename T>
+struct variant_box_for<std::variant<Ts...>, T> : find_box<T, Ts...> {};
+
+/// Check whether `T` is exactly one of the alternatives of a variant
+template <typename Variant, typename T>
+constexpr bool variant_has_alternative = false;
+
+template <typename... Ts, typename T>
+constexpr bool variant_has_alternative<std::variant<Ts...>, T>
+    = (static_cast<int>(std::is_same_v<Ts, T>) + ...) == 1;
+
+/// Get the value of a variant alternative for reading, looking through boxes
+template <typename Alt>
+constexpr const auto& unbox(const Alt& alt) noexcept {
+    if constexpr (data_box<Alt>) {
+        return alt.get();
+    } else {
+        return alt;
+    }
+}
+
+template <typename Alt>
+constexpr auto& unbox(Alt& alt) noexcept {
+    if constexpr (data_box<Alt>) {
+        return std::as_const(alt).get();
+    } else {
+        return alt;
+    }
+}
+
+/// Invokes a visitor with the unboxed value of a variant alternative
+template <typename Func>
+struct unboxing_visitor {
+    Func& fn;
+
+    template <typename Alt>
+    constexpr decltype(auto) operator()(Alt& alt) const noexcept(noexcept(fn(unbox(alt)))) {
+        return fn(unbox(alt));
+    }
+};
+
+/**
+ * Limits the depth to which data nodes recurse when they are copied, compared,
+ * or destroyed. Shallow data is handled recursively, which is fastest. Beyond
+ * `max_depth` levels, these operations switch to loops over an explicit stack
+ * on the heap, so deeply nested data cannot exhaust the call stack.
+ */
+class recursion_guard {
+    inline static thread_local int _depth = 0;
+
+    bool _counted = false;
+    bool _allowed = true;
+
+public:
+    constexpr static int max_depth = 64;
+
+    /// Enter a level of recursion, if `recursive` and the limit allows
+    explicit recursion_guard(bool recursive) noexcept {
+        if (recursive) {
+            _allowed = _depth < max_depth;
+            _counted = _allowed;
+            _depth += _counted;
+        }
+    }
+
+    recursion_guard(const recursion_guard&) = delete;
+    recursion_guard& operator=(const recursion_guard&) = delete;
+
+    ~recursion_guard() { _depth -= _counted; }
+
+    /// Whether the operation may recurse
+    bool allowed() const noexcept { return _allowed; }
+};
+
+/**
+ * Tag for constructing data storage with the allocator that a copy of another
+ * storage would use. The value is copied only if requested, and otherwise the
+ * new storage holds a default value.
+ */
+constexpr inline struct copy_allocator_t {
+} copy_allocator;
+
+/**
+ * Holds the variant of a data node. The primary template is used when the
+ * traits do not specify an allocator.
+ */
+template <typename Traits>
+class data_storage {
+protected:
+    typename Traits::variant_type _var;
+
+    constexpr data_storage() = default;
+
+    template <typename Var>
+    constexpr explicit data_storage(std::in_place_t, Var&& var)
+        : _var(NEO_FWD(var)) {}
+
+    constexpr data_storage(copy_allocator_t, const data_storage& other, bool copy_value)
+        : _var(copy_value ? typename Traits::variant_type(other._var)
+                          : typename Traits::variant_type()) {}
+};
+
+/**
+ * Storage for data with a stateless allocator. No allocator is stored.
+ */
+template <traits_has_allocator Traits>
+class data_storage<Traits> {
+public:
+    using allocator_type = typename Traits::allocator_type;
+
+    constexpr allocator_type get_allocator() const noexcept { return allocator_type(); }
+
+protected:
+    typename Traits::variant_type _var;
+
+    constexpr data_storage() = default;
+
+    template <typename Var>
+    constexpr explicit data_storage(std::in_place_t, Var&& var)
+        : _var(NEO_FWD(var)) {}
+
+    template <typename Var>
+    constexpr data_storage(std::in_place_t, const allocator_type&, Var&& var)
+        : _var(NEO_FWD(var)) {}
+
+    constexpr data_storage(copy_allocator_t, const data_storage& other, bool copy_value)
+        : _var(copy_value ? typename Traits::variant_type(other._var)
+                          : typename Traits::variant_type()) {}
+};
+
+/**
+ * Storage for data with a stateful allocator (e.g. a polymorphic_allocator).
+ * The allocator is kept in each node, and every value that is copied or
+ * assigned into the node is rebuilt with that allocator. As with the standard
+ * allocator-aware containers, a node keeps its allocator on assignment.
+ */
+template <traits_has_stateful_allocator Traits>
+class data_storage<Traits> {
+public:
+    using allocator_type = typename Traits::allocator_type;
+
+    allocator_type get_allocator() const noexcept { return _alloc; }
+
+protected:
+    using _alloc_traits = std::allocator_traits<allocator_type>;
+
+    allocator_type                _alloc;
+    typename Traits::variant_type _var;
+
+    data_storage() = default;
+
+    template <typename Var>
+    explicit data_storage(std::in_place_t, Var&& var)
+        : _var(NEO_FWD(var)) {}
+
+    template <typename Var>
+    data_storage(std::in_place_t, const allocator_type& alloc, Var&& var)
+        : _alloc(alloc)
+        , _var(NEO_FWD(var)) {}
+
+    data_storage(const data_storage& other)
+        : _alloc(_alloc_traits::select_on_container_copy_construction(other._alloc))
+        , _var(variant_with_allocator(_alloc, other._var)) {}
+
+    data_storage(copy_allocator_t, const data_storage& other, bool copy_value)
+        : _alloc(_alloc_traits::select_on_container_copy_construction(other._alloc))
+        , _var(copy_value ? variant_with_allocator(_alloc, other._var)
+                          : typename Traits::variant_type()) {}
+
+    data_storage(data_storage&&) noexcept = default;
+
+    data_storage& operator=(const data_storage& other) {
+        if (this != &other) {
+            _var = variant_with_allocator(_alloc, other._var);
+        }
+        return *this;
+    }
+
+    data_storage& operator=(data_storage&& other) {
+        if (_alloc == other._alloc) {
+            _var = std::move(other._var);
+        } else {
+            _var = variant_with_allocator(_alloc, std::move(other._var));
+        }
+        return *this;
+    }
+};
+
 /**
  * Generate mapping-access members
  */
@@ -183,12 +500,20 @@ struct data_mapping_part<Traits> : data_impl<Traits> {
         return semester::holds_alternative<mapping_type>(*this);
     }
 
-    constexpr mapping_type&       as_mapping() { return semester::get<mapping_type>(*this); }
+    constexpr mapping_type&       as_mapping() { return this->template mutate<mapping_type>(); }
     constexpr const mapping_type& as_mapping() const { return semester::get<mapping_type>(*this); }
 
     // A constructor for an empty mapping type
     constexpr data_mapping_part(empty_mapping_t)
         : data_mapping_part::data_impl(mapping_type()) {}
+
+    // An allocator-extended constructor for an empty mapping type
+    template <typename Alloc>
+    requires traits_has_allocator<Traits>
+    data_mapping_part(std::allocator_arg_t, const Alloc& alloc, empty_mapping_t)
+        : data_mapping_part::data_impl(std::allocator_arg,
+                                       alloc,
+                                       std::make_obj_using_allocator<mapping_type>(alloc)) {}
 };
 
 /**
@@ -218,12 +543,20 @@ struct data_array_part<Traits> : data_mapping_part<Traits> {
         return semester::holds_alternative<array_type>(*this);
     }
 
-    constexpr array_type&       as_array() { return semester::get<array_type>(*this); }
+    constexpr array_type&       as_array() { return this->template mutate<array_type>(); }
     constexpr const array_type& as_array() const { return semester::get<array_type>(*this); }
 
     // A constructor for an empty array type
     constexpr data_array_part(empty_array_t)
         : data_array_part::data_mapping_part(array_type()) {}
+
+    // An allocator-extended constructor for an empty array type
+    template <typename Alloc>
+    requires traits_has_allocator<Traits>
+    data_array_part(std::allocator_arg_t, const Alloc& alloc, empty_array_t)
+        : data_array_part::data_mapping_part(std::allocator_arg,
+                                             alloc,
+                                             std::make_obj_using_allocator<array_type>(alloc)) {}
 };
 
 /**
@@ -251,7 +584,8 @@ concept traits_has_nothrow_convert = requires(T&& value) {
  * `try_get()`
  */
 template <typename Traits>
-class data_impl : public data_conv_mems<data_impl<Traits>, typename Traits::variant_type> {
+class data_impl : public data_storage<Traits>,
+                  public data_conv_mems<data_impl<Traits>, typename Traits::variant_type> {
 public:
     /// The variant type that can store this class
     using variant_type = typename Traits::variant_type;
@@ -259,8 +593,8 @@ public:
     using traits_type = Traits;
 
 private:
-    /// The actual variant holding our data
-    variant_type _var;
+    using storage = data_storage<Traits>;
+    using storage::_var;
 
     // Check that 'T' can convert to this data type
     template <typename T>
@@ -274,8 +608,29 @@ private:
         std::is_nothrow_constructible_v<variant_type, T> ||  //
         traits_has_nothrow_convert<traits_type, T>;
 
+    /// The alternative that boxes a T, or void if T is not boxed
+    template <typename T>
+    using _box_for = typename variant_box_for<variant_type, T>::type;
+
     template <typename T>
-    requires _convert_check<T> constexpr decltype(auto)
+    constexpr static bool _is_boxed = !std::is_void_v<_box_for<T>>;
+
+    template <typename T>
+    constexpr static bool _check_supports() noexcept {
+        if constexpr (_is_boxed<T>) {
+            // Do not ask the variant: it would reject T as an unknown alternative
+            return true;
+        } else if constexpr (!variant_has_alternative<variant_type, T>) {
+            // Also do not ask: std::get_if() fails to compile for a T that is
+            // not an alternative, even if T converts to one
+            return false;
+        } else {
+            return supports_alternative<variant_type, T>;
+        }
+    }
+
+    template <typename T>
+    requires _convert_check<T> constexpr static decltype(auto)
     _convert(T&& value) noexcept(_convert_noexcept<T>) {
         if constexpr (traits_has_convert<traits_type, T>) {
             return traits_type::convert(NEO_FWD(value));
@@ -284,29 +639,556 @@ private:
         }
     }
 
+    /**
+     * Create a variant holding the conversion of `arg`, using `alloc` for the
+     * selected alternative.
+     */
+    template <typename Alloc, typename Arg>
+    static variant_type _make_variant(const Alloc& alloc, Arg&& arg) {
+        using converted = decltype(_convert(NEO_FWD(arg)));
+        using alt_type  = typename selected_alternative<variant_type, converted>::type;
+        if constexpr (std::is_constructible_v<alt_type, Arg, const Alloc&>) {
+            // Skip the intermediate conversion and construct with the allocator directly
+            return variant_type(std::in_place_type<alt_type>,
+                                std::make_obj_using_allocator<alt_type>(alloc, NEO_FWD(arg)));
+        } else {
+            return variant_type(std::in_place_type<alt_type>,
+                                std::make_obj_using_allocator<alt_type>(alloc,
+                                                                        _convert(NEO_FWD(arg))));
+        }
+    }
+
+    /// Call `fn` with each child node of the given alternative, if it has any
+    template <typename Alt, typename Func>
+    static void _for_each_child(Alt& alt, Func&& fn) {
+        using alt_type = std::remove_const_t<Alt>;
+        if constexpr (node_pair<alt_type, data_impl>) {
+            if constexpr (requires { alt.empty(); }) {
+                if (alt.empty()) {
+                    return;
+                }
+            }
+            fn(alt.left());
+            fn(alt.right());
+        } else if constexpr (node_mapping<alt_type, data_impl>) {
+            for (auto& [key, child] : alt) {
+                fn(child);
+            }
+        } else if constexpr (node_array<alt_type, data_impl>) {
+            for (auto& child : alt) {
+                fn(child);
+            }
+        }
+    }
+
+    template <typename Alt>
+    constexpr static bool _is_parent_type = data_box<Alt> || node_pair<Alt, data_impl>
+        || node_mapping<Alt, data_impl> || node_array<Alt, data_impl>;
+
+    /// Check whether the alternative with the given index is of a type that can have children
+    static bool _may_have_children(std::size_t index) noexcept {
+        constexpr auto size = std::variant_size_v<variant_type>;
+        return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            static constexpr bool is_parent[]
+                = {_is_parent_type<std::variant_alternative_t<Is, variant_type>>...};
+            return index < size && is_parent[index];
+        }
+        (std::make_index_sequence<size>());
+    }
+
+    /**
+     * Check whether a node has children. A shared box is treated as a leaf,
+     * since copying or destroying it does not touch its value.
+     */
+    static bool _has_children(const data_impl& node) noexcept {
+        if (!_may_have_children(node._var.index())) {
+            // Checked first, so that leaves are not visited
+            return false;
+        }
+        return std::visit(
+            [](const auto& alt) {
+                using alt_type = std::remove_cvref_t<decltype(alt)>;
+                if constexpr (data_box<alt_type>) {
+                    return !alt.is_shared() && _alt_has_children(alt.get());
+                } else {
+                    return _alt_has_children(alt);
+                }
+            },
+            node._var);
+    }
+
+    template <typename Alt>
+    static bool _alt_has_children(const Alt& alt) noexcept {
+        if constexpr (node_pair<Alt, data_impl>) {
+            if constexpr (requires { alt.empty(); }) {
+                return !alt.empty();
+            }
+            return true;
+        } else if constexpr (node_mapping<Alt, data_impl> || node_array<Alt, data_impl>) {
+            return alt.size() != 0;
+        } else {
+            return false;
+        }
+    }
+
+    /// Check whether any child in the given alternative has children of its own
+    template <typename Alt>
+    static bool _any_child_has_children(Alt& alt) noexcept {
+        bool found = false;
+        _for_each_child(alt, [&](const data_impl& child) {
+            found = found || _has_children(child);
+        });
+        return found;
+    }
+
+    /// Check whether any child of this node has children of its own
+    bool _has_grandchildren() noexcept {
+        return std::visit(
+            [](auto& alt) {
+                using alt_type = std::remove_cvref_t<decltype(alt)>;
+                if constexpr (data_box<alt_type>) {
+                    // The children of a shared box are not destroyed with this node
+                    return !alt.is_shared() && _any_child_has_children(alt.get());
+                } else {
+                    return _any_child_has_children(alt);
+                }
+            },
+            _var);
+    }
+
+    /// Destroy the children of this node, recursing only as deep as the recursion_guard allows
+    void _destroy_nested() noexcept {
+        const recursion_guard guard(true);
+        if (!guard.allowed()) {
+            if (_has_grandchildren()) {
+                _destroy_descendants();
+            }
+        } else if (_has_children(*this)) {
+            // Destroy the children within the guard
+            _var.template emplace<0>();
+        }
+    }
+
+    /**
+     * Destroy the descendants of this node without recursion. Every descendant
+     * that has children gives up its value to a stack on the heap, so that the
+     * destructor of no node has more than one level of children to destroy.
+     */
+    void _destroy_descendants() noexcept {
+        std::vector<variant_type> stack;
+        const auto take_children = [&](variant_type& var) {
+            std::visit(
+                [&](auto& alt) {
+                    using alt_type = std::remove_cvref_t<decltype(alt)>;
+                    const auto take = [&](data_impl& child) {
+                        if (_has_children(child)) {
+                            stack.push_back(std::move(child._var));
+                            // A moved-from box may still share its value, so release it
+                            child._var.template emplace<0>();
+                        }
+                    };
+                    if constexpr (data_box<alt_type>) {
+                        if (!alt.is_shared()) {
+                            // Not shared, so this will not copy
+                            _for_each_child(alt.get_mut(), take);
+                        }
+                    } else {
+                        _for_each_child(alt, take);
+                    }
+                },
+                var);
+        };
+        SEMESTER_TRY {
+            take_children(_var);
+            while (!stack.empty()) {
+                variant_type var = std::move(stack.back());
+                stack.pop_back();
+                take_children(var);
+            }
+        } SEMESTER_CATCH_ALL {
+            // The stack could not grow. The remaining nodes are destroyed recursively.
+        }
+    }
+
+    using _node_pairs = std::vector<std::pair<data_impl*, const data_impl*>>;
+
+    /**
+     * Copy the value of `src` into this node. A container whose children have
+     * no children of their own is copied whole. Otherwise, see
+     * _copy_container_shallow().
+     */
+    void _copy_shallow(const data_impl& src, _node_pairs& stack) {
+        std::visit(
+            [&](const auto& alt) {
+                using alt_type = std::remove_cvref_t<decltype(alt)>;
+                if constexpr (node_pair<alt_type, data_impl>) {
+                    using child_type = std::remove_cvref_t<decltype(alt.left())>;
+                    const bool deep_left  = _has_children(alt.left());
+                    const bool deep_right = _has_children(alt.right());
+                    // Copy the children that are leaves into the new pair directly
+                    const auto make_pair = [&](const auto& left, const auto& right) -> auto& {
+                        return this->template emplace<alt_type>(left, right);
+                    };
+                    auto& pair = deep_left
+                        ? (deep_right ? make_pair(child_type(), child_type())
+                                      : make_pair(child_type(), alt.right()))
+                        : (deep_right ? make_pair(alt.left(), child_type())
+                                      : make_pair(alt.left(), alt.right()));
+                    if (deep_left) {
+                        stack.emplace_back(&pair.left(), &alt.left());
+                    }
+                    if (deep_right) {
+                        stack.emplace_back(&pair.right(), &alt.right());
+                    }
+                } else if constexpr (node_mapping<alt_type, data_impl>
+                                     || node_array<alt_type, data_impl>) {
+                    if (_any_child_has_children(alt)) {
+                        _copy_container_shallow(alt, stack);
+                    } else {
+                        // Copying the container recurses only one level
+                        this->template emplace<alt_type>(alt);
+                    }
+                } else {
+                    // A leaf, or a box, which copies in constant time
+                    this->template emplace<alt_type>(alt);
+                }
+            },
+            src._var);
+    }
+
+    /**
+     * Copy a container into this node. Children that have no children of their
+     * own are copied along with it. The others are inserted with a default
+     * value, and pushed onto `stack` to be copied later. The container is
+     * reserved first where possible, so that the pushed references remain
+     * valid while the rest of the children are inserted.
+     */
+    template <typename Container>
+    void _copy_container_shallow(const Container& src, _node_pairs& stack) {
+        auto& dst = this->template emplace<Container>();
+        if constexpr (requires { dst.reserve(src.size()); }) {
+            dst.reserve(src.size());
+        }
+        if constexpr (node_mapping<Container, data_impl>) {
+            for (const auto& [key, child] : src) {
+                const bool deep = _has_children(child);
+                if constexpr (requires { dst.emplace_hint(dst.end(), key, child); }) {
+                    auto it = deep ? dst.emplace_hint(dst.end(),
+                                                      std::piecewise_construct,
+                                                      std::forward_as_tuple(key),
+                                                      std::forward_as_tuple())
+                                   : dst.emplace_hint(dst.end(), key, child);
+                    if (deep) {
+                        stack.emplace_back(&it->second, &child);
+                    }
+                } else if (deep) {
+                    stack.emplace_back(&dst.try_emplace(key).first->second, &child);
+                } else {
+                    dst.try_emplace(key, child);
+                }
+            }
+        } else {
+            for (const auto& child : src) {
+                if (_has_children(child)) {
+                    stack.emplace_back(&dst.emplace_back(), &child);
+                } else {
+                    dst.emplace_back(child);
+                }
+            }
+        }
+    }
+
+    /// Copy `src` into this node, which holds a default value, without recursion
+    void _copy_from(const data_impl& src) {
+        _node_pairs      stack;
+        data_impl*       dst  = this;
+        const data_impl* from = &src;
+        while (true) {
+            dst->_copy_shallow(*from, stack);
+            if (stack.empty()) {
+                return;
+            }
+            std::tie(dst, from) = stack.back();
+            stack.pop_back();
+        }
+    }
+
+    using _const_node_pairs = std::vector<std::pair<const data_impl*, const data_impl*>>;
+
+    /**
+     * Compare two alternatives of the same type. The children that have
+     * children of their own are pushed onto `stack` to be compared later.
+     */
+    template <typename Alt>
+    static bool _equal_shallow(const Alt& left, const Alt& right, _const_node_pairs& stack) {
+        const auto compare_child = [&](const data_impl& a, const data_impl& b) {
+            if (_has_children(a) || _has_children(b)) {
+                stack.emplace_back(&a, &b);
+                return true;
+            }
+            return a._var == b._var;
+        };
+        if constexpr (data_box<Alt>) {
+            return &left.get() == &right.get() || _equal_shallow(left.get(), right.get(), stack);
+        } else if constexpr (node_pair<Alt, data_impl>) {
+            return compare_child(left.left(), right.left())
+                && compare_child(left.right(), right.right());
+        } else if constexpr (node_mapping<Alt, data_impl>) {
+            if (left.size() != right.size()) {
+                return false;
+            }
+            auto other = right.begin();
+            for (const auto& [key, child] : left) {
+                if (!(key == other->first) || !compare_child(child, other->second)) {
+                    return false;
+                }
+                ++other;
+            }
+            return true;
+        } else if constexpr (node_array<Alt, data_impl>) {
+            if (left.size() != right.size()) {
+                return false;
+            }
+            auto other = right.begin();
+            for (const auto& child : left) {
+                if (!compare_child(child, *other)) {
+                    return false;
+                }
+                ++other;
+            }
+            return true;
+        } else {
+            return left == right;
+        }
+    }
+
+    /// Compare with `rhs`, recursing only as deep as the recursion_guard allows
+    bool _equal_nested(const data_impl& rhs) const {
+        const recursion_guard guard(true);
+        if (guard.allowed()) {
+            return _var == rhs._var;
+        }
+        _const_node_pairs stack;
+        const data_impl*  left  = this;
+        const data_impl*  right = &rhs;
+        while (true) {
+            if (left->_var.index() != right->_var.index()) {
+                return false;
+            }
+            const bool equal = std::visit(
+                [&](const auto& alt) {
+                    using alt_type = std::remove_cvref_t<decltype(alt)>;
+                    return _equal_shallow(alt, *std::get_if<alt_type>(&right->_var), stack);
+                },
+                left->_var);
+            if (!equal) {
+                return false;
+            }
+            if (stack.empty()) {
+                return true;
+            }
+            std::tie(left, right) = stack.back();
+            stack.pop_back();
+        }
+    }
+
+    data_impl(const data_impl& other, recursion_guard&& guard)
+        : storage(copy_allocator, other, guard.allowed()) {
+        if (!guard.allowed()) {
+            _copy_from(other);
+        }
+    }
+
+    template <typename Alloc>
+    data_impl(std::allocator_arg_t,
+              const Alloc&      alloc,
+              const data_impl&  other,
+              recursion_guard&& guard)
+        : storage(std::in_place,
+                  alloc,
+                  guard.allowed() ? variant_with_allocator(alloc, other._var) : variant_type()) {
+        if (!guard.allowed()) {
+            _copy_from(other);
+        }
+    }
+
+    template <typename Alloc>
+    data_impl(std::allocator_arg_t,
+              const Alloc&      alloc,
+              data_impl&&       other,
+              recursion_guard&& guard)
+        : storage(std::in_place,
+                  alloc,
+                  guard.allowed() || _moves_in_place(alloc, other)
+                      ? variant_with_allocator(alloc, std::move(other._var))
+                      : variant_type()) {
+        if (!guard.allowed() && !_moves_in_place(alloc, other)) {
+            _copy_from(other);
+        }
+    }
+
+    /// Whether moving `other` into a node using `alloc` keeps its children where they are
+    template <typename Alloc>
+    static bool _moves_in_place(const Alloc& alloc, const data_impl& other) noexcept {
+        if constexpr (traits_has_stateful_allocator<Traits>) {
+            return other.get_allocator() == alloc;
+        } else {
+            return true;
+        }
+    }
+
 public:
     constexpr data_impl() = default;
 
+    /**
+     * Copying, comparison, and destruction recurse to a limited depth, beyond
+     * which they use a work stack on the heap (see recursion_guard).
+     */
+    data_impl(const data_impl& other)
+        : data_impl(other, recursion_guard(_may_have_children(other._var.index()))) {}
+
+    data_impl(data_impl&&) = default;
+
+    data_impl& operator=(const data_impl& other) {
+        if (this != &other) {
+            if constexpr (traits_has_stateful_allocator<Traits>) {
+                // As with the allocator-aware containers, we keep our own allocator
+                data_impl tmp(std::allocator_arg, this->get_allocator(), other);
+                _var = std::move(tmp._var);
+            } else {
+                data_impl tmp(other);
+                _var = std::move(tmp._var);
+            }
+        }
+        return *this;
+    }
+
+    data_impl& operator=(data_impl&& other) {
+        if constexpr (traits_has_stateful_allocator<Traits>) {
+            if (!_moves_in_place(this->get_allocator(), other)) {
+                // The value must be rebuilt with our allocator, as in copy-assignment
+                data_impl tmp(std::allocator_arg, this->get_allocator(), std::move(other));
+                _var = std::move(tmp._var);
+                return *this;
+            }
+        }
+        _var = std::move(other._var);
+        return *this;
+    }
+
+    ~data_impl() {
+        if (_may_have_children(_var.index())) {
+            _destroy_nested();
+        }
+    }
+
     /**
      * Support implicit conversions from supported types
      */
     template <typename Arg>
     requires _convert_check<Arg>  //
         constexpr data_impl(Arg&& arg) noexcept(noexcept(variant_type(_convert(arg))))
-        : _var(_convert(NEO_FWD(arg))) {}
+        : storage(std::in_place, _convert(NEO_FWD(arg))) {}
+
+    /**
+     * Allocator-extended constructors. These allow data nodes to be created with
+     * uses-allocator construction by allocator-aware containers.
+     */
+    template <typename Alloc>
+    requires traits_has_allocator<Traits>
+    data_impl(std::allocator_arg_t, const Alloc& alloc)
+        : storage(std::in_place, alloc, variant_with_allocator(alloc, variant_type())) {}
+
+    template <typename Alloc, typename Arg>
+    requires traits_has_allocator<Traits> && _convert_check<Arg>
+    data_impl(std::allocator_arg_t, const Alloc& alloc, Arg&& arg)
+        : storage(std::in_place, alloc, _make_variant(alloc, NEO_FWD(arg))) {}
+
+    template <typename Alloc>
+    requires traits_has_allocator<Traits>
+    data_impl(std::allocator_arg_t, const Alloc& alloc, const data_impl& other)
+        : data_impl(std::allocator_arg,
+                    alloc,
+                    other,
+                    recursion_guard(_may_have_children(other._var.index()))) {}
+
+    template <typename Alloc>
+    requires traits_has_allocator<Traits>
+    data_impl(std::allocator_arg_t, const Alloc& alloc, data_impl&& other)
+        : data_impl(std::allocator_arg,
+                    alloc,
+                    std::move(other),
+                    recursion_guard(_may_have_children(other._var.index()))) {}
+
+    /**
+     * Assign a new value from any supported type. If the data has a stateful
+     * allocator, the new value will use that allocator.
+     */
+    template <typename Arg>
+    requires _convert_check<Arg>  //
+        constexpr void assign(Arg&& arg) {
+        if constexpr (traits_has_stateful_allocator<Traits>) {
+            _var = _make_variant(this->get_allocator(), NEO_FWD(arg));
+        } else {
+            _var = _convert(NEO_FWD(arg));
+        }
+    }
+
+    /**
+     * Replace the value with a `T` constructed from the given arguments. If
+     * the data has an allocator, the new value is constructed with it.
+     */
+    template <typename T, typename... Args>
+    constexpr T& emplace(Args&&... args) {
+        if constexpr (_is_boxed<T>) {
+            return _var.template emplace<_box_for<T>>(std::in_place, NEO_FWD(args)...).get_mut();
+        } else if constexpr (traits_has_stateful_allocator<Traits>) {
+            return _var.template emplace<T>(
+                std::make_obj_using_allocator<T>(this->get_allocator(), NEO_FWD(args)...));
+        } else {
+            return _var.template emplace<T>(NEO_FWD(args)...);
+        }
+    }
 
     /// Check if the data supports a certain type T
     template <typename T>
-    constexpr static bool supports = supports_alternative<variant_type, T>;
+    constexpr static bool supports = _check_supports<T>();
 
+    /**
+     * Get a pointer to the held T, or null if the data does not hold a T. If T
+     * is held in a box, the pointer is to const: use mutate() to modify it.
+     */
     template <typename T>
-    requires supports<T> constexpr T* try_get() noexcept {
-        return semester::try_get<T>(_var);
+    requires supports<T> constexpr auto try_get() noexcept {
+        if constexpr (_is_boxed<T>) {
+            return std::as_const(*this).template try_get<T>();
+        } else {
+            return semester::try_get<T>(_var);
+        }
     }
 
     template <typename T>
     requires supports<T> constexpr const T* try_get() const noexcept {
-        return semester::try_get<T>(_var);
+        if constexpr (_is_boxed<T>) {
+            const auto box = std::get_if<_box_for<T>>(&_var);
+            return box ? &box->get() : nullptr;
+        } else {
+            return semester::try_get<T>(_var);
+        }
+    }
+
+    /**
+     * Get a mutable reference to the held T. If T is held in a box whose value
+     * is shared, the value is copied first. Throws std::bad_variant_access if
+     * the data does not hold a T.
+     */
+    template <typename T>
+    requires supports<T> constexpr T& mutate() {
+        if constexpr (_is_boxed<T>) {
+            return std::get<_box_for<T>>(_var).get_mut();
+        } else {
+            return semester::get<T>(*this);
+        }
     }
 
     /// Get a reference to the underlying variant
@@ -314,17 +1196,21 @@ public:
     constexpr variant_type&&      variant() && noexcept { return std::move(_var); }
     constexpr const variant_type& variant() const& noexcept { return _var; }
 
-    /// Execute a visitor against the data
+    /**
+     * Execute a visitor against the data. Boxed alternatives are given to the
+     * visitor as a const reference to their value.
+     */
     template <typename Func>
-    constexpr decltype(auto) visit(Func&& fn) noexcept(noexcept(std::visit(NEO_FWD(fn), _var))) {
-        return std::visit(NEO_FWD(fn), _var);
+    constexpr decltype(auto) visit(Func&& fn) noexcept(
+        noexcept(std::visit(unboxing_visitor<Func>{fn}, _var))) {
+        return std::visit(unboxing_visitor<Func>{fn}, _var);
     }
 
     /// Execute a visitor agains the data
     template <typename Func>
     constexpr decltype(auto) visit(Func&& fn) const
-        noexcept(noexcept(std::visit(NEO_FWD(fn), _var))) {
-        return std::visit(NEO_FWD(fn), _var);
+        noexcept(noexcept(std::visit(unboxing_visitor<Func>{fn}, _var))) {
+        return std::visit(unboxing_visitor<Func>{fn}, _var);
     }
 
     template <typename T>
@@ -334,9 +1220,11 @@ public:
         return ptr && (*ptr == rhs);
     }
 
-    constexpr bool operator==(const data_impl& rhs) const
-        noexcept(noexcept(NEO_DECLVAL(const variant_type&) == NEO_DECLVAL(const variant_type&))) {
-        return variant() == rhs.variant();
+    bool operator==(const data_impl& rhs) const {
+        if (!_may_have_children(_var.index())) {
+            return _var == rhs._var;
+        }
+        return _equal_nested(rhs);
     }
 };
 
@@ -353,6 +1241,18 @@ class basic_data : public detail::basic_data_base<
                        typename TraitsTemplate::template traits<basic_data<TraitsTemplate>>> {
 public:
     using basic_data::basic_data_base::basic_data_base;
+
+    // clang-format off
+    /**
+     * Assign from any supported type. See data_impl::assign()
+     */
+    template <typename Arg>
+        requires requires(basic_data& dat, Arg&& arg) { dat.assign(NEO_FWD(arg)); }
+    constexpr basic_data& operator=(Arg&& arg) {
+        // clang-format on
+        this->assign(NEO_FWD(arg));
+        return *this;
+    }
 };
 
 }  // namespace semester
@@ -1,6 +1,8 @@
 #include <semester/data.hpp>
 
 #include <semester/get.hpp>
+#include <semester/json.hpp>
+#include <semester/s_expr.hpp>
 
 #include <catch2/catch.hpp>
 
@@ -46,3 +48,68 @@ TEST_CASE("Create basic data") {
     CHECK_FALSE(dat == 44);
     CHECK(dat != 44);
 }
+
+TEST_CASE("Copy, compare, and destroy very deep data") {
+    using data = semester::basic_data<int_tree_traits>;
+    // Deep enough that recursing once per level would overflow the stack
+    data  deep = data::array_type{};
+    data* cur  = &deep;
+    for (int i = 0; i < 500000; ++i) {
+        cur = &cur->as_array().emplace_back(data::array_type{});
+    }
+    cur->as_array().emplace_back(42);
+
+    data copy = deep;
+    CHECK(copy == deep);
+    cur->as_array().front() = 7;
+    CHECK_FALSE(copy == deep);
+
+    data assigned = 1;
+    assigned      = copy;
+    CHECK(assigned == copy);
+}
+
+TEST_CASE("Move very deep data between memory resources") {
+    using data = semester::json_pmr_data;
+    std::pmr::monotonic_buffer_resource mr;
+    data  deep{std::allocator_arg, &mr, semester::empty_array};
+    data* cur = &deep;
+    for (int i = 0; i < 500000; ++i) {
+        cur = &cur->as_array().emplace_back(semester::empty_array);
+    }
+    cur->as_array().emplace_back("a string long enough to need a heap allocation");
+    const data expect = deep;
+
+    // Moving into another resource must rebuild every node with that resource
+    std::pmr::monotonic_buffer_resource other_mr;
+    data moved{std::allocator_arg, &other_mr, std::move(deep)};
+    CHECK(moved == expect);
+    CHECK(moved.get_allocator().resource() == &other_mr);
+
+    data assigned{std::allocator_arg, &mr, 1};
+    assigned = std::move(moved);
+    CHECK(assigned == expect);
+    CHECK(assigned.get_allocator().resource() == &mr);
+}
+
+TEST_CASE("Destroy very deep copy-on-write data") {
+    using json = semester::json_cow_data;
+    json  deep = json::array_type{};
+    json* cur  = &deep;
+    for (int i = 0; i < 500000; ++i) {
+        cur = &cur->as_array().emplace_back(json::array_type{});
+    }
+    {
+        // Destroying a copy leaves the shared value alone
+        auto copy = deep;
+        CHECK(copy == deep);
+    }
+    deep = semester::null;
+
+    using pair_type = semester::s_expr_cow_data::traits_type::pair_type;
+    semester::s_expr_cow_data list = semester::null;
+    for (int i = 0; i < 1000000; ++i) {
+        list = pair_type("x", std::move(list));
+    }
+    list = semester::null;
+}
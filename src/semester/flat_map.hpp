@@ -0,0 +1,312 @@
+#pragma once
+
+#include <semester/config.hpp>
+
+#include <neo/fwd.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace semester {
+
+/**
+ * Which element is kept when a flat_map is constructed in bulk from elements
+ * that have duplicate keys.
+ */
+enum class flat_map_duplicates {
+    /// Keep the first element with the key, as insertion would
+    keep_first,
+    /// Keep the last element with the key, as assignment would
+    keep_last,
+};
+
+/**
+ * An associative container that keeps its elements in a contiguous vector
+ * sorted by key. Lookup is a binary search, and iteration is a linear walk
+ * over memory, in key order. Insertion and removal are linear in the size of
+ * the map, so this suits small mappings that are built once and read often.
+ * To build a large map, construct it from a container of its elements, which
+ * sorts them once.
+ *
+ * Lookup is heterogeneous when the comparator is transparent (the default), so
+ * a flat_map with string keys can be searched with a std::string_view.
+ *
+ * Keys must not be modified through an iterator.
+ */
+template <typename Key,
+          typename Value,
+          typename Compare   = std::less<>,
+          typename Allocator = std::allocator<std::pair<Key, Value>>>
+class flat_map {
+public:
+    using key_type               = Key;
+    using mapped_type            = Value;
+    using value_type             = std::pair<Key, Value>;
+    using key_compare            = Compare;
+    using allocator_type         = typename std::allocator_traits<
+        Allocator>::template rebind_alloc<value_type>;
+    using container_type         = std::vector<value_type, allocator_type>;
+    using size_type              = typename container_type::size_type;
+    using difference_type        = typename container_type::difference_type;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using iterator               = typename container_type::iterator;
+    using const_iterator         = typename container_type::const_iterator;
+    using reverse_iterator       = typename container_type::reverse_iterator;
+    using const_reverse_iterator = typename container_type::const_reverse_iterator;
+
+private:
+    container_type                    _items;
+    [[no_unique_address]] key_compare _compare;
+
+    template <typename K>
+    bool _less(const value_type& item, const K& key) const {
+        return _compare(item.first, key);
+    }
+
+    template <typename K>
+    iterator _lower_bound(const K& key) {
+        return std::lower_bound(_items.begin(),
+                                _items.end(),
+                                key,
+                                [&](const value_type& item, const K& k) { return _less(item, k); });
+    }
+
+    template <typename K>
+    const_iterator _lower_bound(const K& key) const {
+        return std::lower_bound(_items.begin(),
+                                _items.end(),
+                                key,
+                                [&](const value_type& item, const K& k) { return _less(item, k); });
+    }
+
+    template <typename K>
+    bool _matches(const_iterator it, const K& key) const {
+        return it != _items.end() && !_compare(key, it->first);
+    }
+
+    /**
+     * Find the position for `key`. Keys are often inserted in order, so check
+     * the end of the map before searching.
+     */
+    template <typename K>
+    iterator _insert_position(const K& key) {
+        if (_items.empty() || _compare(_items.back().first, key)) {
+            return _items.end();
+        }
+        return _lower_bound(key);
+    }
+
+    void _sort_unique(flat_map_duplicates dups = flat_map_duplicates::keep_first) {
+        auto less = [&](const auto& a, const auto& b) { return _compare(a.first, b.first); };
+        // Elements are often given in order, in which case there is nothing to do
+        auto not_less = [&](const auto& a, const auto& b) { return !less(a, b); };
+        if (std::adjacent_find(_items.begin(), _items.end(), not_less) == _items.end()) {
+            return;
+        }
+        std::stable_sort(_items.begin(), _items.end(), less);
+        if (dups == flat_map_duplicates::keep_first) {
+            _items.erase(std::unique(_items.begin(), _items.end(), not_less), _items.end());
+            return;
+        }
+        // Move each element over the previous one if they have the same key
+        auto out = _items.begin();
+        for (auto it = std::next(out); it != _items.end(); ++it) {
+            if (less(*out, *it)) {
+                ++out;
+            }
+            if (out != it) {
+                *out = std::move(*it);
+            }
+        }
+        _items.erase(std::next(out), _items.end());
+    }
+
+public:
+    flat_map() = default;
+
+    explicit flat_map(const allocator_type& alloc)
+        : _items(alloc) {}
+
+    flat_map(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type())
+        : _items(il, alloc) {
+        _sort_unique();
+    }
+
+    /**
+     * Construct a map of the given elements, which need not be in order. This
+     * sorts once, rather than inserting each element, so it is O(n log n). If
+     * several elements have the same key, `dups` selects the one that is kept.
+     */
+    explicit flat_map(container_type      items,
+                      flat_map_duplicates dups = flat_map_duplicates::keep_first)
+        : _items(std::move(items)) {
+        _sort_unique(dups);
+    }
+
+    flat_map(const flat_map& other, const allocator_type& alloc)
+        : _items(other._items, alloc)
+        , _compare(other._compare) {}
+
+    flat_map(flat_map&& other, const allocator_type& alloc)
+        : _items(std::move(other._items), alloc)
+        , _compare(std::move(other._compare)) {}
+
+    flat_map(const flat_map&) = default;
+    flat_map(flat_map&&)      = default;
+    flat_map& operator=(const flat_map&) = default;
+    flat_map& operator=(flat_map&&) = default;
+
+    allocator_type get_allocator() const noexcept { return _items.get_allocator(); }
+    key_compare    key_comp() const { return _compare; }
+
+    iterator               begin() noexcept { return _items.begin(); }
+    const_iterator         begin() const noexcept { return _items.begin(); }
+    const_iterator         cbegin() const noexcept { return _items.cbegin(); }
+    iterator               end() noexcept { return _items.end(); }
+    const_iterator         end() const noexcept { return _items.end(); }
+    const_iterator         cend() const noexcept { return _items.cend(); }
+    reverse_iterator       rbegin() noexcept { return _items.rbegin(); }
+    const_reverse_iterator rbegin() const noexcept { return _items.rbegin(); }
+    reverse_iterator       rend() noexcept { return _items.rend(); }
+    const_reverse_iterator rend() const noexcept { return _items.rend(); }
+
+    [[nodiscard]] bool empty() const noexcept { return _items.empty(); }
+    size_type          size() const noexcept { return _items.size(); }
+    size_type          capacity() const noexcept { return _items.capacity(); }
+
+    void reserve(size_type n) { _items.reserve(n); }
+    void clear() noexcept { _items.clear(); }
+
+    template <typename K>
+    iterator lower_bound(const K& key) {
+        return _lower_bound(key);
+    }
+
+    template <typename K>
+    const_iterator lower_bound(const K& key) const {
+        return _lower_bound(key);
+    }
+
+    template <typename K>
+    iterator find(const K& key) {
+        auto it = _lower_bound(key);
+        return _matches(it, key) ? it : _items.end();
+    }
+
+    template <typename K>
+    const_iterator find(const K& key) const {
+        auto it = _lower_bound(key);
+        return _matches(it, key) ? it : _items.end();
+    }
+
+    template <typename K>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+
+    template <typename K>
+    size_type count(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <typename K>
+    mapped_type& at(const K& key) {
+        auto it = find(key);
+        if (it == end()) {
+            SEMESTER_THROW(std::out_of_range("flat_map::at(): No such key"));
+        }
+        return it->second;
+    }
+
+    template <typename K>
+    const mapped_type& at(const K& key) const {
+        auto it = find(key);
+        if (it == end()) {
+            SEMESTER_THROW(std::out_of_range("flat_map::at(): No such key"));
+        }
+        return it->second;
+    }
+
+    /**
+     * Insert an element with the given key and a value constructed from `args`,
+     * unless the key is already present.
+     */
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        auto it = _insert_position(key);
+        if (_matches(it, key)) {
+            return {it, false};
+        }
+        it = _items.emplace(it,
+                            std::piecewise_construct,
+                            std::forward_as_tuple(NEO_FWD(key)),
+                            std::forward_as_tuple(NEO_FWD(args)...));
+        return {it, true};
+    }
+
+    template <typename K, typename V>
+    std::pair<iterator, bool> emplace(K&& key, V&& value) {
+        return try_emplace(NEO_FWD(key), NEO_FWD(value));
+    }
+
+    std::pair<iterator, bool> insert(const value_type& item) {
+        return try_emplace(item.first, item.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& item) {
+        return try_emplace(std::move(item.first), std::move(item.second));
+    }
+
+    template <typename K, typename V>
+    std::pair<iterator, bool> insert_or_assign(K&& key, V&& value) {
+        auto it = _insert_position(key);
+        if (_matches(it, key)) {
+            it->second = NEO_FWD(value);
+            return {it, false};
+        }
+        return {_items.emplace(it, NEO_FWD(key), NEO_FWD(value)), true};
+    }
+
+    template <typename K>
+    mapped_type& operator[](K&& key) {
+        return try_emplace(NEO_FWD(key)).first->second;
+    }
+
+    iterator erase(const_iterator pos) { return _items.erase(pos); }
+    iterator erase(const_iterator first, const_iterator last) { return _items.erase(first, last); }
+
+    template <typename K>
+    requires(!std::is_convertible_v<const K&, const_iterator>)  //
+        size_type erase(const K& key) {
+        auto it = find(key);
+        if (it == end()) {
+            return 0;
+        }
+        _items.erase(it);
+        return 1;
+    }
+
+    friend bool operator==(const flat_map& lhs, const flat_map& rhs) {
+        return lhs._items == rhs._items;
+    }
+};
+
+// clang-format off
+/**
+ * Matches a map that can be constructed in bulk from a container of elements in
+ * any order, as flat_map can.
+ */
+template <typename Map>
+concept bulk_constructible_map = requires(typename Map::container_type&& items) {
+    Map(std::move(items), flat_map_duplicates::keep_last);
+};
+// clang-format on
+
+}  // namespace semester
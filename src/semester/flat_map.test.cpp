@@ -0,0 +1,86 @@
+#include <semester/flat_map.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+TEST_CASE("Insert into and look up in a flat_map") {
+    semester::flat_map<std::string, int> map;
+    CHECK(map.empty());
+
+    CHECK(map.try_emplace("cat", 1).second);
+    CHECK(map.try_emplace("ant", 2).second);
+    CHECK(map.try_emplace("dog", 3).second);
+    CHECK_FALSE(map.try_emplace("cat", 4).second);
+    CHECK(map.size() == 3);
+    CHECK(map.at("cat") == 1);
+
+    // Elements are kept in key order
+    std::string keys;
+    for (auto& [key, value] : map) {
+        keys += key;
+    }
+    CHECK(keys == "antcatdog");
+
+    // Heterogeneous lookup
+    CHECK(map.find(std::string_view("dog"))->second == 3);
+    CHECK(map.find(std::string_view("eel")) == map.end());
+    CHECK(map.contains("ant"));
+#if !SEMESTER_NO_EXCEPTIONS
+    CHECK_THROWS_AS(map.at("eel"), std::out_of_range);
+#endif
+
+    map["eel"] = 5;
+    map["ant"] = 6;
+    CHECK(map.at("ant") == 6);
+    CHECK(map.insert_or_assign("bee", 7).second);
+    CHECK_FALSE(map.insert_or_assign("bee", 8).second);
+    CHECK(map.at("bee") == 8);
+
+    CHECK(map.erase("cat") == 1);
+    CHECK(map.erase("cat") == 0);
+    map.erase(map.begin());
+    CHECK(map == semester::flat_map<std::string, int>{{"eel", 5}, {"dog", 3}, {"bee", 8}});
+}
+
+TEST_CASE("Construct a flat_map in bulk") {
+    using map_type = semester::flat_map<std::string, int>;
+    map_type::container_type items;
+    for (int i = 0; i < 1000; ++i) {
+        items.emplace_back(std::to_string(999 - i), i);
+    }
+    items.emplace_back("500", -1);
+    items.emplace_back("500", -2);
+
+    map_type first{items};
+    CHECK(first.size() == 1000);
+    CHECK(first.begin()->first == "0");
+    CHECK(first.at("500") == 499);
+    CHECK(first.at("999") == 0);
+
+    map_type last{items, semester::flat_map_duplicates::keep_last};
+    CHECK(last.size() == 1000);
+    CHECK(last.at("500") == -2);
+    CHECK(last.at("0") == 999);
+
+    // Elements that are already in order are kept as they are
+    map_type sorted{{{"a", 1}, {"b", 2}}};
+    CHECK(sorted == map_type{{"b", 2}, {"a", 1}});
+    CHECK(map_type{map_type::container_type{}}.empty());
+}
+
+TEST_CASE("flat_map with a memory resource") {
+    std::pmr::monotonic_buffer_resource mr;
+    using map_type = semester::flat_map<std::pmr::string,
+                                        std::pmr::string,
+                                        std::less<>,
+                                        std::pmr::polymorphic_allocator<>>;
+    map_type map{&mr};
+    map.try_emplace("a key long enough to need a heap allocation",
+                    "a value long enough to need a heap allocation");
+    auto& [key, value] = *map.begin();
+    CHECK(key.get_allocator().resource() == &mr);
+    CHECK(value.get_allocator().resource() == &mr);
+}
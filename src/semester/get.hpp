@@ -1,15 +1,46 @@
 #pragma once
 
+#include <semester/config.hpp>
+
 #include <neo/concepts.hpp>
 #include <neo/fwd.hpp>
 #include <neo/iterator_concepts.hpp>
 #include <neo/opt_ref.hpp>
 #include <neo/ref.hpp>
 
+#include <memory>
+#include <optional>
+#include <type_traits>
 #include <variant>
 
 namespace semester {
 
+/**
+ * A nullable, pointer-like object that owns a value. Data types that produce
+ * their values on demand (rather than storing them) return this from try_get().
+ */
+template <typename T>
+class value_holder {
+    std::optional<T> _value;
+
+public:
+    using value_type = T;
+
+    constexpr value_holder() = default;
+    constexpr value_holder(std::nullopt_t) noexcept {}
+    constexpr value_holder(T value) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : _value(std::move(value)) {}
+
+    constexpr explicit operator bool() const noexcept { return _value.has_value(); }
+    constexpr const T& operator*() const noexcept { return *_value; }
+    constexpr const T* operator->() const noexcept { return std::addressof(*_value); }
+
+    /// Move the held value out of the holder
+    constexpr T take() noexcept(std::is_nothrow_move_constructible_v<T>) {
+        return std::move(*_value);
+    }
+};
+
 // clang-format off
 namespace get_detail {
 
@@ -29,8 +60,7 @@ concept try_get_result_of =
 
 template <typename Var, typename T>
 concept try_get_member = requires(Var&& v) {
-    { NEO_FWD(v).template try_get<T>() } noexcept
-        -> try_get_result_of<T>;
+    { NEO_FWD(v).template try_get<T>() } -> try_get_result_of<T>;
 };
 
 template <typename Var, typename T>
@@ -49,6 +79,12 @@ concept get_if_nonmember_ptr = requires(std::remove_reference_t<Var>* v) {
     { get_if<T>(v) } noexcept -> try_get_result_of<T>;
 };
 
+template <typename>
+constexpr bool is_value_holder = false;
+
+template <typename T>
+constexpr bool is_value_holder<value_holder<T>> = true;
+
 template <typename Var, typename T>
 concept try_get_check =
     get_if_nonmember_ptr<Var, T> ||
@@ -56,12 +92,23 @@ concept try_get_check =
     try_get_nonmember<Var, T> ||
     try_get_member<Var, T>;
 
+/// Member try_get() may produce its value on demand, and so may throw
+template <typename Var, typename T>
+concept nothrow_try_get =
+    get_if_nonmember_ptr<Var, T> ||
+    get_if_nonmember_ref<Var, T> ||
+    try_get_nonmember<Var, T> ||
+    requires(Var&& v) {
+        { NEO_FWD(v).template try_get<T>() } noexcept;
+    };
+
 }
 
 template <typename T>
 struct try_get_fn {
     template <get_detail::try_get_check<T> Var>
-    constexpr decltype(auto) operator()(Var&& var) const noexcept {
+    constexpr decltype(auto) operator()(Var&& var) const
+        noexcept(get_detail::nothrow_try_get<Var, T>) {
         using namespace get_detail;
         if constexpr (get_if_nonmember_ptr<Var, T>) {
             return get_if<T>(std::addressof(var));
@@ -86,9 +133,12 @@ struct get_fn {
     constexpr decltype(auto) operator()(Var&& var) const {
         auto&& result = try_get<T>(var);
         if (!result) {
-            throw std::bad_variant_access();
+            SEMESTER_THROW(std::bad_variant_access());
         }
-        if constexpr (std::is_rvalue_reference_v<Var&&>) {
+        if constexpr (get_detail::is_value_holder<std::remove_cvref_t<decltype(result)>>) {
+            // The value was produced on demand, so we return it by value
+            return result.take();
+        } else if constexpr (std::is_rvalue_reference_v<Var&&>) {
             return std::move(*result);
         } else {
             return *result;
@@ -99,10 +149,105 @@ struct get_fn {
 template <typename T>
 inline constexpr get_fn<T> get = {};
 
+/**
+ * The reason that checked_get() did not produce a value
+ */
+enum class get_errc {
+    none = 0,
+    /// The data did not hold a value of the requested type
+    wrong_type,
+};
+
+/**
+ * The result of checked_get(): either the requested value, or the reason that
+ * there is none. This is like std::expected, but does not throw on access
+ * (except for value()). `T` may be a reference type, in which case the result
+ * refers to the value within the data.
+ */
+template <typename T>
+class get_result {
+    using storage_type = std::conditional_t<std::is_reference_v<T>,
+                                            std::remove_reference_t<T>*,
+                                            std::optional<T>>;
+
+    storage_type _val{};
+
+public:
+    using value_type = std::remove_cvref_t<T>;
+
+    /// Construct a result that holds no value
+    constexpr get_result() noexcept = default;
+
+    /// Construct a result that holds the given value
+    template <typename Arg>
+    constexpr explicit get_result(std::in_place_t, Arg&& arg) noexcept(
+        std::is_reference_v<T> || std::is_nothrow_constructible_v<T, Arg>) {
+        if constexpr (std::is_reference_v<T>) {
+            _val = std::addressof(arg);
+        } else {
+            _val.emplace(NEO_FWD(arg));
+        }
+    }
+
+    constexpr bool has_value() const noexcept { return !!_val; }
+    constexpr explicit operator bool() const noexcept { return has_value(); }
+
+    constexpr get_errc error() const noexcept {
+        return has_value() ? get_errc::none : get_errc::wrong_type;
+    }
+
+    /// Access the value. The result must hold a value.
+    constexpr auto& operator*() const noexcept { return *_val; }
+    constexpr auto* operator->() const noexcept { return std::addressof(**this); }
+
+    /// Access the value. Throws std::bad_variant_access if there is none.
+    constexpr auto& value() const {
+        if (!has_value()) {
+            SEMESTER_THROW(std::bad_variant_access());
+        }
+        return **this;
+    }
+
+    /// Get a copy of the value, or `dflt` if there is none
+    template <typename U>
+    constexpr value_type value_or(U&& dflt) const {
+        return has_value() ? value_type(**this) : value_type(NEO_FWD(dflt));
+    }
+};
+
+/**
+ * Like get(), but returns a get_result rather than throwing if the data does
+ * not hold a `T`. Values that are produced on demand, and values of rvalue
+ * data, are held by value. Otherwise, the result refers into the data.
+ */
+template <typename T>
+struct checked_get_fn {
+    template <typename Var>
+        requires get_detail::try_get_check<Var, T>
+    constexpr auto operator()(Var&& var) const {
+        auto&& ref = try_get<T>(var);
+        using ref_type = std::remove_cvref_t<decltype(ref)>;
+        if constexpr (get_detail::is_value_holder<ref_type>) {
+            using result_type = get_result<typename ref_type::value_type>;
+            return ref ? result_type(std::in_place, ref.take()) : result_type();
+        } else if constexpr (std::is_rvalue_reference_v<Var&&>) {
+            using result_type = get_result<std::remove_cvref_t<decltype(*ref)>>;
+            return ref ? result_type(std::in_place, std::move(*ref)) : result_type();
+        } else {
+            using result_type = get_result<decltype(*ref)>;
+            return ref ? result_type(std::in_place, *ref) : result_type();
+        }
+    }
+};
+
+template <typename T>
+inline constexpr checked_get_fn<T> checked_get = {};
+
 template <typename T>
 struct holds_alternative_fn {
     template <get_detail::try_get_check<T> Var>
-    constexpr bool operator()(const Var& v) const noexcept {
+    constexpr bool operator()(const Var& v) const
+        noexcept(get_detail::nothrow_try_get<const Var&, T>) {
         return !!try_get<T>(v);
     }
 };
@@ -110,6 +255,15 @@ struct holds_alternative_fn {
 template <typename T>
 inline constexpr holds_alternative_fn<T> holds_alternative = {};
 
+/**
+ * Matches if `try_get<T>` can be used to query `Var`, even if `Var` cannot be
+ * constructed from a `T` (as is the case for read-only views of data).
+ */
+template <typename Var, typename T>
+concept supports_try_get = requires(Var&& var) {
+    try_get<T>(var);
+};
+
 template <typename Var, typename T>
 concept supports_alternative =
     neo::convertible_to<T, std::remove_cvref_t<Var>> &&
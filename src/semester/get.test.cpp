@@ -6,6 +6,8 @@
 
 #include <catch2/catch.hpp>
 
+#include <string>
+#include <type_traits>
 #include <variant>
 
 NEO_TEST_CONCEPT(semester::supports_alternative<std::variant<int, bool>, bool>);
@@ -19,7 +21,9 @@ TEST_CASE("get for variant<>") {
     CHECK(semester::holds_alternative<int>(var));
     CHECK_FALSE(semester::holds_alternative<bool>(var));
     CHECK(semester::get<int>(var) == 25);
+#if !SEMESTER_NO_EXCEPTIONS
     CHECK_THROWS(semester::get<bool>(var));
+#endif
 
     auto maybe_bool = semester::try_get<bool>(var);
     CHECK_FALSE(maybe_bool);
@@ -29,3 +33,37 @@ TEST_CASE("get for json_data") {
     semester::json_data dat = 33;
     CHECK(semester::get<double>(dat) == 33);
 }
+
+TEST_CASE("checked_get does not throw") {
+    std::variant<int, std::string> var = 25;
+
+    auto res = semester::checked_get<int>(var);
+    REQUIRE(res);
+    CHECK(res.error() == semester::get_errc::none);
+    CHECK(*res == 25);
+    // The result refers into the variant
+    *res = 26;
+    CHECK(std::get<int>(var) == 26);
+
+    auto bad = semester::checked_get<std::string>(var);
+    CHECK_FALSE(bad);
+    CHECK(bad.error() == semester::get_errc::wrong_type);
+    CHECK(bad.value_or("default") == "default");
+#if !SEMESTER_NO_EXCEPTIONS
+    CHECK_THROWS_AS(bad.value(), std::bad_variant_access);
+#endif
+
+    // Rvalue data is moved into the result
+    auto moved = semester::checked_get<std::string>(
+        std::variant<int, std::string>(std::string(100, 'x')));
+    static_assert(std::is_same_v<decltype(moved), semester::get_result<std::string>>);
+    REQUIRE(moved);
+    CHECK(moved->size() == 100);
+
+    const semester::json_data dat = "hello";
+    auto                      str = semester::checked_get<std::string>(dat);
+    static_assert(std::is_same_v<decltype(str), semester::get_result<const std::string&>>);
+    REQUIRE(str);
+    CHECK(*str == "hello");
+    CHECK_FALSE(semester::checked_get<double>(dat));
+}
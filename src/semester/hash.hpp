@@ -0,0 +1,444 @@
+#pragma once
+
+#include <semester/data.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace semester {
+
+namespace detail {
+
+/// Mix a hash value into a running seed. Order matters.
+constexpr std::size_t hash_combine(std::size_t seed, std::size_t h) noexcept {
+    return seed ^ (h + static_cast<std::size_t>(0x9e3779b97f4a7c15ull) + (seed << 6) + (seed >> 2));
+}
+
+/// Scramble a hash value, so that summing scrambled values spreads well
+constexpr std::size_t hash_mix(std::size_t h) noexcept {
+    auto x = static_cast<unsigned long long>(h);
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return static_cast<std::size_t>(x);
+}
+
+// clang-format off
+template <typename T>
+concept std_hashable = requires(const T& val) {
+    { std::hash<T>{}(val) } -> std::convertible_to<std::size_t>;
+};
+
+template <typename T>
+concept pair_like_node = requires(const T& val) {
+    val.left();
+    val.right();
+};
+
+template <typename T>
+concept keyed_range = requires(const T& val) {
+    val.begin()->first;
+    val.begin()->second;
+    val.end();
+};
+
+template <typename T>
+concept plain_range = requires(const T& val) {
+    val.begin();
+    val.end();
+};
+// clang-format on
+
+template <typename T>
+std::size_t hash_key(const T& key) noexcept {
+    if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        // Strings with different allocators hash alike
+        return std::hash<std::string_view>{}(std::string_view(key));
+    } else {
+        return std::hash<T>{}(key);
+    }
+}
+
+/**
+ * Call `fn` with each child of `dat`, in the order in which hash_node() hashes
+ * them.
+ */
+template <typename Data, typename Func>
+void for_each_hash_child(const Data& dat, Func&& fn) {
+    dat.visit([&](const auto& val) {
+        using type = std::remove_cvref_t<decltype(val)>;
+        if constexpr (std::is_same_v<type, null_t>
+                      || std::is_convertible_v<const type&, std::string_view>
+                      || std_hashable<type>) {
+            // A scalar
+        } else if constexpr (pair_like_node<type>) {
+            fn(val.left());
+            fn(val.right());
+        } else if constexpr (keyed_range<type>) {
+            for (const auto& [key, child] : val) {
+                fn(child);
+            }
+        } else if constexpr (plain_range<type>) {
+            for (const auto& child : val) {
+                fn(child);
+            }
+        }
+    });
+}
+
+/**
+ * Call `fn` with each child of `dat` for modification, in the same order as
+ * for_each_hash_child(). A boxed value is cloned first if it is shared, as by
+ * mutate().
+ */
+template <typename Data, typename Func>
+void for_each_child_mut(Data& dat, Func&& fn) {
+    std::visit(
+        [&](auto& alt) {
+            using type = std::remove_cvref_t<decltype(unbox(alt))>;
+            if constexpr (std::is_same_v<type, null_t>
+                          || std::is_convertible_v<const type&, std::string_view>
+                          || std_hashable<type>) {
+                // A scalar
+            } else {
+                auto& val = [&]() -> type& {
+                    if constexpr (data_box<std::remove_cvref_t<decltype(alt)>>) {
+                        return alt.get_mut();
+                    } else {
+                        return alt;
+                    }
+                }();
+                if constexpr (pair_like_node<type>) {
+                    fn(val.left());
+                    fn(val.right());
+                } else if constexpr (keyed_range<type>) {
+                    for (auto& [key, child] : val) {
+                        fn(child);
+                    }
+                } else if constexpr (plain_range<type>) {
+                    for (auto& child : val) {
+                        fn(child);
+                    }
+                }
+            }
+        },
+        dat.variant());
+}
+
+/// Get the address of the value boxed by `dat`, or null if its alternative is not boxed
+template <typename Data>
+const void* boxed_value_address(const Data& dat) noexcept {
+    return std::visit(
+        [](const auto& alt) -> const void* {
+            if constexpr (data_box<std::remove_cvref_t<decltype(alt)>>) {
+                return &alt.get();
+            } else {
+                return nullptr;
+            }
+        },
+        dat.variant());
+}
+
+/// Check whether `dat` holds a boxed value that is shared with another box
+template <typename Data>
+bool box_is_shared(const Data& dat) noexcept {
+    return std::visit(
+        [](const auto& alt) {
+            if constexpr (data_box<std::remove_cvref_t<decltype(alt)>>) {
+                return alt.is_shared();
+            } else {
+                return false;
+            }
+        },
+        dat.variant());
+}
+
+/**
+ * Hash a single node of `dat`. The hash of each child is obtained by calling
+ * `child_hash` with the child, in order.
+ */
+template <typename Data, typename ChildHash>
+std::size_t hash_node(const Data& dat, ChildHash&& child_hash) {
+    const std::size_t index_hash = hash_mix(dat.variant().index() + 1);
+    return hash_combine(index_hash, dat.visit([&](const auto& val) -> std::size_t {
+        using type = std::remove_cvref_t<decltype(val)>;
+        if constexpr (std::is_same_v<type, null_t>) {
+            return 0;
+        } else if constexpr (std::is_convertible_v<const type&, std::string_view>) {
+            return hash_key(val);
+        } else if constexpr (std_hashable<type>) {
+            return std::hash<type>{}(val);
+        } else if constexpr (pair_like_node<type>) {
+            const std::size_t left = child_hash(val.left());
+            return hash_combine(left, child_hash(val.right()));
+        } else if constexpr (keyed_range<type>) {
+            std::size_t h = 0;
+            for (const auto& [key, child] : val) {
+                h += hash_mix(hash_combine(hash_key(key), child_hash(child)));
+            }
+            return h;
+        } else if constexpr (plain_range<type>) {
+            std::size_t h = 0;
+            for (const auto& child : val) {
+                h = hash_combine(h, child_hash(child));
+            }
+            return h;
+        } else {
+            static_assert(std::is_void_v<type>, "No hash is available for this data alternative");
+        }
+    }));
+}
+
+/**
+ * Hash `dat` with loops over an explicit stack on the heap, rather than by
+ * recursion. Gives the same hash as hash_data(). Throws std::bad_alloc if the
+ * stack cannot grow.
+ */
+template <typename Data>
+std::size_t hash_data_iterative(const Data& dat) {
+    struct work {
+        const Data* node;
+        /// Whether the children of the node have been hashed
+        bool children_done;
+    };
+    std::vector<work>        todo{{&dat, false}};
+    std::vector<std::size_t> hashes;
+    while (!todo.empty()) {
+        const work item = todo.back();
+        todo.pop_back();
+        if (!item.children_done) {
+            // Children are pushed in order, so they are hashed in reverse order, and
+            // their hashes are popped back off in order
+            todo.push_back({item.node, true});
+            for_each_hash_child(*item.node,
+                                [&](const Data& child) { todo.push_back({&child, false}); });
+            continue;
+        }
+        const std::size_t h = hash_node(*item.node, [&](const Data&) noexcept {
+            const std::size_t child = hashes.back();
+            hashes.pop_back();
+            return child;
+        });
+        hashes.push_back(h);
+    }
+    return hashes.back();
+}
+
+}  // namespace detail
+
+/**
+ * Compute a structural hash of the given data. Data that compare equal have
+ * equal hashes.
+ *
+ * The hash combines the index of the active alternative with a hash of its
+ * value. Scalars use std::hash, and null_t has a fixed hash. Arrays combine
+ * the hashes of their elements in order. Mappings combine their entries
+ * without regard to order, so that unordered mapping types hash consistently
+ * with their equality. Pair-like alternatives with left() and right() combine
+ * the hashes of both children.
+ *
+ * Like copying and comparison, hashing recurses only as deep as the
+ * recursion_guard allows, and hashes deeper data with an explicit stack. As
+ * that stack is allocated, hashing deep data may throw std::bad_alloc.
+ */
+template <typename Data>
+std::size_t hash_data(const Data& dat) {
+    const detail::recursion_guard guard(true);
+    if (!guard.allowed()) {
+        return detail::hash_data_iterative(dat);
+    }
+    return detail::hash_node(dat, [](const Data& child) { return hash_data(child); });
+}
+
+/**
+ * A table that deduplicates data. Interning a value returns a shared pointer
+ * to the single stored copy of that value, so equal values interned in the
+ * same table share storage, and two interned pointers compare equal if and
+ * only if their values do. A subtree that occurs in many documents can be
+ * interned and held by pointer, rather than stored once for each document.
+ *
+ * For data whose containers are boxed, such as json_cow_data, intern_tree()
+ * interns every container within a document, so that the subtrees that
+ * documents have in common are stored once.
+ *
+ * The table holds a reference to every value it has interned. purge() drops
+ * the values that are no longer referenced from outside of the table. The
+ * table is not synchronized.
+ */
+template <typename Data>
+class intern_table {
+public:
+    using pointer = std::shared_ptr<const Data>;
+
+private:
+    std::unordered_multimap<std::size_t, pointer> _entries;
+    /// The hashes of the boxed values held by the table, by address
+    std::unordered_map<const void*, std::size_t> _boxes;
+
+    template <typename Arg>
+    pointer _intern(std::size_t h, Arg&& arg) {
+        auto [first, last] = _entries.equal_range(h);
+        for (; first != last; ++first) {
+            if (*first->second == arg) {
+                return first->second;
+            }
+        }
+        auto ptr = std::make_shared<const Data>(std::forward<Arg>(arg));
+        _entries.emplace(h, ptr);
+        if (const void* boxed = detail::boxed_value_address(*ptr)) {
+            _boxes.emplace(boxed, h);
+        }
+        return ptr;
+    }
+
+    /// Whether a stored value is referenced only by the table
+    bool _unused(const pointer& stored) const noexcept {
+        return stored.use_count() == 1 && !detail::box_is_shared(*stored);
+    }
+
+    /**
+     * Drop a stored value. The boxed values that it held as children are
+     * appended to `released`, to be dropped if they are unused once it is gone.
+     */
+    auto _drop(typename decltype(_entries)::iterator it, std::vector<const void*>& released) {
+        detail::for_each_hash_child(*it->second, [&](const Data& child) {
+            const void* boxed = detail::boxed_value_address(child);
+            if (boxed && _boxes.contains(boxed)) {
+                released.push_back(boxed);
+            }
+        });
+        if (const void* boxed = detail::boxed_value_address(*it->second)) {
+            _boxes.erase(boxed);
+        }
+        return _entries.erase(it);
+    }
+
+public:
+    /// Get the stored copy of `dat`, storing a copy if there is none yet
+    pointer intern(const Data& dat) { return _intern(hash_data(dat), dat); }
+    /// Get the stored copy of `dat`, moving it into the table if there is none yet
+    pointer intern(Data&& dat) {
+        const std::size_t h = hash_data(dat);
+        return _intern(h, std::move(dat));
+    }
+
+    /**
+     * Intern each boxed node within `dat`, from the leaves up, and replace it
+     * with a copy of the stored node, which shares its boxed value. Afterwards,
+     * every subtree of `dat` that equals a subtree interned before shares its
+     * storage, so documents that differ in a few values share the rest. Nodes
+     * that already share a value with the table are not visited again. Nodes
+     * that are not boxed are not stored, though their children are. Does not
+     * recurse, so `dat` may be arbitrarily deep.
+     */
+    void intern_tree(Data& dat) {
+        struct work {
+            Data* node;
+            /// Whether the children of the node have been interned
+            bool children_done;
+        };
+        std::vector<work>        todo{{&dat, false}};
+        std::vector<std::size_t> hashes;
+        while (!todo.empty()) {
+            const work  item  = todo.back();
+            Data&       node  = *item.node;
+            const void* boxed = detail::boxed_value_address(node);
+            todo.pop_back();
+            if (!item.children_done) {
+                if (auto known = boxed ? _boxes.find(boxed) : _boxes.end(); known != _boxes.end()) {
+                    hashes.push_back(known->second);
+                    continue;
+                }
+                // As in hash_data_iterative(), the hashes of the children are
+                // left on the stack in order
+                todo.push_back({&node, true});
+                detail::for_each_child_mut(node,
+                                           [&](Data& child) { todo.push_back({&child, false}); });
+                continue;
+            }
+            const std::size_t h = detail::hash_node(std::as_const(node), [&](const Data&) noexcept {
+                const std::size_t child = hashes.back();
+                hashes.pop_back();
+                return child;
+            });
+            hashes.push_back(h);
+            if (boxed) {
+                // The children are interned, so an equal node compares them by identity
+                node = *_intern(h, std::as_const(node));
+            }
+        }
+    }
+
+    /// Get the stored copy of `dat`, or null if it has not been interned
+    pointer find(const Data& dat) const {
+        auto [first, last] = _entries.equal_range(hash_data(dat));
+        for (; first != last; ++first) {
+            if (*first->second == dat) {
+                return first->second;
+            }
+        }
+        return nullptr;
+    }
+
+    /// The number of distinct values in the table
+    std::size_t size() const noexcept { return _entries.size(); }
+
+    /**
+     * Drop the values that are referenced only by the table. A boxed value is
+     * also referenced by the nodes that share it, including the children of
+     * other stored values, so it may be dropped along with the last of them.
+     * Throws std::bad_alloc if the list of such values cannot grow.
+     */
+    void purge() {
+        std::vector<const void*> released;
+        for (auto it = _entries.begin(); it != _entries.end();) {
+            it = _unused(it->second) ? _drop(it, released) : std::next(it);
+        }
+        while (!released.empty()) {
+            const void* boxed = released.back();
+            released.pop_back();
+            const auto known = _boxes.find(boxed);
+            if (known == _boxes.end()) {
+                // Already dropped
+                continue;
+            }
+            auto [first, last] = _entries.equal_range(known->second);
+            for (; first != last; ++first) {
+                if (detail::boxed_value_address(*first->second) == boxed) {
+                    if (_unused(first->second)) {
+                        _drop(first, released);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    /// Drop all values from the table. Pointers that were returned stay valid.
+    void clear() noexcept {
+        _entries.clear();
+        _boxes.clear();
+    }
+};
+
+}  // namespace semester
+
+/**
+ * Hash basic_data structurally, so that it can be used as the key of unordered
+ * containers.
+ */
+template <typename Traits>
+struct std::hash<semester::basic_data<Traits>> {
+    std::size_t operator()(const semester::basic_data<Traits>& dat) const {
+        return semester::hash_data(dat);
+    }
+};
@@ -0,0 +1,181 @@
+#include <semester/hash.hpp>
+
+#include <semester/json.hpp>
+#include <semester/s_expr.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <unordered_map>
+#include <unordered_set>
+
+using semester::json_data;
+
+TEST_CASE("Equal data have equal hashes") {
+    std::hash<json_data> h;
+    CHECK(h(json_data(semester::null)) == h(json_data(semester::null)));
+    CHECK(h(json_data("string")) == h(json_data("string")));
+    CHECK(h(json_data(4.0)) == h(json_data(4.0)));
+
+    json_data doc = json_data::mapping_type{
+        {"name", "widget"},
+        {"sizes", json_data::array_type{1.0, 2.0, 3.0}},
+        {"options", json_data::mapping_type{{"fast", true}, {"color", semester::null}}},
+    };
+    json_data copy = doc;
+    CHECK(h(doc) == h(copy));
+
+    // Some unequal data, which should not collide in practice
+    CHECK(h(json_data("1")) != h(json_data(1.0)));
+    CHECK(h(json_data(true)) != h(json_data(1.0)));
+    CHECK(h(json_data(json_data::array_type{1.0, 2.0}))
+          != h(json_data(json_data::array_type{2.0, 1.0})));
+    copy.as_mapping()["name"] = "gadget";
+    CHECK(h(doc) != h(copy));
+
+    semester::json_flat_data flat = semester::json_flat_data::mapping_type{{"a", 1.0}, {"b", 2.0}};
+    CHECK(std::hash<semester::json_flat_data>{}(flat)
+          == std::hash<semester::json_flat_data>{}(
+              semester::json_flat_data::mapping_type{{"b", 2.0}, {"a", 1.0}}));
+
+    using pair_type = semester::s_expr_data::traits_type::pair_type;
+    semester::s_expr_data list = pair_type("a", pair_type("b", semester::null));
+    CHECK(std::hash<semester::s_expr_data>{}(list)
+          == std::hash<semester::s_expr_data>{}(pair_type("a", pair_type("b", semester::null))));
+    CHECK(std::hash<semester::s_expr_data>{}(list)
+          != std::hash<semester::s_expr_data>{}(pair_type("b", pair_type("a", semester::null))));
+}
+
+TEST_CASE("Hash very deep and long data") {
+    using pair_type             = semester::s_expr_data::traits_type::pair_type;
+    semester::s_expr_data list  = semester::null;
+    semester::s_expr_data other = semester::null;
+    for (int i = 0; i < 1000000; ++i) {
+        list  = pair_type("x", std::move(list));
+        other = pair_type("x", std::move(other));
+    }
+    std::hash<semester::s_expr_data> h;
+    CHECK(h(list) == h(other));
+    semester::get<pair_type>(other).left() = std::string("y");
+    CHECK(h(list) != h(other));
+
+    semester::intern_table<semester::s_expr_data> table;
+    auto ptr = table.intern(list);
+    CHECK(table.find(list) == ptr);
+    CHECK(table.find(other) == nullptr);
+
+    json_data  deep = json_data::array_type{};
+    json_data* cur  = &deep;
+    for (int i = 0; i < 200000; ++i) {
+        cur = &cur->as_array().emplace_back(json_data::mapping_type{{"k", 1.0}});
+        cur = &(cur->as_mapping()["next"] = json_data::array_type{});
+    }
+    *cur           = json_data::array_type{1.0, "two"};
+    json_data copy = deep;
+    CHECK(std::hash<json_data>{}(deep) == std::hash<json_data>{}(copy));
+
+    // Data beyond the recursion limit is hashed as it would be by recursion
+    json_data doc = json_data::mapping_type{
+        {"name", "widget"},
+        {"sizes", json_data::array_type{1.0, json_data::array_type{2.0, 3.0}}},
+        {"options", json_data::mapping_type{{"fast", true}, {"color", semester::null}}},
+    };
+    CHECK(semester::detail::hash_data_iterative(doc) == semester::hash_data(doc));
+    CHECK(semester::detail::hash_data_iterative(list) == semester::hash_data(list));
+}
+
+TEST_CASE("Use data as the key of unordered containers") {
+    std::unordered_set<json_data> set;
+    set.insert(json_data("a"));
+    set.insert(json_data(json_data::array_type{1.0, "two"}));
+    set.insert(json_data("a"));
+    CHECK(set.size() == 2);
+    CHECK(set.count(json_data(json_data::array_type{1.0, "two"})) == 1);
+
+    std::unordered_map<json_data, int> counts;
+    ++counts[json_data(semester::null)];
+    ++counts[json_data(semester::null)];
+    CHECK(counts[json_data(semester::null)] == 2);
+}
+
+TEST_CASE("Intern data") {
+    semester::intern_table<json_data> table;
+
+    json_data section = json_data::mapping_type{
+        {"retries", 3.0},
+        {"hosts", json_data::array_type{"a.example", "b.example"}},
+    };
+    auto first  = table.intern(section);
+    auto second = table.intern(json_data(section));
+    CHECK(first == second);
+    CHECK(*first == section);
+    CHECK(table.size() == 1);
+    CHECK(table.find(section) == first);
+
+    section.as_mapping()["retries"] = 4.0;
+    CHECK_FALSE(table.find(section));
+    auto third = table.intern(section);
+    CHECK(third != first);
+    CHECK(table.size() == 2);
+
+    third.reset();
+    table.purge();
+    CHECK(table.size() == 1);
+    CHECK_FALSE(table.find(section));
+    CHECK(table.find(*first) == first);
+}
+
+TEST_CASE("Intern the subtrees of documents") {
+    using semester::json_cow_data;
+    using map_type   = json_cow_data::mapping_type;
+    using array_type = json_cow_data::array_type;
+
+    const auto make_config = [](double port) {
+        return json_cow_data(map_type{
+            {"name", "service"},
+            {"hosts", array_type{"a.example", "b.example"}},
+            {"server", map_type{{"port", port}, {"retries", 3.0}}},
+            {"logging", map_type{{"level", "info"}, {"targets", array_type{"stderr"}}}},
+        });
+    };
+    const auto child = [](const json_cow_data& dat, const char* key) -> const json_cow_data& {
+        return semester::get<map_type>(dat).at(key);
+    };
+
+    json_cow_data first  = make_config(80);
+    json_cow_data second = make_config(8080);
+    CHECK(&semester::get<array_type>(child(first, "hosts"))
+          != &semester::get<array_type>(child(second, "hosts")));
+
+    semester::intern_table<json_cow_data> table;
+    table.intern_tree(first);
+    table.intern_tree(second);
+    CHECK(first == make_config(80));
+    CHECK(second == make_config(8080));
+
+    // The subtrees that are equal are now stored once
+    CHECK(&semester::get<array_type>(child(first, "hosts"))
+          == &semester::get<array_type>(child(second, "hosts")));
+    CHECK(&semester::get<map_type>(child(first, "logging"))
+          == &semester::get<map_type>(child(second, "logging")));
+    CHECK(&semester::get<array_type>(child(child(first, "logging"), "targets"))
+          == &semester::get<array_type>(child(child(second, "logging"), "targets")));
+    // The subtrees that differ are not
+    CHECK(&semester::get<map_type>(child(first, "server"))
+          != &semester::get<map_type>(child(second, "server")));
+    CHECK(&semester::get<map_type>(first) != &semester::get<map_type>(second));
+
+    // Interning a copy finds every node of the copy in the table
+    json_cow_data third = make_config(80);
+    table.intern_tree(third);
+    CHECK(&semester::get<map_type>(third) == &semester::get<map_type>(first));
+    const auto n_stored = table.size();
+    table.purge();
+    CHECK(table.size() == n_stored);
+
+    // Once the documents are gone, so are their subtrees
+    first  = semester::null;
+    second = semester::null;
+    third  = semester::null;
+    table.purge();
+    CHECK(table.size() == 0);
+}
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <semester/cow.hpp>
 #include <semester/data.hpp>
+#include <semester/flat_map.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <variant>
@@ -59,4 +64,144 @@ struct json_traits : json_traits_alloc<std::allocator<void>> {};
  */
 using json_data = basic_data<json_traits>;
 
+struct json_pmr_traits : json_traits_alloc<std::pmr::polymorphic_allocator<std::byte>> {};
+
+/**
+ * Traits for JSON-style data whose mappings are flat_maps: contiguous vectors of
+ * key/value pairs sorted by key. These are faster to build and to iterate than
+ * a node-based map when mappings are small.
+ */
+template <typename Allocator>
+struct json_flat_traits_alloc {
+    template <typename Data>
+    struct traits : json_traits_alloc<Allocator>::template traits<Data> {
+        using base_traits = typename json_traits_alloc<Allocator>::template traits<Data>;
+
+        using typename base_traits::array_type;
+        using typename base_traits::bool_type;
+        using typename base_traits::null_type;
+        using typename base_traits::number_type;
+        using typename base_traits::string_type;
+
+        using mapping_type = flat_map<string_type,  //
+                                      Data,
+                                      std::less<>,
+                                      typename base_traits::template rebind_alloc<
+                                          std::pair<string_type, Data>>>;
+
+        using variant_type = std::variant<  //
+            null_type,                      //
+            string_type,                    //
+            number_type,                    //
+            bool_type,                      //
+            array_type,                     //
+            mapping_type                    //
+            >;
+    };
+};
+
+struct json_flat_traits : json_flat_traits_alloc<std::allocator<void>> {};
+
+/**
+ * JSON data using flat_map for its mappings
+ */
+using json_flat_data = basic_data<json_flat_traits>;
+
+/**
+ * Traits for JSON-style data that keeps integers exact. A number is stored in
+ * one of three alternatives: `int_type` for integers that fit in 64 signed
+ * bits, `uint_type` for larger non-negative integers, and `number_type` for
+ * everything else. The parser chooses the alternative from the text of the
+ * number. When constructing data, the alternative follows the C++ type of the
+ * value: signed integers are stored as `int_type`, and unsigned integers as
+ * `uint_type`.
+ *
+ * put_into() accepts any of the three alternatives for an integral target, as
+ * long as the value is an integer that fits in the target.
+ */
+template <typename Allocator>
+struct json_int_traits_alloc {
+    template <typename Data>
+    struct traits : json_traits_alloc<Allocator>::template traits<Data> {
+        using base_traits = typename json_traits_alloc<Allocator>::template traits<Data>;
+
+        using typename base_traits::array_type;
+        using typename base_traits::bool_type;
+        using typename base_traits::mapping_type;
+        using typename base_traits::null_type;
+        using typename base_traits::number_type;
+        using typename base_traits::string_type;
+
+        using int_type  = std::int64_t;
+        using uint_type = std::uint64_t;
+
+        using variant_type = std::variant<  //
+            null_type,                      //
+            string_type,                    //
+            int_type,                       //
+            uint_type,                      //
+            number_type,                    //
+            bool_type,                      //
+            array_type,                     //
+            mapping_type                    //
+            >;
+
+        using base_traits::convert;
+        static int_type  convert(int n) { return n; }
+        static int_type  convert(long n) { return n; }
+        static int_type  convert(long long n) { return n; }
+        static uint_type convert(unsigned n) { return n; }
+        static uint_type convert(unsigned long n) { return n; }
+        static uint_type convert(unsigned long long n) { return n; }
+    };
+};
+
+struct json_int_traits : json_int_traits_alloc<std::allocator<void>> {};
+
+/**
+ * JSON data that stores integers exactly, separately from floating-point numbers
+ */
+using json_int_data = basic_data<json_int_traits>;
+
+/**
+ * Traits for JSON-style data whose arrays and mappings are copy-on-write. The
+ * containers are held in cow_boxes, so copying data is O(1), and a container
+ * is cloned only when it is modified through as_array(), as_mapping(), or
+ * mutate() while it is shared with another copy.
+ */
+struct json_cow_traits {
+    template <typename Data>
+    struct traits : json_traits_alloc<std::allocator<void>>::template traits<Data> {
+        using base_traits = typename json_traits_alloc<std::allocator<void>>::template traits<Data>;
+
+        using typename base_traits::array_type;
+        using typename base_traits::bool_type;
+        using typename base_traits::mapping_type;
+        using typename base_traits::null_type;
+        using typename base_traits::number_type;
+        using typename base_traits::string_type;
+
+        using variant_type = std::variant<  //
+            null_type,                      //
+            string_type,                    //
+            number_type,                    //
+            bool_type,                      //
+            cow_box<array_type>,            //
+            cow_box<mapping_type>           //
+            >;
+    };
+};
+
+/**
+ * JSON data with copy-on-write arrays and mappings
+ */
+using json_cow_data = basic_data<json_cow_traits>;
+
+/**
+ * JSON data that allocates from a std::pmr::memory_resource. The resource is
+ * given to the allocator-extended constructors and is propagated to every
+ * nested node, so an entire document may live in a single arena.
+ */
+using json_pmr_data = basic_data<json_pmr_traits>;
+
 }  // namespace semester
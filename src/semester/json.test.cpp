@@ -2,6 +2,9 @@
 
 #include <catch2/catch.hpp>
 
+#include <cstdint>
+#include <limits>
+
 TEST_CASE("Create a JSON node") {
     semester::json_data d1;
     semester::json_data d2 = 6;
@@ -16,3 +19,67 @@ TEST_CASE("Create a JSON node") {
     d2 = semester::empty_mapping;
     CHECK(d1 == d2);
 }
+
+TEST_CASE("Create JSON nodes with a memory resource") {
+    std::pmr::monotonic_buffer_resource mr;
+    std::pmr::polymorphic_allocator<>   alloc{&mr};
+
+    semester::json_pmr_data dat{std::allocator_arg, alloc, semester::empty_mapping};
+    CHECK(dat.get_allocator() == alloc);
+    auto& map = dat.as_mapping();
+    CHECK(map.get_allocator() == alloc);
+
+    map["name"] = "a string long enough to need a heap allocation";
+    CHECK(map.at("name").get_allocator() == alloc);
+    CHECK(map.at("name").as_string().get_allocator() == alloc);
+
+    map["list"] = semester::json_pmr_data::array_type{};
+    auto& arr   = map.at("list").as_array();
+    CHECK(arr.get_allocator() == alloc);
+    arr.emplace_back("another string long enough to need a heap allocation");
+    CHECK(arr.back().as_string().get_allocator() == alloc);
+
+    // Copies made with a different allocator use that allocator throughout
+    std::pmr::monotonic_buffer_resource other_mr;
+    semester::json_pmr_data copy{std::allocator_arg, &other_mr, dat};
+    CHECK(copy == dat);
+    CHECK(copy.get_allocator().resource() == &other_mr);
+    CHECK(copy.as_mapping().at("list").as_array().back().as_string().get_allocator().resource()
+          == &other_mr);
+
+    // Assignment keeps the allocator of the destination
+    copy = dat;
+    CHECK(copy.get_allocator().resource() == &other_mr);
+    CHECK(copy.as_mapping().at("name").as_string().get_allocator().resource() == &other_mr);
+}
+
+TEST_CASE("Create JSON nodes with flat mappings") {
+    semester::json_flat_data dat = semester::empty_mapping;
+    auto&                    map = dat.as_mapping();
+    map["zed"]                   = 1;
+    map["alpha"]                 = "first";
+    map["mid"]                   = semester::empty_array;
+    CHECK(map.begin()->first == "alpha");
+    CHECK(map.at("zed") == 1);
+    CHECK(map.find(std::string_view("mid"))->second.is_array());
+
+    semester::json_flat_data copy = dat;
+    CHECK(copy == dat);
+    copy.as_mapping()["zed"] = 2;
+    CHECK(copy != dat);
+}
+
+TEST_CASE("Create JSON nodes with exact integers") {
+    semester::json_int_data dat = 5;
+    CHECK(dat.is_int64());
+    dat = 5u;
+    CHECK(dat.is_uint64());
+    CHECK(dat.as_uint64() == 5);
+    dat = 2.5;
+    CHECK(dat.is_double());
+    dat = std::numeric_limits<std::int64_t>::max();
+    CHECK(dat.as_int64() == std::numeric_limits<std::int64_t>::max());
+    // The integer alternatives are distinct from each other and from doubles
+    CHECK(semester::json_int_data(5) != semester::json_int_data(5u));
+    CHECK(semester::json_int_data(5) != semester::json_int_data(5.0));
+}
@@ -0,0 +1,947 @@
+#pragma once
+
+#include <semester/config.hpp>
+#include <semester/data.hpp>
+#include <semester/flat_map.hpp>
+#include <semester/json.hpp>
+#include <semester/json_scan.hpp>
+
+#include <neo/fwd.hpp>
+
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+#if !SEMESTER_HAVE_FLOAT_CHARCONV
+#include <clocale>
+#include <locale.h>
+#include <stdlib.h>
+#if defined(__APPLE__) || defined(__FreeBSD__)
+#include <xlocale.h>
+#endif
+#endif
+
+namespace semester {
+
+/**
+ * Error conditions that can be encountered while parsing JSON text.
+ */
+enum class json_errc {
+    none = 0,
+    unexpected_end,
+    unexpected_character,
+    invalid_literal,
+    invalid_number,
+    invalid_escape,
+    invalid_unicode_escape,
+    control_character_in_string,
+    too_deep,
+    trailing_characters,
+};
+
+/**
+ * Get a human-readable description of a JSON parsing error
+ */
+constexpr const char* describe(json_errc ec) noexcept {
+    switch (ec) {
+    case json_errc::none:
+        return "No error";
+    case json_errc::unexpected_end:
+        return "Unexpected end of input";
+    case json_errc::unexpected_character:
+        return "Unexpected character";
+    case json_errc::invalid_literal:
+        return "Invalid literal";
+    case json_errc::invalid_number:
+        return "Invalid number";
+    case json_errc::invalid_escape:
+        return "Invalid escape sequence in string";
+    case json_errc::invalid_unicode_escape:
+        return "Invalid unicode escape sequence in string";
+    case json_errc::control_character_in_string:
+        return "Unescaped control character in string";
+    case json_errc::too_deep:
+        return "Maximum nesting depth exceeded";
+    case json_errc::trailing_characters:
+        return "Trailing characters after JSON value";
+    }
+    return "Unknown error";
+}
+
+/**
+ * Exception thrown by parse_json() when given invalid JSON text.
+ */
+struct json_parse_error : std::runtime_error {
+    json_errc   code;
+    std::size_t offset;
+
+    json_parse_error(json_errc ec, std::size_t off)
+        : runtime_error("Invalid JSON at offset " + std::to_string(off) + ": " + describe(ec))
+        , code(ec)
+        , offset(off) {}
+};
+
+/**
+ * The result of try_parse_json(). If parsing failed, `error` and `offset` describe
+ * the failure and `value` is unspecified.
+ */
+template <typename Data>
+struct json_parse_result {
+    Data        value;
+    json_errc   error  = json_errc::none;
+    std::size_t offset = 0;
+
+    explicit operator bool() const noexcept { return error == json_errc::none; }
+};
+
+/**
+ * Options to control JSON parsing.
+ */
+struct json_parse_options {
+    /// The maximum nesting of arrays and objects that will be accepted
+    std::size_t max_depth = 1024;
+};
+
+// clang-format off
+/**
+ * Matches a basic_data type that can store every kind of JSON value
+ */
+template <typename Data>
+concept json_shaped_data = requires {
+    typename Data::traits_type::null_type;
+    typename Data::traits_type::bool_type;
+    typename Data::traits_type::number_type;
+    typename Data::traits_type::string_type;
+    typename mapping_type_t<Data>;
+    typename array_type_t<Data>;
+};
+
+/**
+ * Matches JSON-shaped data whose strings are views of the text that they were
+ * parsed from, rather than owning strings.
+ */
+template <typename Data>
+concept json_view_strings = json_shaped_data<Data>
+    && std::same_as<typename Data::traits_type::string_type, std::string_view>;
+
+/**
+ * Matches JSON-shaped data that stores integers in their own alternatives,
+ * separately from `number_type` (see json_int_traits_alloc).
+ */
+template <typename Data>
+concept json_int_numbers = json_shaped_data<Data> && requires {
+    typename Data::traits_type::int_type;
+    typename Data::traits_type::uint_type;
+};
+// clang-format on
+
+namespace detail {
+
+/**
+ * Append the UTF-8 encoding of the given code point to the string
+ */
+template <typename String>
+void append_utf8(String& str, std::uint32_t cp) {
+    if (cp < 0x80) {
+        str.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        str.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+        str.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    } else if (cp < 0x10000) {
+        str.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+        str.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+        str.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    } else {
+        str.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+        str.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+        str.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+        str.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    }
+}
+
+#if !SEMESTER_HAVE_FLOAT_CHARCONV
+/**
+ * Convert the number at the beginning of a C string to a double, as the "C"
+ * locale would. strtod() alone would expect the decimal point of the locale
+ * that the program has set.
+ */
+inline double strtod_c_locale(const char* str) noexcept {
+#if defined(_WIN32)
+    static const ::_locale_t c_locale = ::_create_locale(LC_NUMERIC, "C");
+    if (c_locale) {
+        return ::_strtod_l(str, nullptr, c_locale);
+    }
+#else
+    static const ::locale_t c_locale = ::newlocale(LC_NUMERIC_MASK, "C", ::locale_t(0));
+    if (c_locale) {
+        return ::strtod_l(str, nullptr, c_locale);
+    }
+#endif
+    // The locale could not be created, which only happens when memory is exhausted
+    return std::strtod(str, nullptr);
+}
+#endif
+
+/**
+ * Parse a JSON number from [first, last) into a double. The text must already
+ * have been validated against the JSON number grammar. The result does not
+ * depend on the locale.
+ */
+inline double json_number_to_double(const char* first, const char* last) noexcept {
+#if SEMESTER_HAVE_FLOAT_CHARCONV
+    double value = 0;
+    std::from_chars(first, last, value);
+    return value;
+#else
+    char        buf[128];
+    std::string heap_buf;
+    const auto  len = static_cast<std::size_t>(last - first);
+    const char* str = buf;
+    if (len < sizeof buf) {
+        std::memcpy(buf, first, len);
+        buf[len] = 0;
+    } else {
+        heap_buf.assign(first, last);
+        str = heap_buf.c_str();
+    }
+    return strtod_c_locale(str);
+#endif
+}
+
+/**
+ * Collects the members of a mapping while it is decoded. Members are inserted
+ * into the mapping as they are decoded. If a key appears more than once, the
+ * last value wins.
+ */
+template <typename Map>
+class mapping_builder {
+    Map& _map;
+
+public:
+    explicit mapping_builder(Map& map) noexcept
+        : _map(map) {}
+
+    void reserve(std::size_t n) {
+        if constexpr (requires { _map.reserve(n); }) {
+            _map.reserve(n);
+        }
+    }
+
+    /// Get the slot for the value of the given key
+    template <typename Key>
+    auto& add(Key&& key) {
+        return _map.try_emplace(NEO_FWD(key)).first->second;
+    }
+
+    void finish() noexcept {}
+};
+
+/**
+ * Inserting each member into a flat_map is quadratic when the keys arrive out of
+ * order, so the members of a flat_map are appended in the order that they are
+ * decoded, then sorted once when the mapping is finished.
+ */
+template <bulk_constructible_map Map>
+class mapping_builder<Map> {
+    Map&                         _map;
+    typename Map::container_type _items;
+
+public:
+    explicit mapping_builder(Map& map)
+        : _map(map)
+        , _items(map.get_allocator()) {}
+
+    void reserve(std::size_t n) { _items.reserve(n); }
+
+    template <typename Key>
+    auto& add(Key&& key) {
+        return _items
+            .emplace_back(std::piecewise_construct,
+                          std::forward_as_tuple(NEO_FWD(key)),
+                          std::forward_as_tuple())
+            .second;
+    }
+
+    void finish() { _map = Map(std::move(_items), flat_map_duplicates::keep_last); }
+};
+
+/**
+ * A string type that discards everything appended to it. Used to validate JSON
+ * strings without decoding them.
+ */
+struct json_discard_string {
+    void append(const char*, const char*) noexcept {}
+    void push_back(char) noexcept {}
+};
+
+/**
+ * Scans and validates JSON text. Errors are reported through `error`; the
+ * cursor itself never throws (except for allocation failure when decoding
+ * into an allocating string).
+ */
+class json_cursor {
+public:
+    json_errc error = json_errc::none;
+
+protected:
+    const char* _begin;
+    const char* _it;
+    const char* _end;
+
+    bool _fail(json_errc ec) noexcept {
+        error = ec;
+        return false;
+    }
+
+    bool _fail_at_end_or(json_errc ec) noexcept {
+        return _fail(_it == _end ? json_errc::unexpected_end : ec);
+    }
+
+    bool _literal(std::string_view lit) noexcept {
+        if (static_cast<std::size_t>(_end - _it) < lit.size()) {
+            _it = _end;
+            return _fail(json_errc::unexpected_end);
+        }
+        if (std::memcmp(_it, lit.data(), lit.size()) != 0) {
+            return _fail(json_errc::invalid_literal);
+        }
+        _it += lit.size();
+        return true;
+    }
+
+    bool _hex4(std::uint32_t& out) noexcept {
+        if (_end - _it < 4) {
+            _it = _end;
+            return _fail(json_errc::unexpected_end);
+        }
+        std::uint32_t value = 0;
+        for (auto stop = _it + 4; _it != stop; ++_it) {
+            const char c = *_it;
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= static_cast<std::uint32_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                value |= static_cast<std::uint32_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                value |= static_cast<std::uint32_t>(c - 'A' + 10);
+            } else {
+                return _fail(json_errc::invalid_unicode_escape);
+            }
+        }
+        out = value;
+        return true;
+    }
+
+    template <typename String>
+    bool _unicode_escape(String& out) {
+        std::uint32_t cp = 0;
+        if (!_hex4(cp)) {
+            return false;
+        }
+        if (cp >= 0xdc00 && cp <= 0xdfff) {
+            // Lone low surrogate
+            return _fail(json_errc::invalid_unicode_escape);
+        }
+        if (cp >= 0xd800 && cp <= 0xdbff) {
+            // High surrogate: Must be followed by an escaped low surrogate
+            if (_end - _it < 2 || _it[0] != '\\' || _it[1] != 'u') {
+                return _fail_at_end_or(json_errc::invalid_unicode_escape);
+            }
+            _it += 2;
+            std::uint32_t low = 0;
+            if (!_hex4(low)) {
+                return false;
+            }
+            if (low < 0xdc00 || low > 0xdfff) {
+                return _fail(json_errc::invalid_unicode_escape);
+            }
+            cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+        }
+        append_utf8(out, cp);
+        return true;
+    }
+
+    template <typename String>
+    bool _escape(String& out) {
+        // _it points to the character following the backslash
+        if (_it == _end) {
+            return _fail(json_errc::unexpected_end);
+        }
+        const char c = *_it++;
+        switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+            out.push_back(c);
+            return true;
+        case 'b':
+            out.push_back('\b');
+            return true;
+        case 'f':
+            out.push_back('\f');
+            return true;
+        case 'n':
+            out.push_back('\n');
+            return true;
+        case 'r':
+            out.push_back('\r');
+            return true;
+        case 't':
+            out.push_back('\t');
+            return true;
+        case 'u':
+            return _unicode_escape(out);
+        default:
+            --_it;
+            return _fail(json_errc::invalid_escape);
+        }
+    }
+
+public:
+    json_cursor(const char* begin, const char* it, const char* end) noexcept
+        : _begin(begin)
+        , _it(it)
+        , _end(end) {}
+
+    explicit json_cursor(std::string_view text) noexcept
+        : json_cursor(text.data(), text.data(), text.data() + text.size()) {}
+
+    /// The offset of the cursor within the input
+    std::size_t offset() const noexcept { return static_cast<std::size_t>(_it - _begin); }
+
+    /// The current position of the cursor
+    const char* position() const noexcept { return _it; }
+
+    /// Skip past any whitespace at the current position
+    void skip_ws() noexcept { _it = skip_json_ws(_it, _end); }
+
+    /// Check whether the next character is `c`, and if so, consume it
+    bool consume(char c) noexcept {
+        if (_it != _end && *_it == c) {
+            ++_it;
+            return true;
+        }
+        return false;
+    }
+
+    /// Consume the character `c`, or fail with the given error
+    bool expect(char c, json_errc ec = json_errc::unexpected_character) noexcept {
+        return consume(c) || _fail_at_end_or(ec);
+    }
+
+    /// Skip past trailing whitespace, and fail if anything else follows
+    bool expect_end() noexcept {
+        skip_ws();
+        return _it == _end || _fail(json_errc::trailing_characters);
+    }
+
+    /**
+     * Parse the body of a string into `out`, which may be any type with `append()`
+     * and `push_back()`. `_it` must point to the opening quote.
+     */
+    template <typename String>
+    bool parse_string(String& out) {
+        ++_it;
+        const char* run = _it;
+        while (true) {
+            const char* special = find_json_string_special(_it, _end);
+            if (special == _end) {
+                _it = _end;
+                return _fail(json_errc::unexpected_end);
+            }
+            out.append(run, special);
+            _it = special + 1;
+            if (*special == '"') {
+                return true;
+            }
+            if (*special != '\\') {
+                _it = special;
+                return _fail(json_errc::control_character_in_string);
+            }
+            if (!_escape(out)) {
+                return false;
+            }
+            run = _it;
+        }
+    }
+
+    /**
+     * Parse a string without copying it, if possible. If the string contains no
+     * escapes, `out` will refer directly to the input text. Otherwise, the
+     * string is decoded into `scratch`, and `out` will refer to `scratch`.
+     * `_it` must point to the opening quote.
+     */
+    bool parse_string_view(std::string_view& out, std::string& scratch) {
+        const char* first   = _it + 1;
+        const char* special = find_json_string_special(first, _end);
+        if (special != _end && *special == '"') {
+            out = std::string_view(first, static_cast<std::size_t>(special - first));
+            _it = special + 1;
+            return true;
+        }
+        scratch.clear();
+        if (!parse_string(scratch)) {
+            return false;
+        }
+        out = scratch;
+        return true;
+    }
+
+    /**
+     * Validate a number against the JSON grammar, returning the end of the
+     * number text in `num_end`.
+     */
+    bool scan_number(const char*& num_end, bool& is_integer) noexcept {
+        const char* it = _it;
+        if (it != _end && *it == '-') {
+            ++it;
+        }
+        if (it == _end) {
+            _it = it;
+            return _fail(json_errc::unexpected_end);
+        }
+        if (*it == '0') {
+            ++it;
+        } else if (is_json_digit(*it)) {
+            while (it != _end && is_json_digit(*it)) {
+                ++it;
+            }
+        } else {
+            _it = it;
+            return _fail(json_errc::invalid_number);
+        }
+        is_integer = true;
+        if (it != _end && *it == '.') {
+            is_integer = false;
+            ++it;
+            if (it == _end || !is_json_digit(*it)) {
+                _it = it;
+                return _fail_at_end_or(json_errc::invalid_number);
+            }
+            while (it != _end && is_json_digit(*it)) {
+                ++it;
+            }
+        }
+        if (it != _end && (*it == 'e' || *it == 'E')) {
+            is_integer = false;
+            ++it;
+            if (it != _end && (*it == '+' || *it == '-')) {
+                ++it;
+            }
+            if (it == _end || !is_json_digit(*it)) {
+                _it = it;
+                return _fail_at_end_or(json_errc::invalid_number);
+            }
+            while (it != _end && is_json_digit(*it)) {
+                ++it;
+            }
+        }
+        num_end = it;
+        return true;
+    }
+
+    /**
+     * Parse a number. `_it` must point to the first character of the number.
+     */
+    template <typename Number>
+    bool parse_number(Number& out) noexcept {
+        const char* num_end    = nullptr;
+        bool        is_integer = false;
+        if (!scan_number(num_end, is_integer)) {
+            return false;
+        }
+        const char* digits   = _it + (*_it == '-');
+        const auto  n_digits = num_end - digits;
+        if (is_integer && n_digits <= 15) {
+            // Fast path: Any integer of at most 15 digits is exactly representable
+            std::int64_t value = 0;
+            for (auto it = digits; it != num_end; ++it) {
+                value = value * 10 + (*it - '0');
+            }
+            // Negate in the floating type, so that "-0" keeps its sign
+            out = digits != _it ? -static_cast<Number>(value) : static_cast<Number>(value);
+        } else {
+            out = static_cast<Number>(json_number_to_double(_it, num_end));
+        }
+        _it = num_end;
+        return true;
+    }
+
+    /**
+     * Parse a number into one of the integer alternatives of `out` if it is an
+     * integer that fits, and into the `number_type` alternative otherwise.
+     * Non-negative integers are stored as `Int` unless they only fit in `UInt`.
+     */
+    template <typename Int, typename UInt, typename Number, typename Data>
+    bool parse_exact_number(Data& out) noexcept {
+        const char* num_end    = nullptr;
+        bool        is_integer = false;
+        if (!scan_number(num_end, is_integer)) {
+            return false;
+        }
+        const char* first = _it;
+        _it               = num_end;
+        if (is_integer) {
+            if (*first == '-') {
+                Int        value = 0;
+                const auto res   = std::from_chars(first, num_end, value);
+                if (res.ec == std::errc{}) {
+                    out.template emplace<Int>(value);
+                    return true;
+                }
+            } else {
+                UInt       value = 0;
+                const auto res   = std::from_chars(first, num_end, value);
+                if (res.ec == std::errc{}) {
+                    if (value <= static_cast<UInt>((std::numeric_limits<Int>::max)())) {
+                        out.template emplace<Int>(static_cast<Int>(value));
+                    } else {
+                        out.template emplace<UInt>(value);
+                    }
+                    return true;
+                }
+            }
+        }
+        // A fraction, an exponent, or an integer too large for any integer type
+        out.template emplace<Number>(static_cast<Number>(json_number_to_double(first, num_end)));
+        return true;
+    }
+
+    /**
+     * Validate and skip a single value without building anything. `_it` must
+     * point to the first character of the value.
+     */
+    bool skip_value(std::size_t depth, std::size_t max_depth) {
+        if (_it == _end) {
+            return _fail(json_errc::unexpected_end);
+        }
+        const char c = *_it;
+        if (c == '{' || c == '[') {
+            if (depth == max_depth) {
+                return _fail(json_errc::too_deep);
+            }
+            const char close  = c == '{' ? '}' : ']';
+            const bool is_map = c == '{';
+            ++_it;
+            skip_ws();
+            if (consume(close)) {
+                return true;
+            }
+            while (true) {
+                if (is_map) {
+                    json_discard_string key;
+                    if (_it == _end || *_it != '"') {
+                        return _fail_at_end_or(json_errc::unexpected_character);
+                    }
+                    if (!parse_string(key)) {
+                        return false;
+                    }
+                    skip_ws();
+                    if (!expect(':')) {
+                        return false;
+                    }
+                    skip_ws();
+                }
+                if (!skip_value(depth + 1, max_depth)) {
+                    return false;
+                }
+                skip_ws();
+                if (consume(close)) {
+                    return true;
+                }
+                if (!expect(',')) {
+                    return false;
+                }
+                skip_ws();
+            }
+        }
+        switch (c) {
+        case '"': {
+            json_discard_string str;
+            return parse_string(str);
+        }
+        case 't':
+            return _literal("true");
+        case 'f':
+            return _literal("false");
+        case 'n':
+            return _literal("null");
+        default: {
+            const char* num_end    = nullptr;
+            bool        is_integer = false;
+            if (!is_json_digit(c) && c != '-') {
+                return _fail(json_errc::unexpected_character);
+            }
+            if (!scan_number(num_end, is_integer)) {
+                return false;
+            }
+            _it = num_end;
+            return true;
+        }
+        }
+    }
+};
+
+/**
+ * A recursive-descent JSON parser that builds a JSON-shaped basic_data. Errors
+ * are reported through `error`; the parser itself never throws (except for
+ * allocation failure).
+ */
+template <json_shaped_data Data>
+class json_parser : public json_cursor {
+public:
+    using traits_type  = typename Data::traits_type;
+    using null_type    = typename traits_type::null_type;
+    using bool_type    = typename traits_type::bool_type;
+    using number_type  = typename traits_type::number_type;
+    using string_type  = typename traits_type::string_type;
+    using array_type   = array_type_t<Data>;
+    using mapping_type = mapping_type_t<Data>;
+
+private:
+    json_parse_options _opts;
+    /// Storage for strings that cannot refer to the input text directly
+    std::pmr::memory_resource* _strings = nullptr;
+    std::string                _scratch;
+
+    bool _parse_string(string_type& out) {
+        if constexpr (json_view_strings<Data>) {
+            if (!parse_string_view(out, _scratch)) {
+                return false;
+            }
+            if (out.data() == _scratch.data() && !out.empty()) {
+                // The string had escapes, so the decoded string must be kept
+                auto buf = static_cast<char*>(_strings->allocate(out.size(), 1));
+                std::memcpy(buf, out.data(), out.size());
+                out = std::string_view(buf, out.size());
+            }
+            return true;
+        } else {
+            return parse_string(out);
+        }
+    }
+
+public:
+    bool parse_array(Data& out, std::size_t depth) {
+        auto& arr = out.template emplace<array_type>();
+        ++_it;
+        _it = skip_json_ws(_it, _end);
+        if (_it != _end && *_it == ']') {
+            ++_it;
+            return true;
+        }
+        while (true) {
+            if (!parse_value(arr.emplace_back(), depth)) {
+                return false;
+            }
+            _it = skip_json_ws(_it, _end);
+            if (_it == _end) {
+                return _fail(json_errc::unexpected_end);
+            }
+            if (*_it == ',') {
+                _it = skip_json_ws(_it + 1, _end);
+            } else if (*_it == ']') {
+                ++_it;
+                return true;
+            } else {
+                return _fail(json_errc::unexpected_character);
+            }
+        }
+    }
+
+    bool parse_mapping(Data& out, std::size_t depth) {
+        auto&                         map = out.template emplace<mapping_type>();
+        mapping_builder<mapping_type> members{map};
+        ++_it;
+        _it = skip_json_ws(_it, _end);
+        if (_it != _end && *_it == '}') {
+            ++_it;
+            return true;
+        }
+        while (true) {
+            if (_it == _end || *_it != '"') {
+                return _fail_at_end_or(json_errc::unexpected_character);
+            }
+            // Keys use the allocator of the mapping that will hold them
+            auto key = std::make_obj_using_allocator<string_type>(map.get_allocator());
+            if (!_parse_string(key)) {
+                return false;
+            }
+            _it = skip_json_ws(_it, _end);
+            if (_it == _end || *_it != ':') {
+                return _fail_at_end_or(json_errc::unexpected_character);
+            }
+            _it = skip_json_ws(_it + 1, _end);
+            if (!parse_value(members.add(std::move(key)), depth)) {
+                return false;
+            }
+            _it = skip_json_ws(_it, _end);
+            if (_it == _end) {
+                return _fail(json_errc::unexpected_end);
+            }
+            if (*_it == ',') {
+                _it = skip_json_ws(_it + 1, _end);
+            } else if (*_it == '}') {
+                ++_it;
+                members.finish();
+                return true;
+            } else {
+                return _fail(json_errc::unexpected_character);
+            }
+        }
+    }
+
+    /**
+     * Parse a single value. `_it` must point to the first character of the value.
+     */
+    bool parse_value(Data& out, std::size_t depth) {
+        if (_it == _end) {
+            return _fail(json_errc::unexpected_end);
+        }
+        switch (*_it) {
+        case '{':
+            if (depth == _opts.max_depth) {
+                return _fail(json_errc::too_deep);
+            }
+            return parse_mapping(out, depth + 1);
+        case '[':
+            if (depth == _opts.max_depth) {
+                return _fail(json_errc::too_deep);
+            }
+            return parse_array(out, depth + 1);
+        case '"':
+            return _parse_string(out.template emplace<string_type>());
+        case 't':
+            out.template emplace<bool_type>(true);
+            return _literal("true");
+        case 'f':
+            out.template emplace<bool_type>(false);
+            return _literal("false");
+        case 'n':
+            out.template emplace<null_type>();
+            return _literal("null");
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            if constexpr (json_int_numbers<Data>) {
+                return parse_exact_number<typename traits_type::int_type,
+                                          typename traits_type::uint_type,
+                                          number_type>(out);
+            } else {
+                return parse_number(out.template emplace<number_type>());
+            }
+        default:
+            return _fail(json_errc::unexpected_character);
+        }
+    }
+
+    json_parser(std::string_view text, json_parse_options opts) noexcept
+        : json_cursor(text)
+        , _opts(opts) {
+        static_assert(!json_view_strings<Data>,
+                      "Parsing into string views requires a memory resource for decoded strings");
+    }
+
+    /**
+     * Create a parser for data that uses string views. Strings that cannot
+     * refer directly to `text` are allocated from `strings`.
+     */
+    json_parser(std::string_view text, json_parse_options opts, std::pmr::memory_resource& strings)
+        : json_cursor(text)
+        , _opts(opts)
+        , _strings(&strings) {}
+
+    /**
+     * Parse the entire input as a single JSON value
+     */
+    bool parse_document(Data& out) {
+        _it = skip_json_ws(_it, _end);
+        if (!parse_value(out, 0)) {
+            return false;
+        }
+        return expect_end();
+    }
+};
+
+}  // namespace detail
+
+/**
+ * Parse the given JSON text into a data object. On failure, returns a result
+ * with `error` set rather than throwing.
+ */
+template <json_shaped_data Data = json_data>
+json_parse_result<Data> try_parse_json(std::string_view text, json_parse_options opts = {}) {
+    json_parse_result<Data>   ret;
+    detail::json_parser<Data> parser{text, opts};
+    if (!parser.parse_document(ret.value)) {
+        ret.error  = parser.error;
+        ret.offset = parser.offset();
+    }
+    return ret;
+}
+
+/**
+ * Parse the given JSON text into a data object that allocates using `alloc`.
+ * Every node, key, and string of the document is created with the allocator.
+ */
+template <json_shaped_data Data, typename Alloc>
+requires std::uses_allocator_v<Data, Alloc>  //
+    json_parse_result<Data> try_parse_json(std::string_view   text,
+                                           const Alloc&       alloc,
+                                           json_parse_options opts = {}) {
+    json_parse_result<Data>   ret{Data(std::allocator_arg, alloc)};
+    detail::json_parser<Data> parser{text, opts};
+    if (!parser.parse_document(ret.value)) {
+        ret.error  = parser.error;
+        ret.offset = parser.offset();
+    }
+    return ret;
+}
+
+/**
+ * Parse the given JSON text into a data object. Throws json_parse_error if the
+ * text is not valid JSON.
+ */
+template <json_shaped_data Data = json_data>
+Data parse_json(std::string_view text, json_parse_options opts = {}) {
+    auto result = try_parse_json<Data>(text, opts);
+    if (!result) {
+        SEMESTER_THROW(json_parse_error(result.error, result.offset));
+    }
+    return std::move(result.value);
+}
+
+/**
+ * Parse the given JSON text into a data object that allocates using `alloc`.
+ * Throws json_parse_error if the text is not valid JSON.
+ */
+template <json_shaped_data Data, typename Alloc>
+requires std::uses_allocator_v<Data, Alloc>  //
+    Data parse_json(std::string_view text, const Alloc& alloc, json_parse_options opts = {}) {
+    auto result = try_parse_json<Data>(text, alloc, opts);
+    if (!result) {
+        SEMESTER_THROW(json_parse_error(result.error, result.offset));
+    }
+    return std::move(result.value);
+}
+
+}  // namespace semester
@@ -0,0 +1,177 @@
+#include <semester/json_parse.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <string>
+
+TEST_CASE("Parse JSON scalars") {
+    CHECK(semester::parse_json("null") == semester::null);
+    CHECK(semester::parse_json("true") == true);
+    CHECK(semester::parse_json(" false ") == false);
+    CHECK(semester::parse_json("12") == 12.0);
+    CHECK(semester::parse_json("-0") == 0.0);
+    CHECK(std::signbit(semester::get<double>(semester::parse_json("-0"))));
+    CHECK_FALSE(std::signbit(semester::get<double>(semester::parse_json("0"))));
+    CHECK(semester::parse_json("-12.5e2") == -1250.0);
+    CHECK(semester::parse_json("1E-2") == 0.01);
+    CHECK(semester::parse_json("123456789012345678") == 123456789012345678.0);
+    CHECK(semester::parse_json("\"I am a string\"") == "I am a string");
+}
+
+TEST_CASE("Parse JSON numbers in a locale with a decimal comma") {
+    // Checked only where such a locale is installed
+    const std::string prev = std::setlocale(LC_NUMERIC, nullptr);
+    bool              have_comma = false;
+    for (auto name : {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "German_Germany.1252"}) {
+        if (std::setlocale(LC_NUMERIC, name) && *std::localeconv()->decimal_point == ',') {
+            have_comma = true;
+            break;
+        }
+    }
+    if (have_comma) {
+        CHECK(semester::parse_json("1.5") == 1.5);
+        CHECK(semester::parse_json("-2.25e1") == -22.5);
+    }
+    std::setlocale(LC_NUMERIC, prev.c_str());
+}
+
+TEST_CASE("Parse JSON strings") {
+    CHECK(semester::parse_json(R"("tab\there")") == "tab\there");
+    CHECK(semester::parse_json(R"("\"quoted\" \\ \/")") == "\"quoted\" \\ /");
+    CHECK(semester::parse_json(R"("\u0041\u00e9\u20ac")") == "A\xc3\xa9\xe2\x82\xac");
+    CHECK(semester::parse_json(R"("\ud83d\ude00")") == "\xf0\x9f\x98\x80");
+    // Long enough to take the vectorized path, with escapes on either side of a block boundary
+    CHECK(semester::parse_json(R"("0123456789abcde\n0123456789abcdef\"0123456789")")
+          == "0123456789abcde\n0123456789abcdef\"0123456789");
+}
+
+TEST_CASE("Parse JSON containers") {
+    auto dat = semester::parse_json(R"(
+        {
+            "name": "semester",
+            "tags": ["json", "data", 3, null],
+            "nested": {"empty": {}, "list": []},
+            "name": "last one wins"
+        }
+    )");
+    REQUIRE(dat.is_mapping());
+    auto& map = dat.as_mapping();
+    CHECK(map.size() == 3);
+    CHECK(map.at("name") == "last one wins");
+    CHECK(map.at("tags")
+          == semester::json_data::array_type{"json", "data", 3, semester::null});
+    CHECK(map.at("nested").as_mapping().at("empty").as_mapping().empty());
+    CHECK(map.at("nested").as_mapping().at("list").as_array().empty());
+}
+
+TEST_CASE("Reject invalid JSON") {
+    auto check_error = [](std::string_view text, semester::json_errc ec) {
+        INFO("Parsing: " << text);
+        auto result = semester::try_parse_json(text);
+        CHECK_FALSE(result);
+        CHECK(result.error == ec);
+    };
+    using ec = semester::json_errc;
+    check_error("", ec::unexpected_end);
+    check_error("[1, 2", ec::unexpected_end);
+    check_error("[1 2]", ec::unexpected_character);
+    check_error("{\"a\" 1}", ec::unexpected_character);
+    check_error("{1: 2}", ec::unexpected_character);
+    check_error("tru", ec::unexpected_end);
+    check_error("nul1", ec::invalid_literal);
+    check_error("01", ec::trailing_characters);
+    check_error("1.", ec::unexpected_end);
+    check_error("1.e4", ec::invalid_number);
+    check_error("-", ec::unexpected_end);
+    check_error("\"abc", ec::unexpected_end);
+    check_error("\"a\\qb\"", ec::invalid_escape);
+    check_error("\"\\ud800\"", ec::invalid_unicode_escape);
+    check_error("\"a\nb\"", ec::control_character_in_string);
+    check_error("[] []", ec::trailing_characters);
+
+    auto deep = std::string(2000, '[') + std::string(2000, ']');
+    check_error(deep, ec::too_deep);
+    CHECK(semester::try_parse_json(deep, {.max_depth = 4000}));
+
+#if !SEMESTER_NO_EXCEPTIONS
+    CHECK_THROWS_AS(semester::parse_json("[1, 2,]"), semester::json_parse_error);
+#endif
+}
+
+TEST_CASE("Parse JSON into a memory resource") {
+    // The parsed document must not touch the default resource at all
+    auto prev_default = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+    alignas(std::max_align_t) char     buffer[16 * 1024];
+    std::pmr::monotonic_buffer_resource mr{buffer, sizeof buffer, std::pmr::null_memory_resource()};
+
+    auto dat = semester::parse_json<semester::json_pmr_data>(R"(
+        {
+            "name": "a string long enough to need a heap allocation",
+            "a key long enough to need a heap allocation": [
+                "json", {"nested": ["another string long enough to need a heap allocation"]}
+            ]
+        }
+    )",
+                                                             &mr);
+    std::pmr::set_default_resource(prev_default);
+
+    REQUIRE(dat.is_mapping());
+    auto& map = dat.as_mapping();
+    CHECK(map.at("name").as_string() == "a string long enough to need a heap allocation");
+    auto& arr = map.at("a key long enough to need a heap allocation").as_array();
+    REQUIRE(arr.size() == 2);
+    CHECK(arr[1].as_mapping().at("nested").as_array()[0].as_string().get_allocator().resource()
+          == &mr);
+
+#if !SEMESTER_NO_EXCEPTIONS
+    CHECK_THROWS_AS(semester::parse_json<semester::json_pmr_data>("[1, 2,]", &mr),
+                    semester::json_parse_error);
+#endif
+}
+
+TEST_CASE("Parse JSON with flat mappings") {
+    auto dat = semester::parse_json<semester::json_flat_data>(
+        R"({"b": 1, "a": {"y": [], "x": null}, "b": "last one wins"})");
+    auto& map = dat.as_mapping();
+    REQUIRE(map.size() == 2);
+    CHECK(map.begin()->first == "a");
+    CHECK(map.at("b") == "last one wins");
+    CHECK(map.at("a").as_mapping().at("x") == semester::null);
+
+    // Keys in reverse order are sorted once, rather than inserted one at a time
+    std::string text = "{";
+    for (int i = 20000; i > 0; --i) {
+        text += "\"" + std::to_string(100000 + i) + "\": " + std::to_string(i) + ",";
+    }
+    text += R"("100005": "again"})";
+    auto big = semester::parse_json<semester::json_flat_data>(text);
+    REQUIRE(big.as_mapping().size() == 20000);
+    CHECK(big.as_mapping().begin()->first == "100001");
+    CHECK(big.as_mapping().at("100005") == "again");
+    CHECK(big.as_mapping().at("120000") == 20000);
+}
+
+TEST_CASE("Parse JSON integers exactly") {
+    using semester::json_int_data;
+    auto dat = semester::parse_json<json_int_data>(
+        R"([9007199254740993, -9223372036854775808, 18446744073709551615, 18446744073709551616,
+            -0, 12, 1.5, 2e3])");
+    const auto& arr = dat.as_array();
+    REQUIRE(arr.size() == 8);
+    // Beyond 2^53, which a double would round
+    CHECK(arr[0].as_int64() == 9007199254740993);
+    CHECK(arr[1].as_int64() == (std::numeric_limits<std::int64_t>::min)());
+    CHECK(arr[2].as_uint64() == 18446744073709551615u);
+    // Too large for any integer type
+    CHECK(arr[3].as_double() == 18446744073709551616.0);
+    CHECK(arr[4].as_int64() == 0);
+    CHECK(arr[5] == 12);
+    CHECK(arr[6].as_double() == 1.5);
+    CHECK(arr[7].as_double() == 2000.0);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SEMESTER_JSON_SSE2 1
+#include <emmintrin.h>
+#else
+#define SEMESTER_JSON_SSE2 0
+#endif
+
+namespace semester::detail {
+
+constexpr bool is_json_ws(char c) noexcept {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+constexpr bool is_json_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+/**
+ * Return a pointer to the first non-whitespace character in [it, end). Short
+ * runs of whitespace are handled inline, while long runs (e.g. indentation in
+ * pretty-printed documents) are skipped sixteen bytes at a time.
+ */
+inline const char* skip_json_ws(const char* it, const char* end) noexcept {
+    if (it == end || !is_json_ws(*it)) {
+        return it;
+    }
+#if SEMESTER_JSON_SSE2
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i nl    = _mm_set1_epi8('\n');
+    const __m128i cr    = _mm_set1_epi8('\r');
+    const __m128i tab   = _mm_set1_epi8('\t');
+    while (end - it >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const __m128i ws    = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                                                      _mm_cmpeq_epi8(chunk, nl)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(chunk, cr),
+                                                     _mm_cmpeq_epi8(chunk, tab)));
+        const auto not_ws = ~static_cast<unsigned>(_mm_movemask_epi8(ws)) & 0xffffu;
+        if (not_ws) {
+            return it + std::countr_zero(not_ws);
+        }
+        it += 16;
+    }
+#endif
+    while (it != end && is_json_ws(*it)) {
+        ++it;
+    }
+    return it;
+}
+
+/**
+ * Return a pointer to the first character in [it, end) that cannot be copied
+ * verbatim from the body of a JSON string: a quote, a backslash, or a control
+ * character. Returns `end` if there is no such character.
+ */
+inline const char* find_json_string_special(const char* it, const char* end) noexcept {
+#if SEMESTER_JSON_SSE2
+    const __m128i quote  = _mm_set1_epi8('"');
+    const __m128i bslash = _mm_set1_epi8('\\');
+    const __m128i ctl    = _mm_set1_epi8(0x1f);
+    while (end - it >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        // Unsigned "c <= 0x1f" is "max(c, 0x1f) == 0x1f"
+        const __m128i is_ctl  = _mm_cmpeq_epi8(_mm_max_epu8(chunk, ctl), ctl);
+        const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                          _mm_cmpeq_epi8(chunk, bslash)),
+                                             is_ctl);
+        const auto mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+        if (mask) {
+            return it + std::countr_zero(mask);
+        }
+        it += 16;
+    }
+#endif
+    for (; it != end; ++it) {
+        const auto c = static_cast<unsigned char>(*it);
+        if (c == '"' || c == '\\' || c < 0x20) {
+            break;
+        }
+    }
+    return it;
+}
+
+}  // namespace semester::detail
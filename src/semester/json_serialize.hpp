@@ -0,0 +1,261 @@
+#pragma once
+
+#include <semester/config.hpp>
+#include <semester/data.hpp>
+#include <semester/json.hpp>
+#include <semester/json_parse.hpp>
+#include <semester/json_scan.hpp>
+#include <semester/sink.hpp>
+
+#include <neo/declval.hpp>
+#include <neo/fwd.hpp>
+
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace semester {
+
+/**
+ * Options to control JSON serialization.
+ */
+struct json_write_options {
+    /// If `true`, emit newlines and indentation between elements
+    bool pretty = false;
+    /// The number of spaces per level of indentation when `pretty` is set
+    std::size_t indent = 4;
+};
+
+namespace detail {
+
+// clang-format off
+template <typename T, typename Data>
+concept json_array_like =
+    std::same_as<std::remove_cvref_t<decltype(*std::begin(NEO_DECLVAL(const T&)))>, Data>;
+
+template <typename T, typename Data>
+concept json_mapping_like = requires(const T& map) {
+    { std::begin(map)->first } -> std::convertible_to<std::string_view>;
+    { std::begin(map)->second } -> std::convertible_to<const Data&>;
+};
+// clang-format on
+
+/**
+ * Write the body of a JSON string (including the quotes), escaping as needed.
+ * Runs of characters that need no escaping are located sixteen bytes at a time
+ * and copied in bulk.
+ */
+template <typename Writer>
+void write_json_string(Writer& out, std::string_view str) {
+    out.put('"');
+    const char* it  = str.data();
+    const char* end = it + str.size();
+    while (true) {
+        const char* special = find_json_string_special(it, end);
+        out.write(it, static_cast<std::size_t>(special - it));
+        if (special == end) {
+            break;
+        }
+        const auto c = static_cast<unsigned char>(*special);
+        switch (c) {
+        case '"':
+            out.write("\\\"", 2);
+            break;
+        case '\\':
+            out.write("\\\\", 2);
+            break;
+        case '\b':
+            out.write("\\b", 2);
+            break;
+        case '\f':
+            out.write("\\f", 2);
+            break;
+        case '\n':
+            out.write("\\n", 2);
+            break;
+        case '\r':
+            out.write("\\r", 2);
+            break;
+        case '\t':
+            out.write("\\t", 2);
+            break;
+        default: {
+            constexpr const char hex[] = "0123456789abcdef";
+            const char           esc[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+            out.write(esc, sizeof esc);
+        }
+        }
+        it = special + 1;
+    }
+    out.put('"');
+}
+
+#if !SEMESTER_HAVE_FLOAT_CHARCONV
+/**
+ * Format a finite number into `buf` as the "C" locale would, with the fewest
+ * significant digits that read back as the same value. Returns the length.
+ */
+template <typename Float>
+std::size_t format_json_float(char* buf, std::size_t size, Float f) noexcept {
+    using limits = std::numeric_limits<Float>;
+    // A normal value that can be written in digits10 significant digits is
+    // written exactly that way by %g at that precision, with the trailing
+    // zeros removed. Only a subnormal value may need fewer digits than that.
+    int prec = std::fabs(f) < (limits::min)() ? 1 : limits::digits10;
+    for (;; ++prec) {
+        const auto n = std::snprintf(buf, size, "%.*g", prec, static_cast<double>(f));
+        // %g writes only digits, signs, and the exponent, apart from the
+        // decimal point of the locale, which may be several characters
+        std::size_t len      = 0;
+        bool        in_point = false;
+        for (const char c : std::string_view(buf, static_cast<std::size_t>(n))) {
+            const bool plain = is_json_digit(c) || c == '-' || c == '+' || c == 'e';
+            if (plain || !in_point) {
+                buf[len++] = plain ? c : '.';
+            }
+            in_point = !plain;
+        }
+        buf[len] = 0;
+        if (prec >= limits::max_digits10 || static_cast<Float>(strtod_c_locale(buf)) == f) {
+            return len;
+        }
+    }
+}
+#endif
+
+/**
+ * Write a number in its shortest round-trip representation. Non-finite values
+ * cannot be represented in JSON, and are written as `null`. The output does not
+ * depend on the locale.
+ */
+template <typename Writer, typename Number>
+void write_json_number(Writer& out, Number n) {
+    constexpr std::size_t max_len = 32;
+    if constexpr (std::is_floating_point_v<Number>) {
+        if (!std::isfinite(n)) {
+            out.write("null", 4);
+            return;
+        }
+    }
+    char* buf = out.reserve(max_len);
+#if SEMESTER_HAVE_FLOAT_CHARCONV
+    const auto res = std::to_chars(buf, buf + max_len, n);
+    out.commit(static_cast<std::size_t>(res.ptr - buf));
+#else
+    if constexpr (std::is_floating_point_v<Number>) {
+        using float_type = std::conditional_t<std::is_same_v<Number, float>, float, double>;
+        out.commit(format_json_float(buf, max_len, static_cast<float_type>(n)));
+    } else {
+        const auto res = std::to_chars(buf, buf + max_len, n);
+        out.commit(static_cast<std::size_t>(res.ptr - buf));
+    }
+#endif
+}
+
+template <typename Writer>
+class json_serializer {
+    Writer&            _out;
+    json_write_options _opts;
+
+    void _newline(std::size_t depth) {
+        if (_opts.pretty) {
+            _out.put('\n');
+            auto n_spaces = depth * _opts.indent;
+            while (n_spaces) {
+                constexpr std::string_view spaces = "                                ";
+                const auto                 n      = (std::min)(n_spaces, spaces.size());
+                _out.write(spaces.data(), n);
+                n_spaces -= n;
+            }
+        }
+    }
+
+public:
+    json_serializer(Writer& out, json_write_options opts) noexcept
+        : _out(out)
+        , _opts(opts) {}
+
+    template <typename Data>
+    void value(const Data& dat, std::size_t depth) {
+        dat.visit([&](const auto& item) { this->item<Data>(item, depth); });
+    }
+
+    template <typename Data, typename T>
+    void item(const T& item, std::size_t depth) {
+        if constexpr (std::same_as<T, null_t>) {
+            _out.write("null", 4);
+        } else if constexpr (std::same_as<T, bool>) {
+            item ? _out.write("true", 4) : _out.write("false", 5);
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            write_json_number(_out, item);
+        } else if constexpr (std::convertible_to<const T&, std::string_view>) {
+            write_json_string(_out, std::string_view(item));
+        } else if constexpr (json_mapping_like<T, Data>) {
+            _out.put('{');
+            bool first = true;
+            for (const auto& [key, child] : item) {
+                if (!first) {
+                    _out.put(',');
+                }
+                first = false;
+                _newline(depth + 1);
+                write_json_string(_out, std::string_view(key));
+                _opts.pretty ? _out.write(": ", 2) : _out.put(':');
+                value(child, depth + 1);
+            }
+            if (!first) {
+                _newline(depth);
+            }
+            _out.put('}');
+        } else if constexpr (json_array_like<T, Data>) {
+            _out.put('[');
+            bool first = true;
+            for (const auto& child : item) {
+                if (!first) {
+                    _out.put(',');
+                }
+                first = false;
+                _newline(depth + 1);
+                value(child, depth + 1);
+            }
+            if (!first) {
+                _newline(depth);
+            }
+            _out.put(']');
+        } else {
+            static_assert(std::is_void_v<T>, "No JSON representation for this data alternative");
+        }
+    }
+};
+
+}  // namespace detail
+
+/**
+ * Write the given data as JSON text into the given output sink. Output is
+ * collected in a large buffer and passed to the sink in chunks.
+ */
+template <typename Data, output_sink Sink>
+void write_json(const Data& dat, Sink&& sink, json_write_options opts = {}) {
+    buffered_writer<Sink&> out{sink};
+    detail::json_serializer ser{out, opts};
+    ser.value(dat, 0);
+    out.flush();
+}
+
+/**
+ * Serialize the given data as a JSON string.
+ */
+template <typename Data>
+std::string to_json_string(const Data& dat, json_write_options opts = {}) {
+    std::string str;
+    write_json(dat, string_sink{str}, opts);
+    return str;
+}
+
+}  // namespace semester
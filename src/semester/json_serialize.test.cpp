@@ -0,0 +1,91 @@
+#include <semester/json_serialize.hpp>
+
+#include <semester/json_parse.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <clocale>
+#include <string>
+
+TEST_CASE("Serialize JSON scalars") {
+    CHECK(semester::to_json_string(semester::json_data()) == "null");
+    CHECK(semester::to_json_string(semester::json_data(true)) == "true");
+    CHECK(semester::to_json_string(semester::json_data(false)) == "false");
+    CHECK(semester::to_json_string(semester::json_data(42)) == "42");
+    CHECK(semester::to_json_string(semester::json_data(0.1)) == "0.1");
+    CHECK(semester::to_json_string(semester::json_data(-1.5e300)) == "-1.5e+300");
+    CHECK(semester::to_json_string(semester::json_data(1.0 / 0.0)) == "null");
+    CHECK(semester::to_json_string(semester::json_data("plain")) == "\"plain\"");
+}
+
+TEST_CASE("Serialize JSON numbers in their shortest form") {
+    auto json = [](double d) { return semester::to_json_string(semester::json_data(d)); };
+    CHECK(json(0.1 + 0.2) == "0.30000000000000004");
+    CHECK(json(123456.789) == "123456.789");
+    CHECK(json(-0.0) == "-0");
+    CHECK(json(5e-324) == "5e-324");
+    CHECK(json(1.7976931348623157e308) == "1.7976931348623157e+308");
+}
+
+TEST_CASE("Serialize JSON numbers in a locale with a decimal comma") {
+    // Checked only where such a locale is installed
+    const std::string prev = std::setlocale(LC_NUMERIC, nullptr);
+    bool              have_comma = false;
+    for (auto name : {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "German_Germany.1252"}) {
+        if (std::setlocale(LC_NUMERIC, name) && *std::localeconv()->decimal_point == ',') {
+            have_comma = true;
+            break;
+        }
+    }
+    if (have_comma) {
+        CHECK(semester::to_json_string(semester::json_data(1.5)) == "1.5");
+        CHECK(semester::to_json_string(semester::json_data(-2.5e-10)) == "-2.5e-10");
+    }
+    std::setlocale(LC_NUMERIC, prev.c_str());
+}
+
+TEST_CASE("Serialize JSON strings with escapes") {
+    semester::json_data dat = "quote\" backslash\\ newline\n tab\t bell\x07 long enough for SIMD";
+    CHECK(semester::to_json_string(dat)
+          == R"("quote\" backslash\\ newline\n tab\t bell\u0007 long enough for SIMD")");
+    // Escaped output parses back to the same string
+    CHECK(semester::parse_json(semester::to_json_string(dat)) == dat);
+}
+
+TEST_CASE("Serialize JSON containers") {
+    semester::json_data dat = semester::json_data::mapping_type{
+        {"name", "semester"},
+        {"tags", semester::json_data::array_type{"a", 2, semester::null}},
+        {"empty", semester::empty_mapping},
+        {"list", semester::empty_array},
+    };
+    CHECK(semester::to_json_string(dat)
+          == R"({"empty":{},"list":[],"name":"semester","tags":["a",2,null]})");
+    CHECK(semester::to_json_string(dat, {.pretty = true, .indent = 2}) == R"({
+  "empty": {},
+  "list": [],
+  "name": "semester",
+  "tags": [
+    "a",
+    2,
+    null
+  ]
+})");
+    CHECK(semester::parse_json(semester::to_json_string(dat, {.pretty = true})) == dat);
+}
+
+TEST_CASE("Serialize into a fixed buffer") {
+    semester::json_data dat = semester::json_data::array_type{1, 2, 3};
+
+    char                  big[64];
+    semester::buffer_sink sink{big, sizeof big};
+    semester::write_json(dat, sink);
+    CHECK(sink.view() == "[1,2,3]");
+    CHECK_FALSE(sink.truncated());
+
+    char                  small[4];
+    semester::buffer_sink small_sink{small, sizeof small};
+    semester::write_json(dat, small_sink);
+    CHECK(small_sink.view() == "[1,2");
+    CHECK(small_sink.truncated());
+}
@@ -0,0 +1,371 @@
+#pragma once
+
+#include <semester/config.hpp>
+#include <semester/data.hpp>
+#include <semester/get.hpp>
+#include <semester/json_parse.hpp>
+
+#include <neo/concepts.hpp>
+
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace semester {
+
+/**
+ * A read-only handle to a single value within a buffer of JSON text. No tree
+ * is built: scalars are decoded when they are requested with try_get(), and
+ * the `mapping_type` and `array_type` of a json_text are views that scan their
+ * members from the text as they are iterated.
+ *
+ * This supports the same try_get() protocol as basic_data, so the walk_ops can
+ * run directly over JSON text. Memory use is bounded by the nesting depth of
+ * the walk. Scalars are validated when they are reached, and containers are
+ * validated as they are iterated or skipped; malformed text is reported by
+ * throwing a json_parse_error. A walk that does not visit all of the document
+ * can be followed by validate() to check the rest of it.
+ *
+ * A json_text for a member of a container is only valid while the iteration
+ * of that container is positioned on the member. The mapping and array views
+ * of the root value record its end in the root json_text, so it must outlive
+ * them. The JSON text must outlive every json_text that refers to it.
+ */
+class json_text {
+public:
+    class mapping_type;
+    class array_type;
+
+    using null_type   = null_t;
+    using bool_type   = bool;
+    using number_type = double;
+    using string_type = std::string;
+
+private:
+    template <bool Keyed>
+    class _member_iterator;
+
+    /// The beginning of the document, used to report error offsets
+    const char* _doc;
+    /// The end of the document
+    const char* _end;
+    /// The first character of this value
+    const char* _pos;
+    /// Once a container has been iterated, its end position is recorded here so
+    /// that the enclosing container does not need to scan it again.
+    const char** _end_slot = nullptr;
+    /// The end slot of the root value
+    const char* _root_end = nullptr;
+    /// Whether this is the root value, which may only be followed by whitespace
+    bool _root = false;
+
+    json_text(const char*  doc,
+              const char*  end,
+              const char*  pos,
+              const char** slot,
+              bool         root = false) noexcept
+        : _doc(doc)
+        , _end(end)
+        , _pos(pos)
+        , _end_slot(slot)
+        , _root(root) {}
+
+    /// A handle to the same value, which shares our end slot rather than copying it
+    json_text _view() const noexcept { return json_text{_doc, _end, _pos, _end_slot, _root}; }
+
+    [[noreturn]] static void _throw(const detail::json_cursor& cur) {
+        SEMESTER_THROW(json_parse_error(cur.error, cur.offset()));
+    }
+
+    /**
+     * Check the value beginning at `pos`. If it is a scalar, validate it and
+     * return its end. If it is a container, return null.
+     */
+    static const char* _check_value(const char* doc, const char* pos, const char* end) {
+        detail::json_cursor cur{doc, pos, end};
+        if (pos != end && (*pos == '{' || *pos == '[')) {
+            return nullptr;
+        }
+        if (!cur.skip_value(0, 0)) {
+            _throw(cur);
+        }
+        return cur.position();
+    }
+
+    /// Validate and skip the value at `pos`, returning its end
+    static const char* _skip_value(const char* doc, const char* pos, const char* end) {
+        detail::json_cursor cur{doc, pos, end};
+        if (!cur.skip_value(0, json_parse_options{}.max_depth)) {
+            _throw(cur);
+        }
+        return cur.position();
+    }
+
+    /// Check that only whitespace follows the root value, which ends at `pos`
+    static void _check_trailing(const char* doc, const char* pos, const char* end) {
+        detail::json_cursor cur{doc, pos, end};
+        if (!cur.expect_end()) {
+            _throw(cur);
+        }
+    }
+
+    /// The end of this value, which is scanned if it is not yet known
+    const char* _stop() const {
+        return _end_slot && *_end_slot ? *_end_slot : _skip_value(_doc, _pos, _end);
+    }
+
+    char _first() const noexcept { return *_pos; }
+
+public:
+    /**
+     * Create a handle to the JSON value contained in `text`. If the value is a
+     * scalar, it is validated immediately, along with the text that follows
+     * it. A container is validated when it is iterated, or by validate().
+     */
+    explicit json_text(std::string_view text)
+        : _doc(text.data())
+        , _end(text.data() + text.size())
+        , _pos(detail::skip_json_ws(_doc, _end))
+        , _end_slot(&_root_end)
+        , _root(true) {
+        _root_end = _check_value(_doc, _pos, _end);
+        if (_root_end) {
+            _check_trailing(_doc, _root_end, _end);
+        }
+    }
+
+    json_text(const json_text& other) noexcept
+        : _doc(other._doc)
+        , _end(other._end)
+        , _pos(other._pos)
+        , _end_slot(other._end_slot == &other._root_end ? &_root_end : other._end_slot)
+        , _root_end(other._root_end)
+        , _root(other._root) {}
+
+    json_text& operator=(const json_text& other) noexcept {
+        _doc      = other._doc;
+        _end      = other._end;
+        _pos      = other._pos;
+        _end_slot = other._end_slot == &other._root_end ? &_root_end : other._end_slot;
+        _root_end = other._root_end;
+        _root     = other._root;
+        return *this;
+    }
+
+    constexpr static bool supports_mappings = true;
+    constexpr static bool supports_arrays   = true;
+
+    bool is_null() const noexcept { return _first() == 'n'; }
+    bool is_bool() const noexcept { return _first() == 't' || _first() == 'f'; }
+    bool is_string() const noexcept { return _first() == '"'; }
+    bool is_mapping() const noexcept { return _first() == '{'; }
+    bool is_array() const noexcept { return _first() == '['; }
+    bool is_number() const noexcept { return _first() == '-' || detail::is_json_digit(_first()); }
+
+    /// The offset of this value from the beginning of the document
+    std::size_t offset() const noexcept { return static_cast<std::size_t>(_pos - _doc); }
+
+    /**
+     * Get the text of this value. For a container, this validates and scans the
+     * entire container.
+     */
+    std::string_view raw() const {
+        const char* stop = _stop();
+        return std::string_view(_pos, static_cast<std::size_t>(stop - _pos));
+    }
+
+    /**
+     * Validate all of this value, including the parts that were not iterated.
+     * For the root value, also check that only whitespace follows it. Use this
+     * when a walk may stop before it reaches the end of the document.
+     */
+    void validate() const {
+        const char* stop = _stop();
+        if (_root) {
+            _check_trailing(_doc, stop, _end);
+        }
+    }
+
+    // clang-format off
+    template <typename T>
+        requires (neo::same_as<T, null_type>   ||
+                  neo::same_as<T, bool_type>   ||
+                  neo::same_as<T, number_type> ||
+                  neo::same_as<T, string_type> ||
+                  neo::same_as<T, mapping_type> ||
+                  neo::same_as<T, array_type>)
+    value_holder<T> try_get() const {
+        // clang-format on
+        if constexpr (neo::same_as<T, null_type>) {
+            return is_null() ? value_holder<T>(null) : std::nullopt;
+        } else if constexpr (neo::same_as<T, bool_type>) {
+            return is_bool() ? value_holder<T>(_first() == 't') : std::nullopt;
+        } else if constexpr (neo::same_as<T, number_type>) {
+            if (!is_number()) {
+                return std::nullopt;
+            }
+            // The number was validated when this handle was created
+            detail::json_cursor cur{_doc, _pos, _end};
+            number_type         n = 0;
+            cur.parse_number(n);
+            return value_holder<T>(std::move(n));
+        } else if constexpr (neo::same_as<T, string_type>) {
+            if (!is_string()) {
+                return std::nullopt;
+            }
+            detail::json_cursor cur{_doc, _pos, _end};
+            string_type         str;
+            cur.parse_string(str);
+            return value_holder<T>(std::move(str));
+        } else {
+            if (_first() != (neo::same_as<T, mapping_type> ? '{' : '[')) {
+                return std::nullopt;
+            }
+            return value_holder<T>(T(*this));
+        }
+    }
+};
+
+/**
+ * Iterates the members of an object or the elements of an array in JSON text.
+ */
+template <bool Keyed>
+class json_text::_member_iterator {
+    const char* _doc;
+    const char* _end;
+    /// The first character of the current member value, or null at the end
+    const char* _pos = nullptr;
+    /// The end of the current member value, if known
+    mutable const char* _value_end = nullptr;
+    /// Where to record the end of the container when iteration finishes
+    const char** _done_slot;
+    /// Whether the container is the root value
+    bool _root;
+
+    std::string_view _key;
+    std::string      _key_buf;
+
+    [[noreturn]] void _throw(detail::json_cursor& cur) const { json_text::_throw(cur); }
+
+    void _finish(const detail::json_cursor& cur) {
+        _pos = nullptr;
+        if (_done_slot) {
+            *_done_slot = cur.position();
+        }
+        if (_root) {
+            json_text::_check_trailing(_doc, cur.position(), _end);
+        }
+    }
+
+    /// Read the member at the cursor. The cursor must be at the first non-ws char
+    void _read_member(detail::json_cursor& cur) {
+        if constexpr (Keyed) {
+            const char* quote = cur.position();
+            if (quote == _end || *quote != '"') {
+                cur.expect('"');
+                _throw(cur);
+            }
+            const char* special = detail::find_json_string_special(quote + 1, _end);
+            if (special != _end && *special == '"') {
+                // Fast path: No escapes, so the key can refer to the text directly
+                _key = std::string_view(quote + 1, static_cast<std::size_t>(special - quote - 1));
+                cur  = detail::json_cursor{_doc, special + 1, _end};
+            } else {
+                _key_buf.clear();
+                if (!cur.parse_string(_key_buf)) {
+                    _throw(cur);
+                }
+                _key = _key_buf;
+            }
+            cur.skip_ws();
+            if (!cur.expect(':')) {
+                _throw(cur);
+            }
+            cur.skip_ws();
+        }
+        _pos       = cur.position();
+        _value_end = json_text::_check_value(_doc, _pos, _end);
+    }
+
+public:
+    explicit _member_iterator(const json_text& container)
+        : _doc(container._doc)
+        , _end(container._end)
+        , _done_slot(container._end_slot)
+        , _root(container._root) {
+        detail::json_cursor cur{_doc, container._pos + 1, _end};
+        cur.skip_ws();
+        if (cur.consume(Keyed ? '}' : ']')) {
+            _finish(cur);
+        } else {
+            _read_member(cur);
+        }
+    }
+
+    _member_iterator(const _member_iterator&) = delete;
+    _member_iterator& operator=(const _member_iterator&) = delete;
+
+    auto operator*() const noexcept {
+        json_text value{_doc, _end, _pos, &_value_end};
+        if constexpr (Keyed) {
+            return std::pair<std::string_view, json_text>(_key, value);
+        } else {
+            return value;
+        }
+    }
+
+    _member_iterator& operator++() {
+        const char* after = _value_end ? _value_end : json_text::_skip_value(_doc, _pos, _end);
+        detail::json_cursor cur{_doc, after, _end};
+        cur.skip_ws();
+        if (cur.consume(Keyed ? '}' : ']')) {
+            _finish(cur);
+            return *this;
+        }
+        if (!cur.expect(',')) {
+            _throw(cur);
+        }
+        cur.skip_ws();
+        _read_member(cur);
+        return *this;
+    }
+
+    bool operator==(std::default_sentinel_t) const noexcept { return _pos == nullptr; }
+};
+
+/**
+ * A view of the members of a JSON object. Iterating yields pairs of the key and
+ * a json_text for the value. Keys remain valid until the iterator advances.
+ */
+class json_text::mapping_type {
+    json_text _node;
+
+public:
+    using iterator = json_text::_member_iterator<true>;
+
+    explicit mapping_type(const json_text& node) noexcept
+        : _node(node._view()) {}
+
+    iterator                begin() const { return iterator(_node); }
+    std::default_sentinel_t end() const noexcept { return {}; }
+};
+
+/**
+ * A view of the elements of a JSON array. Iterating yields a json_text for each
+ * element.
+ */
+class json_text::array_type {
+    json_text _node;
+
+public:
+    using iterator = json_text::_member_iterator<false>;
+
+    explicit array_type(const json_text& node) noexcept
+        : _node(node._view()) {}
+
+    iterator                begin() const { return iterator(_node); }
+    std::default_sentinel_t end() const noexcept { return {}; }
+};
+
+}  // namespace semester
@@ -0,0 +1,122 @@
+#include <semester/json_text.hpp>
+
+#include <semester/walk.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <neo/test_concept.hpp>
+
+NEO_TEST_CONCEPT(semester::supports_mappings<semester::json_text>);
+NEO_TEST_CONCEPT(semester::supports_arrays<semester::json_text>);
+NEO_TEST_CONCEPT(semester::supports_try_get<semester::json_text, std::string>);
+
+TEST_CASE("Query scalars in JSON text") {
+    semester::json_text str{R"(  "I am \"quoted\""  )"};
+    CHECK(str.is_string());
+    CHECK(semester::get<std::string>(str) == "I am \"quoted\"");
+    CHECK_FALSE(semester::holds_alternative<double>(str));
+
+    CHECK(semester::get<double>(semester::json_text{"-12.5"}) == -12.5);
+    CHECK(semester::get<bool>(semester::json_text{"true"}));
+    CHECK(semester::holds_alternative<semester::null_t>(semester::json_text{"null"}));
+
+#if !SEMESTER_NO_EXCEPTIONS
+    CHECK_THROWS_AS(semester::json_text{"nope"}, semester::json_parse_error);
+    CHECK_THROWS_AS(semester::json_text{"\"unterminated"}, semester::json_parse_error);
+    CHECK_THROWS_AS(semester::json_text{""}, semester::json_parse_error);
+    CHECK_THROWS_AS(semester::json_text{"1 garbage"}, semester::json_parse_error);
+#endif
+    CHECK(semester::get<double>(semester::json_text{" 1 \n"}) == 1);
+}
+
+TEST_CASE("Walk a mapping in JSON text") {
+    semester::json_text text{R"({
+        "foo": "bar",
+        "nested": {"a": [1, 2, {"deep": [[], {}]}], "b!": "escaped key"},
+        "baz": 33
+    })"};
+
+    using namespace semester::walk_ops;
+    std::string foo_string;
+    double      baz_value = 0;
+    std::string escaped;
+    semester::walk(text,
+                   mapping{
+                       if_key{"foo", put_into(foo_string)},
+                       if_key{"nested",
+                              mapping{
+                                  if_key{"b!", put_into(escaped)},
+                                  if_key{"a", just_accept},
+                              }},
+                       if_key{"baz", put_into(baz_value)},
+                   });
+    CHECK(foo_string == "bar");
+    CHECK(baz_value == 33.0);
+    CHECK(escaped == "escaped key");
+
+    auto result = semester::walk.try_walk(  //
+        text,
+        mapping{
+            if_key{"foo", just_accept},
+            if_key{"nested", just_accept},
+            required_key{"quux", "'quux' is required", just_accept},
+            if_key{"baz", just_accept},
+        });
+    CHECK(result.rejected());
+
+    CHECK(text.raw().front() == '{');
+    CHECK(text.raw().back() == '}');
+}
+
+TEST_CASE("Walk an array in JSON text") {
+    semester::json_text text{R"(["string 1", 55, "string 2", [8, [9]], 10])"};
+
+    std::vector<std::string> strings;
+    std::vector<double>      numbers;
+    using namespace semester::walk_ops;
+    auto visit_number = if_type<double>(put_into(std::back_inserter(numbers)));
+    semester::walk(text,
+                   for_each{
+                       if_type<std::string>(put_into{std::back_inserter(strings)}),
+                       visit_number,
+                       if_array(for_each{visit_number, if_array(for_each{visit_number})}),
+                   });
+    CHECK(strings == (std::vector<std::string>{"string 1", "string 2"}));
+    CHECK(numbers == (std::vector<double>{55, 8, 9, 10}));
+}
+
+// Malformed text can only be reported by throwing
+#if !SEMESTER_NO_EXCEPTIONS
+TEST_CASE("Malformed JSON text is reported during the walk") {
+    using namespace semester::walk_ops;
+    semester::json_text text{R"({"ok": 1, "bad": [1, 2,], "after": 2})"};
+    auto walker = mapping{if_key{"ok", just_accept}, if_key{"bad", just_accept}};
+    CHECK_THROWS_AS(semester::walk(text, walker), semester::json_parse_error);
+
+    semester::json_text bad_scalar{R"([1, 2, tru])"};
+    CHECK_THROWS_AS(semester::walk(bad_scalar, for_each{just_accept}), semester::json_parse_error);
+}
+
+TEST_CASE("Reject text that follows the root value") {
+    using namespace semester::walk_ops;
+    semester::json_text text{R"({"a": 1} ]]])"};
+    auto walker = mapping{if_key{"a", just_accept}};
+    CHECK_THROWS_AS(semester::walk(text, walker), semester::json_parse_error);
+
+    // A walk that does not iterate the root does not see the text that follows
+    // it, so it must be validated separately
+    semester::walk(text, just_accept);
+    CHECK_THROWS_AS(text.validate(), semester::json_parse_error);
+
+    semester::json_text bad_member{R"({"a": 1, "b": [1, 2,]})"};
+    semester::walk(bad_member, just_accept);
+    CHECK_THROWS_AS(bad_member.validate(), semester::json_parse_error);
+
+    semester::json_text good{" [1, [2, 3]]\n"};
+    semester::walk(good, for_each{just_accept});
+    CHECK_NOTHROW(good.validate());
+    semester::json_text copy = good;
+    CHECK(copy.raw() == "[1, [2, 3]]");
+    CHECK_NOTHROW(copy.validate());
+}
+#endif
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <semester/config.hpp>
+#include <semester/data.hpp>
+#include <semester/json_parse.hpp>
+
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace semester {
+
+/**
+ * Traits for JSON-style data whose strings and mapping keys are
+ * std::string_views. Parsed strings refer into the JSON text, so parsing only
+ * allocates for the containers, and for strings that contained escapes.
+ *
+ * The data does not own its strings: the text (and the storage for any decoded
+ * strings) must outlive the data. A json_view_document manages both.
+ */
+struct json_view_traits {
+    template <typename Data>
+    struct traits {
+        using null_type   = semester::null_t;
+        using bool_type   = bool;
+        using number_type = double;
+        using string_type = std::string_view;
+
+        using array_type   = std::vector<Data>;
+        using mapping_type = std::map<string_type, Data, std::less<>>;
+
+        using variant_type = std::variant<  //
+            null_type,                      //
+            string_type,                    //
+            number_type,                    //
+            bool_type,                      //
+            array_type,                     //
+            mapping_type                    //
+            >;
+
+        static null_type   convert(decltype(nullptr)) { return null; }
+        static bool_type   convert(bool b) { return b; }
+        static number_type convert(number_type n) { return n; }
+        static number_type convert(int n) { return n; }
+        static string_type convert(const char* s) { return s; }
+    };
+};
+
+/**
+ * JSON data with non-owning strings. See json_view_traits.
+ */
+using json_view_data = basic_data<json_view_traits>;
+
+/**
+ * Parse JSON text into data whose strings refer to `text`. Strings that contain
+ * escapes are decoded into memory obtained from `strings`. Both `text` and
+ * `strings` must outlive the returned data.
+ */
+template <json_view_strings Data = json_view_data>
+json_parse_result<Data> try_parse_json_view(std::string_view           text,
+                                            std::pmr::memory_resource& strings,
+                                            json_parse_options         opts = {}) {
+    json_parse_result<Data>   ret;
+    detail::json_parser<Data> parser{text, opts, strings};
+    if (!parser.parse_document(ret.value)) {
+        ret.error  = parser.error;
+        ret.offset = parser.offset();
+    }
+    return ret;
+}
+
+/**
+ * A parsed JSON document that owns its text. The strings of the data refer into
+ * the text, so the document must outlive any references to its data. Moving the
+ * document does not invalidate the data.
+ */
+class json_view_document {
+    struct _storage {
+        std::string                         text;
+        std::pmr::monotonic_buffer_resource strings;
+    };
+
+    std::unique_ptr<_storage> _store;
+    json_view_data            _root;
+
+public:
+    /**
+     * Parse the given JSON text. Throws json_parse_error if it is not valid JSON.
+     */
+    explicit json_view_document(std::string text, json_parse_options opts = {})
+        : _store(std::make_unique<_storage>()) {
+        _store->text = std::move(text);
+        auto result = try_parse_json_view(_store->text, _store->strings, opts);
+        if (!result) {
+            SEMESTER_THROW(json_parse_error(result.error, result.offset));
+        }
+        _root = std::move(result.value);
+    }
+
+    /// The root value of the document
+    const json_view_data& root() const noexcept { return _root; }
+    /// The JSON text of the document
+    std::string_view text() const noexcept { return _store->text; }
+};
+
+}  // namespace semester
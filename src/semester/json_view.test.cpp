@@ -0,0 +1,56 @@
+#include <semester/json_view.hpp>
+
+#include <semester/json_serialize.hpp>
+#include <semester/walk.hpp>
+
+#include <catch2/catch.hpp>
+
+TEST_CASE("Parse JSON into string views") {
+    std::string text = R"({"plain": "no escapes", "escaped": "tab\there", "list": ["a", "é"]})";
+    std::pmr::monotonic_buffer_resource strings;
+
+    auto result = semester::try_parse_json_view(text, strings);
+    REQUIRE(result);
+    auto& map = result.value.as_mapping();
+
+    // Strings without escapes refer directly into the text
+    auto plain = map.at("plain").as_string();
+    CHECK(plain == "no escapes");
+    CHECK(plain.data() >= text.data());
+    CHECK(plain.data() < text.data() + text.size());
+    CHECK(map.find("plain")->first.data() > text.data());
+
+    CHECK(map.at("escaped").as_string() == "tab\there");
+    CHECK(map.at("list").as_array()[1] == "\xc3\xa9");
+    CHECK(semester::get<std::string_view>(map.at("list").as_array()[0]) == "a");
+
+    CHECK_FALSE(semester::try_parse_json_view("[\"a\\q\"]", strings));
+}
+
+TEST_CASE("Own JSON text with a json_view_document") {
+    std::optional<semester::json_view_document> doc;
+    {
+        std::string text = R"({"name": "semester", "quoted": "\"hi\"", "n": 4})";
+        doc.emplace(std::move(text));
+    }
+    auto moved = std::move(*doc);
+    doc.reset();
+
+    std::string_view name;
+    std::string_view quoted;
+    using namespace semester::walk_ops;
+    semester::walk(moved.root(),
+                   mapping{
+                       if_key{"name", put_into(name)},
+                       if_key{"quoted", put_into(quoted)},
+                       if_key{"n", just_accept},
+                   });
+    CHECK(name == "semester");
+    CHECK(quoted == "\"hi\"");
+    CHECK(semester::to_json_string(moved.root())
+          == R"({"n":4,"name":"semester","quoted":"\"hi\""})");
+
+#if !SEMESTER_NO_EXCEPTIONS
+    CHECK_THROWS_AS(semester::json_view_document("[1, 2,]"), semester::json_parse_error);
+#endif
+}
@@ -0,0 +1,366 @@
+#pragma once
+
+#include <semester/config.hpp>
+#include <semester/data.hpp>
+#include <semester/get.hpp>
+#include <semester/json_parse.hpp>
+
+#include <neo/concepts.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace semester {
+
+namespace detail {
+
+/**
+ * The structural record of an array or object in a lazy_json_document. Spans
+ * are stored in document order, so the containers nested within the container
+ * of span `n` are the `n_nested` spans that follow it.
+ */
+struct lazy_json_span {
+    /// One past the closing bracket of the container
+    const char* end = nullptr;
+    /// The number of containers nested at any depth within this one
+    std::size_t n_nested = 0;
+};
+
+/**
+ * Validates JSON text and records a lazy_json_span for every container, but
+ * decodes nothing and allocates nothing else.
+ */
+class lazy_json_indexer : public json_cursor {
+    json_parse_options           _opts;
+    std::vector<lazy_json_span>& _spans;
+
+    bool _index_value(std::size_t depth) {
+        if (_it == _end || (*_it != '{' && *_it != '[')) {
+            return skip_value(depth, _opts.max_depth);
+        }
+        if (depth == _opts.max_depth) {
+            return _fail(json_errc::too_deep);
+        }
+        const bool        keyed = *_it == '{';
+        const char        close = keyed ? '}' : ']';
+        const std::size_t idx   = _spans.size();
+        _spans.emplace_back();
+        ++_it;
+        skip_ws();
+        if (!consume(close)) {
+            while (true) {
+                if (keyed) {
+                    json_discard_string key;
+                    if (_it == _end || *_it != '"') {
+                        return _fail_at_end_or(json_errc::unexpected_character);
+                    }
+                    if (!parse_string(key)) {
+                        return false;
+                    }
+                    skip_ws();
+                    if (!expect(':')) {
+                        return false;
+                    }
+                    skip_ws();
+                }
+                if (!_index_value(depth + 1)) {
+                    return false;
+                }
+                skip_ws();
+                if (consume(close)) {
+                    break;
+                }
+                if (!expect(',')) {
+                    return false;
+                }
+                skip_ws();
+            }
+        }
+        _spans[idx].end      = _it;
+        _spans[idx].n_nested = _spans.size() - idx - 1;
+        return true;
+    }
+
+public:
+    lazy_json_indexer(std::string_view             text,
+                      json_parse_options           opts,
+                      std::vector<lazy_json_span>& spans) noexcept
+        : json_cursor(text)
+        , _opts(opts)
+        , _spans(spans) {}
+
+    /**
+     * Index the entire input as a single JSON value. On success, returns the
+     * first character of the value. On failure, returns null.
+     */
+    const char* index_document() {
+        _it               = skip_json_ws(_it, _end);
+        const char* first = _it;
+        if (!_index_value(0)) {
+            return nullptr;
+        }
+        _it = skip_json_ws(_it, _end);
+        if (_it != _end) {
+            _fail(json_errc::trailing_characters);
+            return nullptr;
+        }
+        return first;
+    }
+};
+
+}  // namespace detail
+
+class lazy_json_document;
+
+/**
+ * A node of a lazy_json_document. A node begins as only a position in the
+ * validated JSON text, and is materialized the first time that its value is
+ * requested with try_get(). Materializing an array or object creates an
+ * unmaterialized node for each of its members, using the spans recorded by the
+ * document to step over nested containers without scanning them. Subtrees that
+ * are never requested are never decoded or allocated, so a walk over a
+ * lazy_json parses only as much of the document as it visits.
+ *
+ * Materialization is memoized within the node, and is not synchronized: a
+ * document must not be read by more than one thread at a time. The JSON text
+ * and the lazy_json_document must outlive every node of the document.
+ */
+class lazy_json {
+public:
+    using null_type    = null_t;
+    using bool_type    = bool;
+    using number_type  = double;
+    using string_type  = std::string;
+    using array_type   = std::vector<lazy_json>;
+    using mapping_type = std::map<std::string, lazy_json, std::less<>>;
+
+private:
+    friend class lazy_json_document;
+
+    /// The first character of this value. The default node is a null.
+    const char* _pos = "null";
+    /// The end of the JSON text
+    const char* _end = _pos + 4;
+    /// The spans of the document, and the span of this node if it is a container
+    const detail::lazy_json_span* _spans = nullptr;
+    std::size_t                   _span  = 0;
+
+    mutable std::variant<std::monostate,
+                         null_type,
+                         bool_type,
+                         number_type,
+                         string_type,
+                         array_type,
+                         mapping_type>
+        _value;
+
+    lazy_json(const char*                   pos,
+              const char*                   end,
+              const detail::lazy_json_span* spans,
+              std::size_t                   span) noexcept
+        : _pos(pos)
+        , _end(end)
+        , _spans(spans)
+        , _span(span) {}
+
+    char _first() const noexcept { return *_pos; }
+
+    template <typename Container>
+    void _materialize_members() const {
+        constexpr bool                keyed = neo::same_as<Container, mapping_type>;
+        const detail::lazy_json_span& span  = _spans[_span];
+        // The text was validated by the document, so this cannot fail
+        detail::json_cursor cur{_pos, _pos + 1, span.end};
+        auto&               members = _value.template emplace<Container>();
+        std::size_t         next    = _span + 1;
+        cur.skip_ws();
+        if (cur.consume(keyed ? '}' : ']')) {
+            return;
+        }
+        while (true) {
+            std::string key;
+            if constexpr (keyed) {
+                cur.parse_string(key);
+                cur.skip_ws();
+                cur.consume(':');
+                cur.skip_ws();
+            }
+            lazy_json* child = nullptr;
+            if constexpr (keyed) {
+                // As with parse_json(), the last of any duplicate keys wins
+                child = &members[std::move(key)];
+            } else {
+                child = &members.emplace_back();
+            }
+            const char* first = cur.position();
+            child->_pos       = first;
+            child->_end       = _end;
+            child->_spans     = _spans;
+            child->_span      = next;
+            if (*first == '{' || *first == '[') {
+                cur = detail::json_cursor{_pos, _spans[next].end, span.end};
+                next += _spans[next].n_nested + 1;
+            } else {
+                cur.skip_value(0, 0);
+            }
+            cur.skip_ws();
+            if (!cur.consume(',')) {
+                return;
+            }
+            cur.skip_ws();
+        }
+    }
+
+    void _materialize() const {
+        if (_value.index() != 0) {
+            return;
+        }
+        detail::json_cursor cur{_pos, _pos, _end};
+        switch (_first()) {
+        case 'n':
+            _value.emplace<null_type>(null);
+            return;
+        case 't':
+        case 'f':
+            _value.emplace<bool_type>(_first() == 't');
+            return;
+        case '"':
+            cur.parse_string(_value.emplace<string_type>());
+            return;
+        case '{':
+            _materialize_members<mapping_type>();
+            return;
+        case '[':
+            _materialize_members<array_type>();
+            return;
+        default:
+            cur.parse_number(_value.emplace<number_type>());
+            return;
+        }
+    }
+
+public:
+    /// Create a node that holds a null
+    lazy_json() = default;
+
+    constexpr static bool supports_mappings = true;
+    constexpr static bool supports_arrays   = true;
+
+    bool is_null() const noexcept { return _first() == 'n'; }
+    bool is_bool() const noexcept { return _first() == 't' || _first() == 'f'; }
+    bool is_string() const noexcept { return _first() == '"'; }
+    bool is_mapping() const noexcept { return _first() == '{'; }
+    bool is_array() const noexcept { return _first() == '['; }
+    bool is_number() const noexcept { return _first() == '-' || detail::is_json_digit(_first()); }
+
+    /// Whether the value of this node has been decoded
+    bool materialized() const noexcept { return _value.index() != 0; }
+
+    /// Get the text of this value. This does not materialize the node.
+    std::string_view raw() const noexcept {
+        const char* stop = _pos;
+        if (is_mapping() || is_array()) {
+            stop = _spans[_span].end;
+        } else {
+            detail::json_cursor cur{_pos, _pos, _end};
+            cur.skip_value(0, 0);
+            stop = cur.position();
+        }
+        return std::string_view(_pos, static_cast<std::size_t>(stop - _pos));
+    }
+
+    // clang-format off
+    template <typename T>
+        requires (neo::same_as<T, null_type>   ||
+                  neo::same_as<T, bool_type>   ||
+                  neo::same_as<T, number_type> ||
+                  neo::same_as<T, string_type> ||
+                  neo::same_as<T, mapping_type> ||
+                  neo::same_as<T, array_type>)
+    const T* try_get() const {
+        // clang-format on
+        _materialize();
+        return std::get_if<T>(&_value);
+    }
+
+    /// Get the members of this object. Throws std::bad_variant_access if this is not an object.
+    const mapping_type& as_mapping() const { return semester::get<mapping_type>(*this); }
+
+    /// Get the elements of this array. Throws std::bad_variant_access if this is not an array.
+    const array_type& as_array() const { return semester::get<array_type>(*this); }
+};
+
+/**
+ * A JSON document whose nodes are decoded on demand. Creating a document
+ * validates the entire text and records the extent of every array and object,
+ * but decodes nothing: see lazy_json.
+ *
+ * The document refers to the JSON text, which must outlive it. A document can
+ * be moved, but not copied, as its nodes refer to the document.
+ */
+class lazy_json_document {
+    std::vector<detail::lazy_json_span> _spans;
+    lazy_json                           _root;
+
+    lazy_json_document(std::vector<detail::lazy_json_span>&& spans,
+                       const char*                           first,
+                       const char*                           end) noexcept
+        : _spans(std::move(spans))
+        , _root(first, end, _spans.data(), 0) {}
+
+    friend json_parse_result<lazy_json_document> try_parse_lazy_json(std::string_view,
+                                                                     json_parse_options);
+
+public:
+    /// Create a document that holds a null
+    lazy_json_document() = default;
+
+    lazy_json_document(lazy_json_document&&) = default;
+    lazy_json_document& operator=(lazy_json_document&&) = default;
+
+    /// The root node of the document
+    const lazy_json& root() const noexcept { return _root; }
+
+    /// The number of arrays and objects in the document
+    std::size_t container_count() const noexcept { return _spans.size(); }
+};
+
+/**
+ * Validate the given JSON text and create a lazy_json_document for it. On
+ * failure, returns a result with `error` set rather than throwing.
+ */
+inline json_parse_result<lazy_json_document> try_parse_lazy_json(std::string_view   text,
+                                                                 json_parse_options opts = {}) {
+    json_parse_result<lazy_json_document> ret;
+    std::vector<detail::lazy_json_span>   spans;
+    detail::lazy_json_indexer             indexer{text, opts, spans};
+    const char*                           first = indexer.index_document();
+    if (!first) {
+        ret.error  = indexer.error;
+        ret.offset = indexer.offset();
+        return ret;
+    }
+    ret.value = lazy_json_document(std::move(spans), first, text.data() + text.size());
+    return ret;
+}
+
+/**
+ * Validate the given JSON text and create a lazy_json_document for it. Throws
+ * json_parse_error if the text is not valid JSON.
+ */
+inline lazy_json_document parse_lazy_json(std::string_view text, json_parse_options opts = {}) {
+    auto result = try_parse_lazy_json(text, opts);
+    if (!result) {
+        SEMESTER_THROW(json_parse_error(result.error, result.offset));
+    }
+    return std::move(result.value);
+}
+
+}  // namespace semester
@@ -0,0 +1,107 @@
+#include <semester/lazy_json.hpp>
+
+#include <semester/walk.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <neo/test_concept.hpp>
+
+#include <cmath>
+
+NEO_TEST_CONCEPT(semester::supports_mappings<semester::lazy_json>);
+NEO_TEST_CONCEPT(semester::supports_arrays<semester::lazy_json>);
+NEO_TEST_CONCEPT(semester::supports_try_get<semester::lazy_json, std::string>);
+
+TEST_CASE("Query scalars in a lazy JSON document") {
+    auto doc = semester::parse_lazy_json(R"(  "I am \"quoted\""  )");
+    CHECK(doc.root().is_string());
+    CHECK_FALSE(doc.root().materialized());
+    CHECK(semester::get<std::string>(doc.root()) == "I am \"quoted\"");
+    CHECK(doc.root().materialized());
+    CHECK_FALSE(semester::holds_alternative<double>(doc.root()));
+    CHECK(doc.root().raw() == R"("I am \"quoted\"")");
+
+    CHECK(semester::get<double>(semester::parse_lazy_json("-12.5").root()) == -12.5);
+    CHECK(std::signbit(semester::get<double>(semester::parse_lazy_json("-0").root())));
+    CHECK(semester::get<bool>(semester::parse_lazy_json("true").root()));
+    CHECK(semester::holds_alternative<semester::null_t>(semester::parse_lazy_json("null").root()));
+    CHECK(semester::holds_alternative<semester::null_t>(semester::lazy_json{}));
+}
+
+TEST_CASE("Walk a lazy JSON document") {
+    std::string_view text = R"({
+        "foo": "bar",
+        "nested": {"a": [1, 2, {"deep": [[], {}]}], "b!": "escaped key"},
+        "list": [{"x": 1}, {"x": 2}],
+        "baz": 33,
+        "baz": 34
+    })";
+    auto doc = semester::parse_lazy_json(text);
+    CHECK(doc.container_count() == 10);
+
+    using namespace semester::walk_ops;
+    std::string foo_string;
+    double      baz_value = 0;
+    semester::walk(doc.root(),
+                   mapping{
+                       if_key{"foo", put_into(foo_string)},
+                       if_key{"baz", put_into(baz_value)},
+                       if_key{"nested", just_accept},
+                       if_key{"list", just_accept},
+                   });
+    CHECK(foo_string == "bar");
+    CHECK(baz_value == 34.0);
+
+    // Only the members of the root were touched
+    const auto& root = doc.root().as_mapping();
+    CHECK(root.size() == 4);
+    CHECK(root.at("foo").materialized());
+    CHECK_FALSE(root.at("nested").materialized());
+    CHECK_FALSE(root.at("list").materialized());
+    CHECK(root.at("nested").raw().front() == '{');
+    CHECK(root.at("nested").raw().back() == '}');
+
+    // Touching a subtree materializes only the nodes that are visited
+    std::string escaped;
+    semester::walk(root.at("nested"), mapping{if_key{"b!", put_into(escaped)}, just_accept});
+    CHECK(escaped == "escaped key");
+    const auto& nested = root.at("nested").as_mapping();
+    CHECK_FALSE(nested.at("a").materialized());
+
+    const auto& a = nested.at("a").as_array();
+    REQUIRE(a.size() == 3);
+    CHECK(semester::get<double>(a[1]) == 2.0);
+    CHECK_FALSE(a[0].materialized());
+    CHECK(a[2].as_mapping().at("deep").raw() == "[[], {}]");
+
+    // Containers following a nested container are found from the recorded spans
+    std::vector<double> xs;
+    semester::walk(root.at("list"),
+                   for_each{mapping{if_key{"x", put_into(std::back_inserter(xs))}}});
+    CHECK(xs == std::vector<double>{1, 2});
+}
+
+TEST_CASE("Reject invalid text for a lazy JSON document") {
+    auto check_error = [](std::string_view text, semester::json_errc ec, std::size_t offset) {
+        auto result = semester::try_parse_lazy_json(text);
+        CHECK_FALSE(result);
+        CHECK(result.error == ec);
+        CHECK(result.offset == offset);
+    };
+    check_error("", semester::json_errc::unexpected_end, 0);
+    check_error(R"({"a": [1, 2,]})", semester::json_errc::unexpected_character, 12);
+    check_error(R"({"a": {"b": nope}})", semester::json_errc::invalid_literal, 12);
+    check_error(R"({"a" 1})", semester::json_errc::unexpected_character, 5);
+    check_error(R"({1: 2})", semester::json_errc::unexpected_character, 1);
+    check_error("[[]] []", semester::json_errc::trailing_characters, 5);
+
+    auto deep = semester::try_parse_lazy_json("[[[1]]]", semester::json_parse_options{2});
+    CHECK(deep.error == semester::json_errc::too_deep);
+    CHECK(deep.offset == 2);
+    CHECK(semester::try_parse_lazy_json("[[[1]]]", semester::json_parse_options{3}));
+
+#if !SEMESTER_NO_EXCEPTIONS
+    CHECK_THROWS_AS(semester::parse_lazy_json("{\"unterminated"), semester::json_parse_error);
+    CHECK_THROWS_AS(semester::parse_lazy_json("[1] 2"), semester::json_parse_error);
+#endif
+}
@@ -1,40 +1,167 @@
 #pragma once
 
+#include <semester/config.hpp>
+#include <semester/cow.hpp>
 #include <semester/data.hpp>
 
+#include <neo/fwd.hpp>
+
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <variant>
 
 namespace semester {
 
-template <typename Data>
+template <typename Data, typename Allocator = std::allocator<void>>
 struct s_expr_traits_base {
-    using string_type = std::string;
+    using allocator_type = Allocator;
+
+    template <typename T>
+    using rebind_alloc = typename std::allocator_traits<allocator_type>::template rebind_alloc<T>;
+
+    using string_type = std::basic_string<char, std::char_traits<char>, rebind_alloc<char>>;
+    /// The empty list, `()`, which also terminates a proper list
+    using null_type = null_t;
 
+    /**
+     * A cons cell. Both children are stored together in a single allocation from
+     * the allocator of the data, so building a list of N elements costs N
+     * allocations. With a pmr allocator, the cells of a document may be drawn
+     * from a pool or an arena (see s_expr_arena).
+     */
     class pair_type {
-        std::unique_ptr<Data> _left;
-        std::unique_ptr<Data> _right;
+        struct cell {
+            Data left;
+            Data right;
+
+            template <typename Arg>
+            static Data _make_child(const allocator_type& alloc, Arg&& arg) {
+                if constexpr (std::allocator_traits<allocator_type>::is_always_equal::value) {
+                    // Children do not need to be told about a stateless allocator
+                    return Data(NEO_FWD(arg));
+                } else {
+                    return std::make_obj_using_allocator<Data>(alloc, NEO_FWD(arg));
+                }
+            }
+
+            template <typename LeftArg, typename RightArg>
+            cell(const allocator_type& alloc, LeftArg&& left, RightArg&& right)
+                : left(_make_child(alloc, NEO_FWD(left)))
+                , right(_make_child(alloc, NEO_FWD(right))) {}
+        };
+
+        using cell_alloc  = rebind_alloc<cell>;
+        using cell_traits = std::allocator_traits<cell_alloc>;
+
+        cell*                            _cell = nullptr;
+        [[no_unique_address]] cell_alloc _alloc;
+
+        template <typename LeftArg, typename RightArg>
+        static cell* _make_cell(cell_alloc& alloc, LeftArg&& left, RightArg&& right) {
+            cell* ptr = cell_traits::allocate(alloc, 1);
+            SEMESTER_TRY {
+                cell_traits::construct(alloc,
+                                       ptr,
+                                       allocator_type(alloc),
+                                       NEO_FWD(left),
+                                       NEO_FWD(right));
+            } SEMESTER_CATCH_ALL {
+                cell_traits::deallocate(alloc, ptr, 1);
+                SEMESTER_RETHROW;
+            }
+            return ptr;
+        }
+
+        static void _destroy_cell(cell_alloc& alloc, cell* ptr) noexcept {
+            if (ptr) {
+                cell_traits::destroy(alloc, ptr);
+                cell_traits::deallocate(alloc, ptr, 1);
+            }
+        }
+
+        void _destroy() noexcept { _destroy_cell(_alloc, std::exchange(_cell, nullptr)); }
 
     public:
+        using allocator_type = Allocator;
+
         template <typename LeftArg, typename RightArg>
         pair_type(LeftArg&& left, RightArg&& right)
-            : _left(std::make_unique<Data>(std::forward<LeftArg>(left)))
-            , _right(std::make_unique<Data>(std::forward<RightArg>(right))) {}
+            : pair_type(std::allocator_arg, allocator_type(), NEO_FWD(left), NEO_FWD(right)) {}
+
+        template <typename LeftArg, typename RightArg>
+        pair_type(std::allocator_arg_t,
+                  const allocator_type& alloc,
+                  LeftArg&&             left,
+                  RightArg&&            right)
+            : _alloc(alloc) {
+            _cell = _make_cell(_alloc, NEO_FWD(left), NEO_FWD(right));
+        }
 
         pair_type(const pair_type& other)
-            : pair_type(*other._left, *other._right) {}
+            : pair_type(std::allocator_arg,
+                        cell_traits::select_on_container_copy_construction(other._alloc),
+                        other) {}
 
-        pair_type(pair_type&&) = default;
+        pair_type(std::allocator_arg_t, const allocator_type& alloc, const pair_type& other)
+            : pair_type(std::allocator_arg, alloc, other.left(), other.right()) {}
+
+        pair_type(pair_type&& other) noexcept
+            : _cell(std::exchange(other._cell, nullptr))
+            , _alloc(other._alloc) {}
+
+        pair_type(std::allocator_arg_t, const allocator_type& alloc, pair_type&& other)
+            : _alloc(alloc) {
+            if (_alloc == other._alloc) {
+                _cell = std::exchange(other._cell, nullptr);
+            } else {
+                _cell = _make_cell(_alloc, std::move(other.left()), std::move(other.right()));
+            }
+        }
+
+        ~pair_type() { _destroy(); }
 
         pair_type& operator=(const pair_type& other) {
-            *_left  = other.left();
-            *_right = other.right();
+            if (this != &other) {
+                if (_cell) {
+                    left()  = other.left();
+                    right() = other.right();
+                } else {
+                    _cell = _make_cell(_alloc, other.left(), other.right());
+                }
+            }
+            return *this;
+        }
+
+        pair_type& operator=(pair_type&& other) noexcept(
+            std::allocator_traits<cell_alloc>::is_always_equal::value) {
+            if (this == &other) {
+                return *this;
+            }
+            if (_alloc == other._alloc) {
+                // Take the cell before destroying ours, which may own `other`
+                cell* old = std::exchange(_cell, std::exchange(other._cell, nullptr));
+                _destroy_cell(_alloc, old);
+            } else if (_cell) {
+                left()  = std::move(other.left());
+                right() = std::move(other.right());
+            } else {
+                _cell = _make_cell(_alloc, std::move(other.left()), std::move(other.right()));
+            }
             return *this;
         }
 
-        Data&       left() noexcept { return *_left; }
-        Data&       right() noexcept { return *_right; }
-        const Data& left() const noexcept { return *_left; }
-        const Data& right() const noexcept { return *_right; }
+        allocator_type get_allocator() const noexcept { return allocator_type(_alloc); }
+
+        /// Check whether the pair has been moved from, and so has no children
+        bool empty() const noexcept { return _cell == nullptr; }
+
+        Data&       left() noexcept { return _cell->left; }
+        Data&       right() noexcept { return _cell->right; }
+        const Data& left() const noexcept { return _cell->left; }
+        const Data& right() const noexcept { return _cell->right; }
 
         friend constexpr bool operator==(const pair_type& left, const pair_type& right) noexcept {
             return left.left() == right.left() && left.right() == right.right();
@@ -45,16 +172,89 @@ struct s_expr_traits_base {
         }
     };
 
-    using variant_type = std::variant<string_type, pair_type>;
+    using variant_type = std::variant<string_type, pair_type, null_type>;
 
     string_type convert(const char* s) { return s; }
 };
 
-struct s_expr_traits {
+template <typename Allocator>
+struct s_expr_traits_alloc {
     template <typename Data>
-    using traits = s_expr_traits_base<Data>;
+    using traits = s_expr_traits_base<Data, Allocator>;
 };
 
+struct s_expr_traits : s_expr_traits_alloc<std::allocator<void>> {};
+
 using s_expr_data = basic_data<s_expr_traits>;
 
+struct s_expr_pmr_traits : s_expr_traits_alloc<std::pmr::polymorphic_allocator<std::byte>> {};
+
+/**
+ * S-expression data that allocates its cells and strings from a
+ * std::pmr::memory_resource. The resource is propagated to every nested node.
+ */
+using s_expr_pmr_data = basic_data<s_expr_pmr_traits>;
+
+/**
+ * Traits for s-expression data whose pairs are copy-on-write. Copying data is
+ * O(1), and a pair is cloned only when it is modified with mutate() while it is
+ * shared with another copy.
+ */
+struct s_expr_cow_traits {
+    template <typename Data>
+    struct traits : s_expr_traits_base<Data> {
+        using typename s_expr_traits_base<Data>::null_type;
+        using typename s_expr_traits_base<Data>::pair_type;
+        using typename s_expr_traits_base<Data>::string_type;
+
+        using variant_type = std::variant<string_type, cow_box<pair_type>, null_type>;
+    };
+};
+
+using s_expr_cow_data = basic_data<s_expr_cow_traits>;
+
+/**
+ * An arena for s-expression data. Data made with make() is allocated from a
+ * monotonic buffer, along with all of its cells and strings, and is never
+ * destroyed individually: release() frees all of it at once, without visiting
+ * any of the nodes.
+ */
+class s_expr_arena {
+    std::pmr::monotonic_buffer_resource _resource;
+
+public:
+    s_expr_arena() = default;
+
+    /// Create an arena that takes its memory from `upstream`
+    explicit s_expr_arena(std::pmr::memory_resource& upstream)
+        : _resource(&upstream) {}
+
+    s_expr_arena(const s_expr_arena&) = delete;
+    s_expr_arena& operator=(const s_expr_arena&) = delete;
+
+    using allocator_type = s_expr_pmr_data::allocator_type;
+
+    /// The allocator that draws from this arena
+    allocator_type get_allocator() noexcept { return allocator_type(&_resource); }
+
+    /**
+     * Create a data object in the arena. The returned reference is valid until
+     * release() is called or the arena is destroyed.
+     */
+    template <typename... Args>
+    s_expr_pmr_data& make(Args&&... args) {
+        void* ptr = _resource.allocate(sizeof(s_expr_pmr_data), alignof(s_expr_pmr_data));
+        return *std::construct_at(static_cast<s_expr_pmr_data*>(ptr),
+                                  std::allocator_arg,
+                                  get_allocator(),
+                                  NEO_FWD(args)...);
+    }
+
+    /**
+     * Free all memory of the arena at once. Every data object that was created
+     * in the arena, and everything allocated from it, becomes invalid.
+     */
+    void release() noexcept { _resource.release(); }
+};
+
 }  // namespace semester
@@ -14,3 +14,95 @@ TEST_CASE("Create an s-expr data") {
     CHECK(pair.left() == "Nope");
     CHECK(pair.right() == "Yep");
 }
+
+TEST_CASE("s-expr pairs are copied and moved") {
+    using pair_type = semester::s_expr_data::traits_type::pair_type;
+    semester::s_expr_data list = pair_type("a", pair_type("b", "nil"));
+    semester::s_expr_data copy = list;
+    CHECK(copy == list);
+
+    auto& head = semester::get<pair_type>(copy);
+    head.left() = "z";
+    CHECK_FALSE(copy == list);
+
+    semester::s_expr_data moved = std::move(copy);
+    CHECK(semester::get<pair_type>(moved).left() == "z");
+    copy = list;
+    CHECK(copy == list);
+
+    // Move the tail of a list over the list itself
+    auto& pair = semester::get<pair_type>(list);
+    pair       = std::move(semester::get<pair_type>(pair.right()));
+    CHECK(pair.left() == "b");
+    CHECK(pair.right() == "nil");
+}
+
+TEST_CASE("s-expr cells are allocated from a memory resource") {
+    using pair_type = semester::s_expr_pmr_data::traits_type::pair_type;
+
+    struct counting_resource : std::pmr::memory_resource {
+        int n_allocs = 0;
+
+        void* do_allocate(std::size_t size, std::size_t align) override {
+            ++n_allocs;
+            return std::pmr::new_delete_resource()->allocate(size, align);
+        }
+        void do_deallocate(void* ptr, std::size_t size, std::size_t align) override {
+            std::pmr::new_delete_resource()->deallocate(ptr, size, align);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    } counter;
+
+    std::pmr::polymorphic_allocator<std::byte> alloc{&counter};
+    {
+        // Build a list of short strings: One cell allocation per element
+        semester::s_expr_pmr_data list{std::allocator_arg, alloc, "nil"};
+        for (int i = 0; i < 100; ++i) {
+            list = pair_type(std::allocator_arg, alloc, "x", std::move(list));
+        }
+        CHECK(counter.n_allocs == 100);
+        CHECK(semester::get<pair_type>(list).left().get_allocator().resource() == &counter);
+        CHECK(semester::get<pair_type>(list).right().get_allocator().resource() == &counter);
+    }
+
+    semester::s_expr_arena arena;
+    auto&                  root = arena.make("nil");
+    for (int i = 0; i < 1000; ++i) {
+        root = pair_type(std::allocator_arg, arena.get_allocator(), "x", std::move(root));
+    }
+    CHECK(semester::get<pair_type>(root).left() == "x");
+    // Everything is freed at once, without destroying the list
+    arena.release();
+}
+
+TEST_CASE("Copy, compare, and destroy very long lists") {
+    using pair_type            = semester::s_expr_data::traits_type::pair_type;
+    semester::s_expr_data list = semester::null;
+    for (int i = 0; i < 500000; ++i) {
+        list = pair_type("x", std::move(list));
+    }
+    semester::s_expr_data copy = list;
+    CHECK(copy == list);
+    semester::get<pair_type>(copy).left() = "y";
+    CHECK_FALSE(copy == list);
+
+    // An allocator-extended copy gives the allocator to every cell
+    using pmr_pair_type = semester::s_expr_pmr_data::traits_type::pair_type;
+    semester::s_expr_pmr_data pmr_source = semester::null;
+    for (int i = 0; i < 500000; ++i) {
+        pmr_source = pmr_pair_type("x", std::move(pmr_source));
+    }
+    std::pmr::monotonic_buffer_resource resource;
+    semester::s_expr_pmr_data           pmr_copy{std::allocator_arg, &resource, pmr_source};
+    int                                 length       = 0;
+    int                                 other_allocs = 0;
+    for (auto cell = semester::try_get<pmr_pair_type>(pmr_copy); cell;
+         cell      = semester::try_get<pmr_pair_type>(cell->right())) {
+        other_allocs += cell->get_allocator().resource() != &resource;
+        ++length;
+    }
+    CHECK(length == 500000);
+    CHECK(other_allocs == 0);
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <semester/config.hpp>
+#include <semester/data.hpp>
+#include <semester/s_expr.hpp>
+
+#include <neo/fwd.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace semester {
+
+/**
+ * Error conditions that can be encountered while reading s-expression text.
+ */
+enum class s_expr_errc {
+    none = 0,
+    unexpected_end,
+    unexpected_close,
+    misplaced_dot,
+    expected_close,
+    invalid_escape,
+    trailing_characters,
+};
+
+/**
+ * Get a human-readable description of an s-expression reading error
+ */
+constexpr const char* describe(s_expr_errc ec) noexcept {
+    switch (ec) {
+    case s_expr_errc::none:
+        return "No error";
+    case s_expr_errc::unexpected_end:
+        return "Unexpected end of input";
+    case s_expr_errc::unexpected_close:
+        return "Unexpected closing parenthesis";
+    case s_expr_errc::misplaced_dot:
+        return "A dot must follow at least one element of a list and precede its last";
+    case s_expr_errc::expected_close:
+        return "Expected a closing parenthesis after the tail of a dotted list";
+    case s_expr_errc::invalid_escape:
+        return "Invalid escape sequence in string";
+    case s_expr_errc::trailing_characters:
+        return "Trailing characters after s-expression";
+    }
+    return "Unknown error";
+}
+
+/**
+ * Exception thrown when reading invalid s-expression text.
+ */
+struct s_expr_parse_error : std::runtime_error {
+    s_expr_errc code;
+    std::size_t offset;
+
+    s_expr_parse_error(s_expr_errc ec, std::size_t off)
+        : runtime_error("Invalid s-expression at offset " + std::to_string(off) + ": "
+                        + describe(ec))
+        , code(ec)
+        , offset(off) {}
+};
+
+namespace detail {
+
+constexpr bool is_s_expr_space(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+/// Check whether `c` ends an atom
+constexpr bool is_s_expr_delimiter(char c) noexcept {
+    return is_s_expr_space(c) || c == '(' || c == ')' || c == '"' || c == ';';
+}
+
+}  // namespace detail
+
+/**
+ * Reads s-expressions from text, one top-level datum at a time.
+ *
+ * - An atom is any run of characters other than whitespace, parentheses,
+ *   double quotes, and semicolons. Atoms are read as strings.
+ * - A string is enclosed in double quotes, and may contain the escapes `\"`,
+ *   `\\`, `\n`, `\t`, and `\r`.
+ * - A list is enclosed in parentheses. `()` is the null_t alternative, and a
+ *   proper list is a chain of pairs ending in null. `(a b . c)` is a dotted list
+ *   whose last pair has `c` on the right.
+ * - A semicolon begins a comment that runs to the end of the line.
+ *
+ * The reader uses an explicit stack for nested lists rather than recursion,
+ * and each element is constructed in place at the tail of its list, so the
+ * only allocations are for the pairs and for strings that are too long to
+ * store inline. If the data has an allocator, every node is constructed with
+ * it; an s_expr_pmr_data reader given the allocator of an s_expr_arena draws
+ * all of its storage from the arena.
+ */
+template <typename Data = s_expr_data>
+class s_expr_reader {
+public:
+    using traits_type = typename Data::traits_type;
+    using string_type = typename traits_type::string_type;
+    using pair_type   = typename traits_type::pair_type;
+
+private:
+    const char* _begin;
+    const char* _it;
+    const char* _end;
+
+    /// A list that is being read
+    struct _frame {
+        /// The slot that holds the list itself
+        Data* list;
+        /// The slot that receives the next element: the right of the last pair
+        Data* tail;
+        /// Whether a dot has been read, and the tail datum must follow
+        bool dotted = false;
+        /// Whether the tail datum of a dotted list has been read
+        bool closed = false;
+    };
+
+    std::vector<_frame> _stack;
+
+    [[noreturn]] void _fail(s_expr_errc ec) const {
+        SEMESTER_THROW(s_expr_parse_error(ec, static_cast<std::size_t>(_it - _begin)));
+    }
+
+    void _skip_ws() noexcept {
+        while (_it != _end) {
+            if (*_it == ';') {
+                while (_it != _end && *_it != '\n') {
+                    ++_it;
+                }
+            } else if (detail::is_s_expr_space(*_it)) {
+                ++_it;
+            } else {
+                return;
+            }
+        }
+    }
+
+    bool _at_lone_dot() const noexcept {
+        return *_it == '.' && (_it + 1 == _end || detail::is_s_expr_delimiter(_it[1]));
+    }
+
+    void _read_string(Data& slot) {
+        auto&       str = slot.template emplace<string_type>();
+        const char* run = ++_it;
+        while (true) {
+            if (_it == _end) {
+                _fail(s_expr_errc::unexpected_end);
+            }
+            const char c = *_it;
+            if (c == '"') {
+                str.append(run, _it);
+                ++_it;
+                return;
+            }
+            if (c != '\\') {
+                ++_it;
+                continue;
+            }
+            str.append(run, _it);
+            ++_it;
+            if (_it == _end) {
+                _fail(s_expr_errc::unexpected_end);
+            }
+            switch (*_it) {
+            case '"':
+            case '\\':
+                str.push_back(*_it);
+                break;
+            case 'n':
+                str.push_back('\n');
+                break;
+            case 't':
+                str.push_back('\t');
+                break;
+            case 'r':
+                str.push_back('\r');
+                break;
+            default:
+                _fail(s_expr_errc::invalid_escape);
+            }
+            run = ++_it;
+        }
+    }
+
+    void _read_atom(Data& slot) {
+        const char* first = _it;
+        while (_it != _end && !detail::is_s_expr_delimiter(*_it)) {
+            ++_it;
+        }
+        slot.template emplace<string_type>(first, _it);
+    }
+
+    /**
+     * Find the slot for the next datum of the innermost list. Returns null if
+     * the list was closed instead.
+     */
+    Data* _next_slot() {
+        _frame& top = _stack.back();
+        if (_it == _end) {
+            _fail(s_expr_errc::unexpected_end);
+        }
+        if (*_it == ')') {
+            if (top.dotted && !top.closed) {
+                _fail(s_expr_errc::misplaced_dot);
+            }
+            ++_it;
+            _stack.pop_back();
+            return nullptr;
+        }
+        if (top.closed) {
+            _fail(s_expr_errc::expected_close);
+        }
+        if (_at_lone_dot()) {
+            if (top.dotted || top.tail == top.list) {
+                _fail(s_expr_errc::misplaced_dot);
+            }
+            ++_it;
+            top.dotted = true;
+            _skip_ws();
+            return _next_slot();
+        }
+        if (top.dotted) {
+            // The tail of a dotted list replaces the terminating null
+            top.closed = true;
+            return top.tail;
+        }
+        // Append a new pair at the end of the list. Its left receives the datum.
+        auto& pair = top.tail->template emplace<pair_type>(null, null);
+        top.tail   = &pair.right();
+        return &pair.left();
+    }
+
+public:
+    explicit s_expr_reader(std::string_view text) noexcept
+        : _begin(text.data())
+        , _it(text.data())
+        , _end(text.data() + text.size()) {}
+
+    /// The offset of the reader within the text
+    std::size_t offset() const noexcept { return static_cast<std::size_t>(_it - _begin); }
+
+    /// Skip whitespace and comments, and check whether any text remains
+    bool at_end() noexcept {
+        _skip_ws();
+        return _it == _end;
+    }
+
+    /**
+     * Read the next top-level datum into `out`. Returns `false` if only
+     * whitespace and comments remain. Throws s_expr_parse_error if the text is
+     * invalid. If `out` has an allocator, all nodes are constructed with it.
+     */
+    bool next(Data& out) {
+        _skip_ws();
+        if (_it == _end) {
+            return false;
+        }
+        _stack.clear();
+        Data* slot = &out;
+        while (true) {
+            switch (*_it) {
+            case '(':
+                ++_it;
+                slot->template emplace<null_t>();
+                _stack.push_back({slot, slot});
+                break;
+            case ')':
+                _fail(s_expr_errc::unexpected_close);
+            case '"':
+                _read_string(*slot);
+                break;
+            default:
+                if (_at_lone_dot()) {
+                    _fail(s_expr_errc::misplaced_dot);
+                }
+                _read_atom(*slot);
+                break;
+            }
+            // Find where the next datum goes, closing any lists that end here
+            slot = nullptr;
+            while (!slot && !_stack.empty()) {
+                _skip_ws();
+                slot = _next_slot();
+            }
+            if (!slot) {
+                return true;
+            }
+        }
+    }
+};
+
+/**
+ * Read a single s-expression from the given text. Throws s_expr_parse_error if
+ * the text is invalid, or if anything other than whitespace and comments
+ * follows the datum.
+ */
+template <typename Data = s_expr_data>
+Data read_s_expr(std::string_view text, Data out = Data()) {
+    s_expr_reader<Data> reader{text};
+    if (!reader.next(out)) {
+        SEMESTER_THROW(s_expr_parse_error(s_expr_errc::unexpected_end, reader.offset()));
+    }
+    if (!reader.at_end()) {
+        SEMESTER_THROW(s_expr_parse_error(s_expr_errc::trailing_characters, reader.offset()));
+    }
+    return out;
+}
+
+}  // namespace semester
@@ -0,0 +1,116 @@
+#include <semester/s_expr_read.hpp>
+
+#include <catch2/catch.hpp>
+
+using pair_type = semester::s_expr_data::traits_type::pair_type;
+
+namespace {
+
+const semester::s_expr_data& left(const semester::s_expr_data& d) {
+    return semester::get<pair_type>(d).left();
+}
+
+const semester::s_expr_data& right(const semester::s_expr_data& d) {
+    return semester::get<pair_type>(d).right();
+}
+
+}  // namespace
+
+TEST_CASE("Read atoms and strings") {
+    CHECK(semester::read_s_expr("  hello ") == "hello");
+    CHECK(semester::read_s_expr(R"("with \"quotes\" and\nnewline")")
+          == "with \"quotes\" and\nnewline");
+    CHECK(semester::read_s_expr("()") == semester::s_expr_data(semester::null));
+    CHECK(semester::read_s_expr("1.5e3") == "1.5e3");
+    CHECK(semester::read_s_expr(".5") == ".5");
+}
+
+TEST_CASE("Read lists") {
+    auto list = semester::read_s_expr("(define (square x) ; comment\n (* x x))");
+    CHECK(left(list) == "define");
+    CHECK(left(left(right(list))) == "square");
+    CHECK(left(right(left(right(list)))) == "x");
+    CHECK(right(right(left(right(list)))) == semester::s_expr_data(semester::null));
+    CHECK(left(left(right(right(list)))) == "*");
+    CHECK(right(right(right(list))) == semester::s_expr_data(semester::null));
+
+    auto dotted = semester::read_s_expr("(a b . c)");
+    CHECK(left(dotted) == "a");
+    CHECK(left(right(dotted)) == "b");
+    CHECK(right(right(dotted)) == "c");
+
+    auto nested_tail = semester::read_s_expr("(a . (b))");
+    CHECK(left(right(nested_tail)) == "b");
+    CHECK(right(right(nested_tail)) == semester::s_expr_data(semester::null));
+}
+
+TEST_CASE("Read several data from a stream") {
+    semester::s_expr_reader  reader{"a (b) \"c\" ; done"};
+    semester::s_expr_data    dat;
+    std::vector<std::string> firsts;
+    while (reader.next(dat)) {
+        firsts.push_back(dat.is_string() ? semester::get<std::string>(dat)
+                                         : semester::get<std::string>(left(dat)));
+    }
+    CHECK(firsts == std::vector<std::string>{"a", "b", "c"});
+}
+
+TEST_CASE("Read very deep and long lists") {
+    std::string text(5000, '(');
+    text.append(5000, ')');
+    auto                         deep  = semester::read_s_expr(text);
+    const semester::s_expr_data* inner = &deep;
+    for (int i = 0; i < 4999; ++i) {
+        inner = &left(*inner);
+    }
+    CHECK(*inner == semester::s_expr_data(semester::null));
+
+    std::string long_list = "(";
+    for (int i = 0; i < 5000; ++i) {
+        long_list += "x ";
+    }
+    long_list += ")";
+    auto                         lst = semester::read_s_expr(long_list);
+    const semester::s_expr_data* cur = &lst;
+    int                          n   = 0;
+    while (semester::holds_alternative<pair_type>(*cur)) {
+        ++n;
+        cur = &right(*cur);
+    }
+    CHECK(n == 5000);
+}
+
+#if !SEMESTER_NO_EXCEPTIONS
+TEST_CASE("Reject invalid s-expressions") {
+    auto code_of = [](std::string_view text) {
+        try {
+            semester::read_s_expr(text);
+        } catch (const semester::s_expr_parse_error& e) {
+            return e.code;
+        }
+        return semester::s_expr_errc::none;
+    };
+    CHECK(code_of("(a b") == semester::s_expr_errc::unexpected_end);
+    CHECK(code_of("a)") == semester::s_expr_errc::trailing_characters);
+    CHECK(code_of(")") == semester::s_expr_errc::unexpected_close);
+    CHECK(code_of("(. a)") == semester::s_expr_errc::misplaced_dot);
+    CHECK(code_of("(a .)") == semester::s_expr_errc::misplaced_dot);
+    CHECK(code_of("(a . b c)") == semester::s_expr_errc::expected_close);
+    CHECK(code_of(R"("bad \q")") == semester::s_expr_errc::invalid_escape);
+    CHECK(code_of("\"open") == semester::s_expr_errc::unexpected_end);
+    CHECK(code_of("") == semester::s_expr_errc::unexpected_end);
+}
+#endif
+
+TEST_CASE("Read into an arena") {
+    using pmr_pair = semester::s_expr_pmr_data::traits_type::pair_type;
+    semester::s_expr_arena                             arena;
+    auto&                                              dat = arena.make();
+    semester::s_expr_reader<semester::s_expr_pmr_data> reader{"(a-long-atom-name (b) . c)"};
+    REQUIRE(reader.next(dat));
+    const auto& pair = semester::get<pmr_pair>(dat);
+    CHECK(pair.left() == "a-long-atom-name");
+    CHECK(pair.left().get_allocator() == arena.get_allocator());
+    CHECK(semester::get<pmr_pair>(pair.right()).right().get_allocator() == arena.get_allocator());
+    arena.release();
+}
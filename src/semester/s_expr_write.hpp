@@ -0,0 +1,137 @@
+#pragma once
+
+#include <semester/data.hpp>
+#include <semester/s_expr.hpp>
+#include <semester/s_expr_read.hpp>
+#include <semester/sink.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace semester {
+
+namespace detail {
+
+/// Check whether `str` can be written as a bare atom and read back unchanged
+constexpr bool is_s_expr_atom(std::string_view str) noexcept {
+    if (str.empty() || str == ".") {
+        return false;
+    }
+    for (char c : str) {
+        if (is_s_expr_delimiter(c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Writer>
+void write_s_expr_string(Writer& out, std::string_view str) {
+    if (is_s_expr_atom(str)) {
+        out.write(str);
+        return;
+    }
+    out.put('"');
+    auto run = str.begin();
+    for (auto it = str.begin(); it != str.end(); ++it) {
+        std::string_view esc;
+        switch (*it) {
+        case '"':
+            esc = "\\\"";
+            break;
+        case '\\':
+            esc = "\\\\";
+            break;
+        case '\n':
+            esc = "\\n";
+            break;
+        case '\t':
+            esc = "\\t";
+            break;
+        case '\r':
+            esc = "\\r";
+            break;
+        default:
+            continue;
+        }
+        out.write(std::string_view(run, it));
+        out.write(esc);
+        run = it + 1;
+    }
+    out.write(std::string_view(run, str.end()));
+    out.put('"');
+}
+
+}  // namespace detail
+
+/**
+ * Write the given s-expression data as text into the given output sink. Lists
+ * are written in their proper or dotted form, and strings are written as bare
+ * atoms when they can be read back unchanged, otherwise they are quoted.
+ *
+ * The printer keeps its own stack of the lists being written, rather than
+ * recursing, so the length and nesting of lists are limited only by memory.
+ */
+template <typename Data, output_sink Sink>
+void write_s_expr(const Data& dat, Sink&& sink) {
+    using traits_type = typename Data::traits_type;
+    using string_type = typename traits_type::string_type;
+    using pair_type   = typename traits_type::pair_type;
+
+    buffered_writer<Sink&> out{sink};
+    // The pairs whose left side is being written
+    std::vector<const pair_type*> stack;
+
+    const auto write_scalar = [&](const Data& d) {
+        if (const auto str = d.template try_get<string_type>()) {
+            detail::write_s_expr_string(out, std::string_view(*str));
+        } else {
+            out.write("()", 2);
+        }
+    };
+
+    const Data* cur = &dat;
+    while (true) {
+        if (const auto pair = cur->template try_get<pair_type>()) {
+            out.put('(');
+            stack.push_back(pair);
+            cur = &pair->left();
+            continue;
+        }
+        write_scalar(*cur);
+        // Move to the next element of the innermost unfinished list
+        cur = nullptr;
+        while (!cur && !stack.empty()) {
+            const Data& rest = stack.back()->right();
+            if (const auto next = rest.template try_get<pair_type>()) {
+                out.put(' ');
+                stack.back() = next;
+                cur          = &next->left();
+            } else {
+                if (!rest.template try_get<null_t>()) {
+                    out.write(" . ", 3);
+                    write_scalar(rest);
+                }
+                out.put(')');
+                stack.pop_back();
+            }
+        }
+        if (!cur) {
+            break;
+        }
+    }
+    out.flush();
+}
+
+/**
+ * Serialize the given s-expression data as a string.
+ */
+template <typename Data>
+std::string to_s_expr_string(const Data& dat) {
+    std::string str;
+    write_s_expr(dat, string_sink{str});
+    return str;
+}
+
+}  // namespace semester
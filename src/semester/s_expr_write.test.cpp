@@ -0,0 +1,43 @@
+#include <semester/s_expr_write.hpp>
+
+#include <catch2/catch.hpp>
+
+using pair_type = semester::s_expr_data::traits_type::pair_type;
+
+TEST_CASE("Write s-expressions") {
+    CHECK(semester::to_s_expr_string(semester::s_expr_data("atom")) == "atom");
+    CHECK(semester::to_s_expr_string(semester::s_expr_data("two words")) == "\"two words\"");
+    CHECK(semester::to_s_expr_string(semester::s_expr_data("")) == "\"\"");
+    CHECK(semester::to_s_expr_string(semester::s_expr_data("say \"hi\"\n"))
+          == R"("say \"hi\"\n")");
+    CHECK(semester::to_s_expr_string(semester::s_expr_data(semester::null)) == "()");
+
+    semester::s_expr_data dotted = pair_type("a", pair_type("b", "c"));
+    CHECK(semester::to_s_expr_string(dotted) == "(a b . c)");
+}
+
+TEST_CASE("Round-trip s-expressions") {
+    for (std::string_view text : {
+             "(define (square x) (* x x))",
+             "(() (()) (a . b) \"quoted (text)\" \".\")",
+             "((a b) . (c d))",
+         }) {
+        auto dat     = semester::read_s_expr(text);
+        auto written = semester::to_s_expr_string(dat);
+        CHECK(semester::read_s_expr(written) == dat);
+    }
+    CHECK(semester::to_s_expr_string(semester::read_s_expr("((a b) . (c d))")) == "((a b) c d)");
+}
+
+TEST_CASE("Write very deep and long lists without recursion") {
+    std::string text(5000, '(');
+    text.append(5000, ')');
+    CHECK(semester::to_s_expr_string(semester::read_s_expr(text)) == text);
+
+    std::string long_list = "(";
+    for (int i = 0; i < 5000; ++i) {
+        long_list += i ? " x" : "x";
+    }
+    long_list += ")";
+    CHECK(semester::to_s_expr_string(semester::read_s_expr(long_list)) == long_list);
+}
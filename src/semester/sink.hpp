@@ -0,0 +1,205 @@
+#pragma once
+
+#include <semester/config.hpp>
+
+#include <neo/fwd.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#define SEMESTER_HAVE_UNISTD 1
+#elif __has_include(<io.h>)
+#include <io.h>
+#define SEMESTER_HAVE_UNISTD 0
+#endif
+
+namespace semester {
+
+// clang-format off
+/**
+ * An output sink accepts blocks of bytes. Sinks are wrapped in a buffered_writer
+ * by the serializers, so a sink will generally see few, large writes.
+ */
+template <typename T>
+concept output_sink = requires(T& sink, const char* data, std::size_t size) {
+    sink.write(data, size);
+};
+// clang-format on
+
+/**
+ * A sink that appends to a std::string
+ */
+class string_sink {
+    std::string* _str;
+
+public:
+    explicit string_sink(std::string& str) noexcept
+        : _str(&str) {}
+
+    void write(const char* data, std::size_t size) { _str->append(data, size); }
+};
+
+/**
+ * A sink that writes into a fixed-size buffer. If the buffer fills, the output
+ * is truncated, and truncated() will return `true`. Never allocates.
+ */
+class buffer_sink {
+    char*       _data;
+    std::size_t _size;
+    std::size_t _written   = 0;
+    bool        _truncated = false;
+
+public:
+    buffer_sink(char* data, std::size_t size) noexcept
+        : _data(data)
+        , _size(size) {}
+
+    void write(const char* data, std::size_t size) noexcept {
+        const auto n = (std::min)(size, _size - _written);
+        std::memcpy(_data + _written, data, n);
+        _written += n;
+        _truncated = _truncated || n != size;
+    }
+
+    /// The number of bytes that have been written into the buffer
+    std::size_t written() const noexcept { return _written; }
+    /// The bytes that have been written into the buffer
+    std::string_view view() const noexcept { return std::string_view(_data, _written); }
+    /// Whether any output was discarded because the buffer was full
+    bool truncated() const noexcept { return _truncated; }
+};
+
+/**
+ * A sink that writes to a file descriptor. Throws std::system_error if a write
+ * fails. Does not take ownership of the file descriptor.
+ */
+class fd_sink {
+    int _fd;
+
+public:
+    explicit fd_sink(int fd) noexcept
+        : _fd(fd) {}
+
+    void write(const char* data, std::size_t size) {
+        while (size) {
+#if SEMESTER_HAVE_UNISTD
+            const auto n = ::write(_fd, data, size);
+#else
+            const auto chunk = (std::min)(size, std::size_t(1) << 30);
+            const auto n     = ::_write(_fd, data, static_cast<unsigned>(chunk));
+#endif
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                SEMESTER_THROW(
+                    std::system_error(errno, std::generic_category(), "Failed to write output"));
+            }
+            data += n;
+            size -= static_cast<std::size_t>(n);
+        }
+    }
+};
+
+/**
+ * Collects small writes into a large buffer and passes them to the wrapped sink
+ * in big chunks. The buffer is flushed when full and on destruction, but call
+ * flush() explicitly to observe errors from the sink.
+ */
+template <output_sink Sink>
+class buffered_writer {
+public:
+    constexpr static std::size_t default_capacity = 64 * 1024;
+
+private:
+    Sink                    _sink;
+    std::unique_ptr<char[]> _buf;
+    std::size_t             _cap;
+    std::size_t             _len = 0;
+
+    void _flush_buffer() {
+        if (_len) {
+            const auto n = _len;
+            _len         = 0;
+            _sink.write(_buf.get(), n);
+        }
+    }
+
+public:
+    explicit buffered_writer(Sink&& sink, std::size_t capacity = default_capacity)
+        : _sink(NEO_FWD(sink))
+        , _buf(new char[capacity])
+        , _cap(capacity) {}
+
+    buffered_writer(const buffered_writer&) = delete;
+    buffered_writer& operator=(const buffered_writer&) = delete;
+
+    ~buffered_writer() {
+        SEMESTER_TRY {
+            _flush_buffer();
+        } SEMESTER_CATCH_ALL {
+            // Errors on implicit flush are discarded
+        }
+    }
+
+    void put(char c) {
+        if (_len == _cap) {
+            _flush_buffer();
+        }
+        _buf[_len++] = c;
+    }
+
+    void write(const char* data, std::size_t size) {
+        if (size >= _cap) {
+            // Large blocks bypass the buffer entirely
+            _flush_buffer();
+            _sink.write(data, size);
+            return;
+        }
+        // The largest buffered length that leaves room for the block
+        const std::size_t max_len = _cap - size;
+        if (_len > max_len) {
+            _flush_buffer();
+        }
+        std::memcpy(_buf.get() + _len, data, size);
+        _len += size;
+    }
+
+    void write(std::string_view sv) { write(sv.data(), sv.size()); }
+
+    /**
+     * Obtain space for at least `size` contiguous bytes at the end of the buffer.
+     * `size` must be no greater than the buffer capacity. Call commit() with the
+     * number of bytes that were actually written.
+     */
+    char* reserve(std::size_t size) {
+        if (size > _cap - _len) {
+            _flush_buffer();
+        }
+        return _buf.get() + _len;
+    }
+
+    void commit(std::size_t size) noexcept { _len += size; }
+
+    /// Pass all buffered data to the sink
+    void flush() { _flush_buffer(); }
+
+    Sink&       sink() noexcept { return _sink; }
+    const Sink& sink() const noexcept { return _sink; }
+};
+
+template <typename Sink>
+buffered_writer(Sink&&) -> buffered_writer<Sink>;
+
+template <typename Sink>
+buffered_writer(Sink&&, std::size_t) -> buffered_writer<Sink>;
+
+}  // namespace semester
@@ -0,0 +1,39 @@
+#include <semester/sink.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+namespace {
+
+struct counting_sink {
+    std::vector<std::size_t>* writes;
+    void write(const char*, std::size_t size) { writes->push_back(size); }
+};
+
+}  // namespace
+
+TEST_CASE("Buffered writes are passed on in large chunks") {
+    std::vector<std::size_t> writes;
+    {
+        semester::buffered_writer out{counting_sink{&writes}, 16};
+        for (auto i = 0; i < 40; ++i) {
+            out.put('x');
+        }
+        CHECK(writes == std::vector<std::size_t>{16, 16});
+        out.write("0123456789abcdefghij");
+        CHECK(writes == std::vector<std::size_t>{16, 16, 8, 20});
+    }
+    CHECK(writes.size() == 4);
+}
+
+TEST_CASE("Write to a string") {
+    std::string str;
+    {
+        semester::buffered_writer out{semester::string_sink{str}};
+        out.write("Hello, ");
+        out.write("world!");
+        CHECK(str.empty());
+    }
+    CHECK(str == "Hello, world!");
+}
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <semester/config.hpp>
+#include <semester/sink.hpp>
+#include <semester/tape.hpp>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SEMESTER_HAVE_MMAP 1
+#else
+#define SEMESTER_HAVE_MMAP 0
+#endif
+
+namespace semester {
+
+/**
+ * The header at the start of a snapshot. A snapshot is the header, followed by
+ * the entries of a tape, followed by the characters of its strings. Neither the
+ * entries nor the strings contain pointers, so a snapshot can be used in place
+ * at whatever address it is loaded.
+ *
+ * Snapshots use the byte order and tape_entry layout of the machine that wrote
+ * them, and are rejected elsewhere.
+ */
+struct snapshot_header {
+    char          magic[8];
+    std::uint32_t version;
+    /// snapshot_byte_order, as written by the producing machine
+    std::uint32_t byte_order;
+    std::uint32_t entry_size;
+    std::uint32_t reserved;
+    std::uint64_t n_entries;
+    std::uint64_t n_chars;
+};
+
+inline constexpr char          snapshot_magic[8]      = {'S', 'E', 'M', 'T', 'A', 'P', 'E', 0};
+inline constexpr std::uint32_t snapshot_version       = 3;
+inline constexpr std::uint32_t snapshot_byte_order    = 0x01020304;
+inline constexpr std::size_t   snapshot_entries_start = sizeof(snapshot_header);
+
+static_assert(std::is_trivially_copyable_v<snapshot_header>);
+static_assert(std::has_unique_object_representations_v<snapshot_header>);
+static_assert(sizeof(snapshot_header) % alignof(tape_entry) == 0,
+              "The entries must be aligned when the snapshot is");
+
+/**
+ * Error conditions that can be encountered while opening a snapshot.
+ */
+enum class snapshot_errc {
+    none = 0,
+    truncated,
+    bad_magic,
+    wrong_version,
+    wrong_layout,
+    misaligned,
+    invalid_entry,
+};
+
+/**
+ * Get a human-readable description of a snapshot error
+ */
+constexpr const char* describe(snapshot_errc ec) noexcept {
+    switch (ec) {
+    case snapshot_errc::none:
+        return "No error";
+    case snapshot_errc::truncated:
+        return "Snapshot is truncated";
+    case snapshot_errc::bad_magic:
+        return "Data is not a snapshot";
+    case snapshot_errc::wrong_version:
+        return "Unsupported snapshot version";
+    case snapshot_errc::wrong_layout:
+        return "Snapshot was written with a different byte order or entry layout";
+    case snapshot_errc::misaligned:
+        return "Snapshot is not suitably aligned in memory";
+    case snapshot_errc::invalid_entry:
+        return "Snapshot contains an invalid entry";
+    }
+    return "Unknown error";
+}
+
+/**
+ * Exception thrown by open_snapshot() when given data that is not a usable
+ * snapshot.
+ */
+struct snapshot_error : std::runtime_error {
+    snapshot_errc code;
+
+    explicit snapshot_error(snapshot_errc ec)
+        : runtime_error(std::string("Cannot open snapshot: ") + describe(ec))
+        , code(ec) {}
+};
+
+/**
+ * A read-only view of a tape stored in a snapshot. Opening a snapshot checks
+ * only its header, so the cost of a query is that of the pages that it
+ * touches. The view refers to the snapshot's memory, which must outlive it.
+ *
+ * Values are read with tape_node, so the walk_ops run directly over a snapshot.
+ */
+class tape_snapshot {
+    const tape_entry* _entries   = nullptr;
+    std::size_t       _n_entries = 0;
+    const char*       _chars     = nullptr;
+    std::size_t       _n_chars   = 0;
+
+public:
+    tape_snapshot() = default;
+
+    tape_snapshot(const tape_entry* entries,
+                  std::size_t       n_entries,
+                  const char*       chars,
+                  std::size_t       n_chars) noexcept
+        : _entries(entries)
+        , _n_entries(n_entries)
+        , _chars(chars)
+        , _n_chars(n_chars) {}
+
+    /// Whether the snapshot holds no document
+    bool empty() const noexcept { return _n_entries == 0; }
+
+    /// The root of the document. The snapshot must not be empty.
+    tape_node root() const noexcept { return tape_node(_entries, _chars); }
+
+    /// The entries of the tape
+    const tape_entry* entries() const noexcept { return _entries; }
+    std::size_t       entry_count() const noexcept { return _n_entries; }
+
+    /// The characters of all strings of the tape
+    std::string_view strings() const noexcept { return std::string_view(_chars, _n_chars); }
+
+    /**
+     * Check every entry of the snapshot, so that no query can read outside of
+     * it. This visits the entire snapshot: Use it for snapshots that come from
+     * an untrusted source.
+     */
+    snapshot_errc verify() const {
+        struct frame {
+            std::size_t   end;
+            std::uint32_t n_members;
+            bool          keyed;
+        };
+        std::vector<frame> stack;
+
+        std::size_t pos = 0;
+        // Check the entry at `pos`, which must be a member of the innermost frame
+        auto check_value = [&](bool key) {
+            const std::size_t end = stack.empty() ? _n_entries : stack.back().end;
+            if (pos >= end) {
+                return false;
+            }
+            const tape_entry& ent = _entries[pos];
+            if (key && ent.kind != tape_kind::string) {
+                return false;
+            }
+            switch (ent.kind) {
+            case tape_kind::boolean: {
+                // Read the flag as a byte, since a bool that is not 0 or 1 cannot be read
+                unsigned char flag = 0;
+                std::memcpy(&flag, &ent.flag, sizeof flag);
+                ++pos;
+                return flag <= 1;
+            }
+            case tape_kind::null:
+            case tape_kind::number:
+            case tape_kind::int64:
+            case tape_kind::uint64:
+                ++pos;
+                return true;
+            case tape_kind::string:
+                ++pos;
+                return ent.payload <= _n_chars && ent.size <= _n_chars - ent.payload;
+            case tape_kind::mapping:
+            case tape_kind::array:
+                if (ent.payload == 0 || ent.payload > end - pos) {
+                    return false;
+                }
+                stack.push_back({pos + static_cast<std::size_t>(ent.payload),
+                                 ent.size,
+                                 ent.kind == tape_kind::mapping});
+                ++pos;
+                return true;
+            }
+            return false;
+        };
+
+        if (empty()) {
+            return snapshot_errc::none;
+        }
+        if (!check_value(false)) {
+            return snapshot_errc::invalid_entry;
+        }
+        while (!stack.empty()) {
+            frame& top = stack.back();
+            if (top.n_members == 0) {
+                if (pos != top.end) {
+                    return snapshot_errc::invalid_entry;
+                }
+                stack.pop_back();
+                continue;
+            }
+            --top.n_members;
+            if (top.keyed && !check_value(true)) {
+                return snapshot_errc::invalid_entry;
+            }
+            if (!check_value(false)) {
+                return snapshot_errc::invalid_entry;
+            }
+        }
+        // The root must span the whole tape
+        return pos == _n_entries ? snapshot_errc::none : snapshot_errc::invalid_entry;
+    }
+};
+
+/**
+ * The result of try_open_snapshot(). If opening failed, `error` describes the
+ * failure and `value` is empty.
+ */
+struct snapshot_open_result {
+    tape_snapshot value;
+    snapshot_errc error = snapshot_errc::none;
+
+    explicit operator bool() const noexcept { return error == snapshot_errc::none; }
+};
+
+/**
+ * Open a snapshot that is stored at `bytes`, such as a file mapped with
+ * mapped_file. The bytes must be aligned for tape_entry, as mapped memory is.
+ * Only the header is checked: See tape_snapshot::verify().
+ */
+inline snapshot_open_result try_open_snapshot(std::string_view bytes) noexcept {
+    snapshot_open_result ret;
+    snapshot_header      head;
+    if (bytes.size() < sizeof head) {
+        ret.error = snapshot_errc::truncated;
+        return ret;
+    }
+    std::memcpy(&head, bytes.data(), sizeof head);
+    if (std::memcmp(head.magic, snapshot_magic, sizeof head.magic) != 0) {
+        ret.error = snapshot_errc::bad_magic;
+    } else if (head.version == 0 || head.version > snapshot_version) {
+        // Version 1 differs only in lacking the integer entry kinds, and version
+        // 2 in leaving the reserved bytes of entries uninitialized
+        ret.error = snapshot_errc::wrong_version;
+    } else if (head.byte_order != snapshot_byte_order || head.entry_size != sizeof(tape_entry)) {
+        ret.error = snapshot_errc::wrong_layout;
+    } else if (reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(tape_entry) != 0) {
+        ret.error = snapshot_errc::misaligned;
+    } else if (head.n_entries > (bytes.size() - sizeof head) / sizeof(tape_entry)
+               || head.n_chars > bytes.size() - sizeof head - head.n_entries * sizeof(tape_entry)) {
+        ret.error = snapshot_errc::truncated;
+    } else {
+        const char* entries   = bytes.data() + snapshot_entries_start;
+        const auto  n_entries = static_cast<std::size_t>(head.n_entries);
+        ret.value = tape_snapshot(reinterpret_cast<const tape_entry*>(entries),
+                                  n_entries,
+                                  entries + n_entries * sizeof(tape_entry),
+                                  static_cast<std::size_t>(head.n_chars));
+    }
+    return ret;
+}
+
+/**
+ * Open a snapshot that is stored at `bytes`. Throws snapshot_error if the bytes
+ * are not a usable snapshot.
+ */
+inline tape_snapshot open_snapshot(std::string_view bytes) {
+    auto result = try_open_snapshot(bytes);
+    if (!result) {
+        SEMESTER_THROW(snapshot_error(result.error));
+    }
+    return result.value;
+}
+
+/**
+ * Write a snapshot of the given tape into the given output sink. The tape is
+ * passed to the sink in three large blocks, without copying.
+ */
+template <output_sink Sink>
+void write_snapshot(const tape_document& tape, Sink&& sink) {
+    snapshot_header head = {};
+    std::memcpy(head.magic, snapshot_magic, sizeof head.magic);
+    head.version    = snapshot_version;
+    head.byte_order = snapshot_byte_order;
+    head.entry_size = sizeof(tape_entry);
+    head.n_entries  = tape.entry_count();
+    head.n_chars    = tape.strings().size();
+    sink.write(reinterpret_cast<const char*>(&head), sizeof head);
+    sink.write(reinterpret_cast<const char*>(tape.entries()),
+               tape.entry_count() * sizeof(tape_entry));
+    sink.write(tape.strings().data(), tape.strings().size());
+}
+
+/**
+ * Create a snapshot of the given tape in a string.
+ */
+inline std::string to_snapshot_string(const tape_document& tape) {
+    std::string str;
+    write_snapshot(tape, string_sink{str});
+    return str;
+}
+
+#if SEMESTER_HAVE_MMAP
+
+/**
+ * A read-only, shared memory mapping of an entire file. Pages are loaded on
+ * first access, and are shared by every process that maps the same file.
+ * Throws std::system_error if the file cannot be mapped.
+ */
+class mapped_file {
+    void*       _data = nullptr;
+    std::size_t _size = 0;
+
+    [[noreturn]] static void _fail([[maybe_unused]] const char* what) {
+        SEMESTER_THROW(std::system_error(errno, std::generic_category(), what));
+    }
+
+public:
+    explicit mapped_file(const char* path) {
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            _fail("Failed to open file for mapping");
+        }
+        struct ::stat st;
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            errno = err;
+            _fail("Failed to get the size of a file for mapping");
+        }
+        _size = static_cast<std::size_t>(st.st_size);
+        if (_size != 0) {
+            _data = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        const int err = errno;
+        ::close(fd);
+        if (_data == MAP_FAILED) {
+            _data = nullptr;
+            errno = err;
+            _fail("Failed to map file");
+        }
+    }
+
+    mapped_file(mapped_file&& other) noexcept
+        : _data(std::exchange(other._data, nullptr))
+        , _size(std::exchange(other._size, 0)) {}
+
+    mapped_file& operator=(mapped_file&& other) noexcept {
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        return *this;
+    }
+
+    ~mapped_file() {
+        if (_data) {
+            ::munmap(_data, _size);
+        }
+    }
+
+    /// The contents of the file
+    std::string_view bytes() const noexcept {
+        return std::string_view(static_cast<const char*>(_data), _size);
+    }
+};
+
+#endif
+
+}  // namespace semester
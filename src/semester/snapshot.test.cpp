@@ -0,0 +1,183 @@
+#include <semester/snapshot.hpp>
+
+#include <semester/walk.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Copy the bytes of a snapshot into memory that is aligned as mapped memory would be
+struct aligned_bytes {
+    std::vector<std::uint64_t> storage;
+    std::size_t                size;
+
+    explicit aligned_bytes(std::string_view bytes)
+        : storage((bytes.size() + 7) / 8)
+        , size(bytes.size()) {
+        std::memcpy(storage.data(), bytes.data(), bytes.size());
+    }
+
+    std::string_view view() const noexcept {
+        return std::string_view(reinterpret_cast<const char*>(storage.data()), size);
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Walk a snapshot in place") {
+    auto tape = semester::parse_json_tape(R"({
+        "foo": "bar",
+        "nested": {"values": [1, 2, 3], "flag": true},
+        "baz": null
+    })");
+    aligned_bytes bytes{semester::to_snapshot_string(tape)};
+    CHECK(bytes.size
+          == sizeof(semester::snapshot_header) + tape.entry_count() * sizeof(semester::tape_entry)
+              + tape.strings().size());
+
+    auto snap = semester::open_snapshot(bytes.view());
+    CHECK(snap.entry_count() == tape.entry_count());
+    CHECK(snap.strings() == tape.strings());
+    // The entries are used where they are, not copied
+    CHECK(static_cast<const void*>(snap.entries())
+          == bytes.view().data() + semester::snapshot_entries_start);
+    CHECK(snap.verify() == semester::snapshot_errc::none);
+
+    using namespace semester::walk_ops;
+    std::string         foo;
+    std::vector<double> values;
+    bool                flag = false;
+    semester::walk(snap.root(),
+                   mapping{
+                       required_key{"foo", "'foo' is required", put_into(foo)},
+                       if_key{"nested",
+                              mapping{
+                                  if_key{"values", for_each{put_into(std::back_inserter(values))}},
+                                  if_key{"flag", put_into(flag)},
+                              }},
+                       if_key{"baz", require_type<semester::null_t>("'baz' is null"), just_accept},
+                   });
+    CHECK(foo == "bar");
+    CHECK(values == std::vector<double>{1, 2, 3});
+    CHECK(flag);
+}
+
+TEST_CASE("Keep integers exact in a snapshot") {
+    auto          dat  = semester::parse_json<semester::json_int_data>(
+        R"([9007199254740993, -9223372036854775808, 18446744073709551615, 0.5])");
+    auto          tape = semester::tape_document::from_data(dat);
+    aligned_bytes bytes{semester::to_snapshot_string(tape)};
+    auto          snap = semester::open_snapshot(bytes.view());
+    CHECK(snap.verify() == semester::snapshot_errc::none);
+
+    auto arr = semester::get<semester::tape_node::array_type>(snap.root());
+    auto it  = arr.begin();
+    CHECK(semester::get<std::int64_t>(*it++) == 9007199254740993);
+    CHECK(semester::get<std::int64_t>(*it++) == (std::numeric_limits<std::int64_t>::min)());
+    CHECK(semester::get<std::uint64_t>(*it++) == 18446744073709551615u);
+    CHECK(semester::get<double>(*it++) == 0.5);
+}
+
+TEST_CASE("Snapshots of the same document are identical") {
+    const std::string_view json = R"({"a": [true, null, 1.5, -2, "three"], "b": {"c": false}})";
+    const auto             first = semester::to_snapshot_string(semester::parse_json_tape(json));
+
+    // Leave stale bytes in memory that the next tape may be given
+    for (std::size_t size = 16; size < 4096; size += 16) {
+        std::vector<char> junk(size, '\xab');
+        static_cast<void>(junk);
+    }
+    const auto second = semester::to_snapshot_string(semester::parse_json_tape(json));
+    CHECK(first == second);
+}
+
+TEST_CASE("Reject unusable snapshots") {
+    using semester::snapshot_errc;
+    auto       tape  = semester::parse_json_tape(R"({"a": [1, "two"]})");
+    const auto image = semester::to_snapshot_string(tape);
+    auto       error = [](const std::string& str) {
+        return semester::try_open_snapshot(aligned_bytes{str}.view()).error;
+    };
+
+    CHECK(error(image) == snapshot_errc::none);
+    CHECK(error(image.substr(0, 10)) == snapshot_errc::truncated);
+    CHECK(error(image.substr(0, image.size() - 1)) == snapshot_errc::truncated);
+    CHECK(error("This is not a snapshot, but it is long enough to be one")
+          == snapshot_errc::bad_magic);
+
+    auto wrong_version = image;
+    wrong_version[offsetof(semester::snapshot_header, version)] ^= 0x7f;
+    CHECK(error(wrong_version) == snapshot_errc::wrong_version);
+    auto wrong_order = image;
+    wrong_order[offsetof(semester::snapshot_header, byte_order)] ^= 0x7f;
+    CHECK(error(wrong_order) == snapshot_errc::wrong_layout);
+
+    aligned_bytes shifted{" " + image};
+    CHECK(semester::try_open_snapshot(shifted.view().substr(1)).error
+          == snapshot_errc::misaligned);
+
+    // Corrupt entries are found by verify(), not when opening
+    auto corrupt = image;
+    auto ent_pos = semester::snapshot_entries_start + 2 * sizeof(semester::tape_entry);
+    auto ent     = semester::tape_entry{};
+    std::memcpy(&ent, corrupt.data() + ent_pos, sizeof ent);
+    REQUIRE(ent.kind == semester::tape_kind::array);
+    ent.payload = 100;
+    std::memcpy(corrupt.data() + ent_pos, &ent, sizeof ent);
+    aligned_bytes corrupt_bytes{corrupt};
+    auto          snap = semester::open_snapshot(corrupt_bytes.view());
+    CHECK(snap.verify() == snapshot_errc::invalid_entry);
+
+    // A boolean flag must be 0 or 1
+    auto bool_image = semester::to_snapshot_string(semester::parse_json_tape("[true, false]"));
+    auto flag_pos   = semester::snapshot_entries_start + sizeof(semester::tape_entry)
+        + offsetof(semester::tape_entry, flag);
+    REQUIRE(bool_image[flag_pos] == 1);
+    bool_image[flag_pos] = 2;
+    aligned_bytes bad_flag{bool_image};
+    CHECK(semester::open_snapshot(bad_flag.view()).verify() == snapshot_errc::invalid_entry);
+    bool_image[flag_pos] = 1;
+    CHECK(semester::open_snapshot(aligned_bytes{bool_image}.view()).verify()
+          == snapshot_errc::none);
+#if !SEMESTER_NO_EXCEPTIONS
+    CHECK_THROWS_AS(semester::open_snapshot(aligned_bytes{image.substr(0, 4)}.view()),
+                    semester::snapshot_error);
+#endif
+}
+
+#if SEMESTER_HAVE_MMAP
+TEST_CASE("Map a snapshot file") {
+    auto tape = semester::tape_document::from_data(
+        semester::json_data(semester::json_data::array_type{"mapped", 42, true}));
+
+    std::string path = "semester-snapshot-test.bin";
+    {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        REQUIRE(file);
+        const auto image = semester::to_snapshot_string(tape);
+        std::fwrite(image.data(), 1, image.size(), file);
+        std::fclose(file);
+    }
+    {
+        semester::mapped_file file{path.c_str()};
+        auto                  snap = semester::open_snapshot(file.bytes());
+
+        auto arr = semester::get<semester::tape_node::array_type>(snap.root());
+        auto it  = arr.begin();
+        CHECK(semester::get<std::string_view>(*it++) == "mapped");
+        CHECK(semester::get<double>(*it++) == 42);
+        CHECK(semester::get<bool>(*it++));
+    }
+    std::remove(path.c_str());
+#if !SEMESTER_NO_EXCEPTIONS
+    CHECK_THROWS_AS(semester::mapped_file{path.c_str()}, std::system_error);
+#endif
+}
+#endif
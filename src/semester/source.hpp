@@ -0,0 +1,256 @@
+#pragma once
+
+#include <semester/config.hpp>
+
+#include <neo/fwd.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <system_error>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#define SEMESTER_HAVE_UNISTD 1
+#elif __has_include(<io.h>)
+#include <io.h>
+#define SEMESTER_HAVE_UNISTD 0
+#endif
+
+namespace semester {
+
+// clang-format off
+/**
+ * An input source produces blocks of bytes. read() fills as much of the given
+ * buffer as it can, and returns the number of bytes that were read, which is
+ * zero only at the end of the input. Sources are wrapped in a buffered_reader
+ * by the decoders, so a source will generally see few, large reads.
+ */
+template <typename T>
+concept input_source = requires(T& source, char* data, std::size_t size) {
+    { source.read(data, size) } -> std::convertible_to<std::size_t>;
+};
+// clang-format on
+
+/**
+ * A source that reads from a block of memory. The memory must outlive the
+ * source.
+ */
+class string_source {
+    std::string_view _str;
+
+public:
+    explicit string_source(std::string_view str) noexcept
+        : _str(str) {}
+
+    std::size_t read(char* data, std::size_t size) noexcept {
+        const auto n = (std::min)(size, _str.size());
+        std::memcpy(data, _str.data(), n);
+        _str.remove_prefix(n);
+        return n;
+    }
+};
+
+/**
+ * A source that reads from a file descriptor. Throws std::system_error if a
+ * read fails. Does not take ownership of the file descriptor.
+ */
+class fd_source {
+    int _fd;
+
+public:
+    explicit fd_source(int fd) noexcept
+        : _fd(fd) {}
+
+    std::size_t read(char* data, std::size_t size) {
+        while (true) {
+#if SEMESTER_HAVE_UNISTD
+            const auto n = ::read(_fd, data, size);
+#else
+            const auto chunk = (std::min)(size, std::size_t(1) << 30);
+            const auto n     = ::_read(_fd, data, static_cast<unsigned>(chunk));
+#endif
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                SEMESTER_THROW(
+                    std::system_error(errno, std::generic_category(), "Failed to read input"));
+            }
+            return static_cast<std::size_t>(n);
+        }
+    }
+};
+
+/**
+ * Reads bytes from a contiguous block of memory, without copying it into a
+ * buffer. Has the same reading interface as buffered_reader, so a decoder can
+ * take either one.
+ */
+class memory_reader {
+    const char* _begin;
+    const char* _it;
+    const char* _end;
+
+public:
+    explicit memory_reader(std::string_view bytes) noexcept
+        : _begin(bytes.data())
+        , _it(_begin)
+        , _end(_begin + bytes.size()) {}
+
+    /// Read a single byte. Returns `false` at the end of the input.
+    bool get(char& c) noexcept {
+        if (_it == _end) {
+            return false;
+        }
+        c = *_it++;
+        return true;
+    }
+
+    /**
+     * Read exactly `size` bytes. Returns `false` if the input ends first, in
+     * which case the remaining input has been consumed.
+     */
+    bool read(char* data, std::size_t size) noexcept {
+        if (size > static_cast<std::size_t>(_end - _it)) {
+            _it = _end;
+            return false;
+        }
+        std::memcpy(data, _it, size);
+        _it += size;
+        return true;
+    }
+
+    /**
+     * Consume the next `size` bytes and return a pointer to them, or return null
+     * without consuming anything if there are fewer than `size` bytes left.
+     */
+    const char* take(std::size_t size) noexcept {
+        if (size > static_cast<std::size_t>(_end - _it)) {
+            return nullptr;
+        }
+        const char* ptr = _it;
+        _it += size;
+        return ptr;
+    }
+
+    /// The number of bytes that can be read without reaching the end
+    std::size_t available() const noexcept { return static_cast<std::size_t>(_end - _it); }
+
+    /// The number of bytes that have been consumed
+    std::size_t offset() const noexcept { return static_cast<std::size_t>(_it - _begin); }
+};
+
+/**
+ * Takes large blocks of bytes from the wrapped source, and hands them out in
+ * pieces. Reads that are as large as the buffer bypass it and go to the source
+ * directly.
+ */
+template <input_source Source>
+class buffered_reader {
+public:
+    constexpr static std::size_t default_capacity = 64 * 1024;
+
+private:
+    Source                  _source;
+    std::unique_ptr<char[]> _buf;
+    std::size_t             _cap;
+    std::size_t             _pos = 0;
+    std::size_t             _len = 0;
+    /// The number of bytes that were consumed before the current buffer
+    std::size_t _base = 0;
+
+    bool _fill() {
+        _base += _len;
+        _pos = 0;
+        _len = static_cast<std::size_t>(_source.read(_buf.get(), _cap));
+        return _len != 0;
+    }
+
+public:
+    explicit buffered_reader(Source&& source, std::size_t capacity = default_capacity)
+        : _source(NEO_FWD(source))
+        , _buf(new char[capacity])
+        , _cap(capacity) {}
+
+    buffered_reader(const buffered_reader&) = delete;
+    buffered_reader& operator=(const buffered_reader&) = delete;
+
+    /// Read a single byte. Returns `false` at the end of the input.
+    bool get(char& c) {
+        if (_pos == _len && !_fill()) {
+            return false;
+        }
+        c = _buf[_pos++];
+        return true;
+    }
+
+    /**
+     * Read exactly `size` bytes. Returns `false` if the input ends first, in
+     * which case the remaining input has been consumed.
+     */
+    bool read(char* data, std::size_t size) {
+        while (size) {
+            if (_pos == _len) {
+                if (size >= _cap) {
+                    // Large blocks bypass the buffer entirely
+                    _base += _len;
+                    _pos = 0;
+                    _len = 0;
+                    const auto n = static_cast<std::size_t>(_source.read(data, size));
+                    if (n == 0) {
+                        return false;
+                    }
+                    _base += n;
+                    data += n;
+                    size -= n;
+                    continue;
+                }
+                if (!_fill()) {
+                    return false;
+                }
+            }
+            const auto n = (std::min)(size, _len - _pos);
+            std::memcpy(data, _buf.get() + _pos, n);
+            _pos += n;
+            data += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    /**
+     * Consume the next `size` bytes and return a pointer to them, if they are
+     * already in the buffer. Otherwise, return null without consuming anything:
+     * use read() instead. The pointer is valid until the next read.
+     */
+    const char* take(std::size_t size) noexcept {
+        if (size > _len - _pos) {
+            return nullptr;
+        }
+        const char* ptr = _buf.get() + _pos;
+        _pos += size;
+        return ptr;
+    }
+
+    /// The number of bytes that can be read without reading from the source
+    std::size_t available() const noexcept { return _len - _pos; }
+
+    /// The number of bytes that have been consumed
+    std::size_t offset() const noexcept { return _base + _pos; }
+
+    Source&       source() noexcept { return _source; }
+    const Source& source() const noexcept { return _source; }
+};
+
+template <typename Source>
+buffered_reader(Source&&) -> buffered_reader<Source>;
+
+template <typename Source>
+buffered_reader(Source&&, std::size_t) -> buffered_reader<Source>;
+
+}  // namespace semester
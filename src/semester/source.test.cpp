@@ -0,0 +1,57 @@
+#include <semester/source.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+struct counting_source {
+    semester::string_source   source;
+    std::vector<std::size_t>* reads;
+
+    std::size_t read(char* data, std::size_t size) {
+        reads->push_back(size);
+        return source.read(data, size);
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Buffered reads take large chunks from the source") {
+    const std::string        input = "0123456789abcdefghijklmnopqrstuvwxyz0123456789";
+    std::vector<std::size_t> reads;
+    semester::buffered_reader in{counting_source{semester::string_source{input}, &reads}, 16};
+
+    char c = 0;
+    REQUIRE(in.get(c));
+    CHECK(c == '0');
+    char buf[20] = {};
+    REQUIRE(in.read(buf, 15));
+    CHECK(std::string(buf, 15) == "123456789abcdef");
+    CHECK(reads == std::vector<std::size_t>{16});
+    CHECK(in.offset() == 16);
+
+    // A read as large as the buffer goes to the source directly
+    REQUIRE(in.read(buf, 20));
+    CHECK(std::string(buf, 20) == "ghijklmnopqrstuvwxyz");
+    CHECK(reads == std::vector<std::size_t>{16, 20});
+    CHECK(in.offset() == 36);
+
+    REQUIRE(in.read(buf, 10));
+    CHECK(std::string(buf, 10) == "0123456789");
+    CHECK(reads == std::vector<std::size_t>{16, 20, 16});
+    CHECK_FALSE(in.get(c));
+    CHECK(in.offset() == input.size());
+}
+
+TEST_CASE("Read from memory") {
+    semester::memory_reader in{"abc"};
+    char                    buf[4] = {};
+    REQUIRE(in.read(buf, 2));
+    CHECK(in.offset() == 2);
+    CHECK_FALSE(in.read(buf, 2));
+    CHECK(in.offset() == 3);
+    CHECK_FALSE(in.get(buf[0]));
+}
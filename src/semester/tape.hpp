@@ -0,0 +1,602 @@
+#pragma once
+
+#include <semester/config.hpp>
+#include <semester/data.hpp>
+#include <semester/get.hpp>
+#include <semester/json_parse.hpp>
+
+#include <neo/concepts.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace semester {
+
+/**
+ * The kind of value stored in a tape_entry
+ */
+enum class tape_kind : std::uint8_t {
+    null,
+    boolean,
+    number,
+    string,
+    mapping,
+    array,
+    /// An integer that is stored exactly (see json_int_traits_alloc)
+    int64,
+    /// An unsigned integer that is stored exactly
+    uint64,
+};
+
+/**
+ * A single node of a tape. Containers are followed directly by their members,
+ * and a mapping member is a string entry for the key followed by the value.
+ *
+ * - For a boolean, `flag` holds the value.
+ * - For a number, `payload` holds the bits of the double.
+ * - For an int64 or a uint64, `payload` holds the bits of the integer.
+ * - For a string, `size` is the length and `payload` is the offset of the
+ *   characters in the string buffer of the tape.
+ * - For a container, `size` is the number of members and `payload` is the
+ *   number of entries in the container, including its own, so that the next
+ *   sibling of a container can be found without visiting its members.
+ *
+ * Entries are trivially copyable and contain no pointers. They have no padding,
+ * so that every byte of a snapshot is written from initialized data.
+ */
+struct tape_entry {
+    tape_kind     kind     = tape_kind::null;
+    bool          flag     = false;
+    std::uint16_t reserved = 0;
+    std::uint32_t size     = 0;
+    std::uint64_t payload  = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<tape_entry>);
+static_assert(std::has_unique_object_representations_v<tape_entry>);
+
+namespace detail {
+
+/**
+ * Appends entries and strings to a tape being built. Containers are opened with
+ * open(), which returns a position that is passed to close() once the members
+ * have been appended.
+ */
+class tape_builder {
+    std::vector<tape_entry> _entries;
+    std::string             _strings;
+
+    template <typename Size>
+    static std::uint32_t _narrow(Size n) {
+        if (n > Size(UINT32_MAX)) {
+            SEMESTER_THROW(std::length_error("Value is too large to be stored in a tape"));
+        }
+        return static_cast<std::uint32_t>(n);
+    }
+
+public:
+    void push_null() { _entries.push_back({tape_kind::null}); }
+    void push_bool(bool b) { _entries.push_back({tape_kind::boolean, b}); }
+
+    void push_number(double d) {
+        tape_entry& ent = _entries.emplace_back(tape_entry{tape_kind::number});
+        std::memcpy(&ent.payload, &d, sizeof d);
+    }
+
+    void push_int64(std::int64_t n) {
+        _entries.push_back({tape_kind::int64, false, 0, 0, static_cast<std::uint64_t>(n)});
+    }
+
+    void push_uint64(std::uint64_t n) { _entries.push_back({tape_kind::uint64, false, 0, 0, n}); }
+
+    void push_string(std::string_view str) {
+        _entries.push_back({tape_kind::string, false, 0, _narrow(str.size()), _strings.size()});
+        _strings.append(str);
+    }
+
+    /// The string buffer, for appending a decoded string directly
+    std::string& strings() noexcept { return _strings; }
+
+    /// Push a string entry for the characters at [offset, end) of the string buffer
+    void push_string_from(std::size_t offset) {
+        _entries.push_back(
+            {tape_kind::string, false, 0, _narrow(_strings.size() - offset), offset});
+    }
+
+    std::size_t open(tape_kind kind) {
+        _entries.push_back({kind});
+        return _entries.size() - 1;
+    }
+
+    void close(std::size_t pos, std::size_t n_members) {
+        _entries[pos].size    = _narrow(n_members);
+        _entries[pos].payload = _entries.size() - pos;
+    }
+
+    std::vector<tape_entry>& entries() noexcept { return _entries; }
+};
+
+}  // namespace detail
+
+/**
+ * A read-only handle to a value within a tape. Handles are cheap to copy, and
+ * are valid as long as the tape that they refer to.
+ *
+ * This supports the same try_get() protocol as basic_data, so the walk_ops can
+ * run directly over a tape. Strings are std::string_views into the tape, but may
+ * also be requested as std::strings. The `mapping_type` and `array_type` of a
+ * tape_node are views that iterate the members of the container in order.
+ *
+ * Integers that were stored exactly are read with `int_type` and `uint_type`,
+ * when they are in the range of the requested type. They may also be read as
+ * `number_type`, which rounds them beyond 2^53.
+ */
+class tape_node {
+public:
+    class mapping_type;
+    class array_type;
+
+    using null_type   = null_t;
+    using bool_type   = bool;
+    using number_type = double;
+    using string_type = std::string_view;
+    using int_type    = std::int64_t;
+    using uint_type   = std::uint64_t;
+
+private:
+    template <bool Keyed>
+    class _member_iterator;
+
+    const tape_entry* _entry   = nullptr;
+    const char*       _strings = nullptr;
+
+    /// Get the entry following the value at `ent`
+    static const tape_entry* _next(const tape_entry* ent) noexcept {
+        if (ent->kind == tape_kind::mapping || ent->kind == tape_kind::array) {
+            return ent + ent->payload;
+        }
+        return ent + 1;
+    }
+
+    std::int64_t _int64() const noexcept {
+        std::int64_t n = 0;
+        std::memcpy(&n, &_entry->payload, sizeof n);
+        return n;
+    }
+
+    std::string_view _string() const noexcept {
+        return std::string_view(_strings + _entry->payload, _entry->size);
+    }
+
+public:
+    /**
+     * Create a handle for the value at `entry`, whose strings are stored at
+     * `strings`.
+     */
+    constexpr tape_node(const tape_entry* entry, const char* strings) noexcept
+        : _entry(entry)
+        , _strings(strings) {}
+
+    constexpr static bool supports_mappings = true;
+    constexpr static bool supports_arrays   = true;
+
+    tape_kind kind() const noexcept { return _entry->kind; }
+
+    bool is_null() const noexcept { return kind() == tape_kind::null; }
+    bool is_bool() const noexcept { return kind() == tape_kind::boolean; }
+    bool is_number() const noexcept { return kind() == tape_kind::number || is_integer(); }
+    bool is_integer() const noexcept {
+        return kind() == tape_kind::int64 || kind() == tape_kind::uint64;
+    }
+    bool is_string() const noexcept { return kind() == tape_kind::string; }
+    bool is_mapping() const noexcept { return kind() == tape_kind::mapping; }
+    bool is_array() const noexcept { return kind() == tape_kind::array; }
+
+    /// The number of members of a container, or the length of a string
+    std::size_t size() const noexcept { return _entry->size; }
+
+    // clang-format off
+    template <typename T>
+        requires (neo::same_as<T, null_type>    ||
+                  neo::same_as<T, bool_type>    ||
+                  neo::same_as<T, number_type>  ||
+                  neo::same_as<T, int_type>     ||
+                  neo::same_as<T, uint_type>    ||
+                  neo::same_as<T, string_type>  ||
+                  neo::same_as<T, std::string>  ||
+                  neo::same_as<T, mapping_type> ||
+                  neo::same_as<T, array_type>)
+    value_holder<T> try_get() const noexcept(!neo::same_as<T, std::string>) {
+        // clang-format on
+        if constexpr (neo::same_as<T, null_type>) {
+            return is_null() ? value_holder<T>(null) : std::nullopt;
+        } else if constexpr (neo::same_as<T, bool_type>) {
+            return is_bool() ? value_holder<T>(_entry->flag) : std::nullopt;
+        } else if constexpr (neo::same_as<T, number_type>) {
+            if (kind() == tape_kind::int64) {
+                return value_holder<T>(static_cast<number_type>(_int64()));
+            } else if (kind() == tape_kind::uint64) {
+                return value_holder<T>(static_cast<number_type>(_entry->payload));
+            } else if (!is_number()) {
+                return std::nullopt;
+            }
+            number_type n = 0;
+            std::memcpy(&n, &_entry->payload, sizeof n);
+            return value_holder<T>(n);
+        } else if constexpr (neo::same_as<T, int_type> || neo::same_as<T, uint_type>) {
+            // Either integer kind is given, if the value is in the range of T
+            constexpr auto int_max = static_cast<std::uint64_t>(INT64_MAX);
+            if (kind() == tape_kind::int64 && (neo::same_as<T, int_type> || _int64() >= 0)) {
+                return value_holder<T>(static_cast<T>(_int64()));
+            } else if (kind() == tape_kind::uint64
+                       && (neo::same_as<T, uint_type> || _entry->payload <= int_max)) {
+                return value_holder<T>(static_cast<T>(_entry->payload));
+            }
+            return std::nullopt;
+        } else if constexpr (neo::same_as<T, string_type> || neo::same_as<T, std::string>) {
+            return is_string() ? value_holder<T>(T(_string())) : std::nullopt;
+        } else {
+            if (kind() != (neo::same_as<T, mapping_type> ? tape_kind::mapping : tape_kind::array)) {
+                return std::nullopt;
+            }
+            return value_holder<T>(T(*this));
+        }
+    }
+};
+
+/**
+ * Iterates the members of a mapping or the elements of an array in a tape.
+ */
+template <bool Keyed>
+class tape_node::_member_iterator {
+    const tape_entry* _pos     = nullptr;
+    const char*       _strings = nullptr;
+
+public:
+    using difference_type = std::ptrdiff_t;
+    using value_type
+        = std::conditional_t<Keyed, std::pair<std::string_view, tape_node>, tape_node>;
+
+    _member_iterator() = default;
+    _member_iterator(const tape_entry* pos, const char* strings) noexcept
+        : _pos(pos)
+        , _strings(strings) {}
+
+    value_type operator*() const noexcept {
+        if constexpr (Keyed) {
+            return value_type(tape_node(_pos, _strings)._string(), tape_node(_pos + 1, _strings));
+        } else {
+            return tape_node(_pos, _strings);
+        }
+    }
+
+    _member_iterator& operator++() noexcept {
+        _pos = tape_node::_next(Keyed ? _pos + 1 : _pos);
+        return *this;
+    }
+
+    _member_iterator operator++(int) noexcept {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    bool operator==(const _member_iterator& other) const noexcept { return _pos == other._pos; }
+};
+
+/**
+ * A view of the members of a mapping in a tape. Iterating yields pairs of the
+ * key and a tape_node for the value, in the order that they were stored.
+ */
+class tape_node::mapping_type {
+    tape_node _node;
+
+public:
+    using iterator = tape_node::_member_iterator<true>;
+
+    explicit mapping_type(tape_node node) noexcept
+        : _node(node) {}
+
+    iterator    begin() const noexcept { return iterator(_node._entry + 1, _node._strings); }
+    iterator    end() const noexcept { return iterator(_next(_node._entry), _node._strings); }
+    std::size_t size() const noexcept { return _node.size(); }
+    bool        empty() const noexcept { return size() == 0; }
+
+    /// Find the first member with the given key. This is a linear search.
+    iterator find(std::string_view key) const noexcept {
+        auto it = begin();
+        for (; it != end(); ++it) {
+            if ((*it).first == key) {
+                break;
+            }
+        }
+        return it;
+    }
+};
+
+/**
+ * A view of the elements of an array in a tape. Iterating yields a tape_node
+ * for each element.
+ */
+class tape_node::array_type {
+    tape_node _node;
+
+public:
+    using iterator = tape_node::_member_iterator<false>;
+
+    explicit array_type(tape_node node) noexcept
+        : _node(node) {}
+
+    iterator    begin() const noexcept { return iterator(_node._entry + 1, _node._strings); }
+    iterator    end() const noexcept { return iterator(_next(_node._entry), _node._strings); }
+    std::size_t size() const noexcept { return _node.size(); }
+    bool        empty() const noexcept { return size() == 0; }
+};
+
+/**
+ * A read-only document whose nodes are stored in a single contiguous array of
+ * tape_entry, in the order that a depth-first walk would visit them. The
+ * characters of every string are stored after the entries, in the same
+ * allocation. Iteration is a linear scan, and a tape is freed with a single
+ * deallocation.
+ *
+ * Build a tape from JSON-shaped data with tape_document::from_data(), or parse
+ * JSON text directly into a tape with parse_json_tape().
+ */
+class tape_document {
+    std::unique_ptr<tape_entry[]> _block;
+    std::size_t                   _n_entries = 0;
+    std::size_t                   _n_chars   = 0;
+
+    template <typename Data>
+    static void _append(detail::tape_builder& out, const Data& dat) {
+        using traits = typename Data::traits_type;
+        dat.visit([&](const auto& val) {
+            using type = std::remove_cvref_t<decltype(val)>;
+            if constexpr (neo::same_as<type, typename traits::null_type>) {
+                out.push_null();
+            } else if constexpr (neo::same_as<type, typename traits::bool_type>) {
+                out.push_bool(val);
+            } else if constexpr (std::is_integral_v<type> && std::is_signed_v<type>) {
+                // An integer alternative (see json_int_traits_alloc) is kept exactly
+                out.push_int64(static_cast<std::int64_t>(val));
+            } else if constexpr (std::is_integral_v<type>) {
+                out.push_uint64(static_cast<std::uint64_t>(val));
+            } else if constexpr (std::is_arithmetic_v<type>) {
+                out.push_number(static_cast<double>(val));
+            } else if constexpr (neo::same_as<type, typename traits::string_type>) {
+                out.push_string(std::string_view(val));
+            } else if constexpr (neo::same_as<type, mapping_type_t<Data>>) {
+                const auto pos = out.open(tape_kind::mapping);
+                for (const auto& [key, child] : val) {
+                    out.push_string(std::string_view(key));
+                    _append(out, child);
+                }
+                out.close(pos, val.size());
+            } else {
+                static_assert(neo::same_as<type, array_type_t<Data>>,
+                              "Data cannot be stored in a tape");
+                const auto pos = out.open(tape_kind::array);
+                for (const auto& child : val) {
+                    _append(out, child);
+                }
+                out.close(pos, val.size());
+            }
+        });
+    }
+
+public:
+    tape_document() = default;
+
+    /// Take the contents of a finished builder, and copy them into one block
+    explicit tape_document(detail::tape_builder&& builder) {
+        const auto& entries = builder.entries();
+        const auto& chars   = builder.strings();
+        _n_entries          = entries.size();
+        _n_chars            = chars.size();
+        const auto n_tail   = (_n_chars + sizeof(tape_entry) - 1) / sizeof(tape_entry);
+        _block.reset(new tape_entry[_n_entries + n_tail]);
+        std::copy(entries.begin(), entries.end(), _block.get());
+        std::memcpy(_block.get() + _n_entries, chars.data(), _n_chars);
+    }
+
+    /**
+     * Build a tape from JSON-shaped data. Mapping members are stored in the order
+     * that the data's mapping_type iterates them.
+     */
+    template <json_shaped_data Data>
+    static tape_document from_data(const Data& dat) {
+        detail::tape_builder builder;
+        _append(builder, dat);
+        return tape_document(std::move(builder));
+    }
+
+    /// Whether the document is empty (default-constructed)
+    bool empty() const noexcept { return _n_entries == 0; }
+
+    /// The root of the document. The document must not be empty.
+    tape_node root() const noexcept { return tape_node(_block.get(), strings().data()); }
+
+    /// The entries of the tape
+    const tape_entry* entries() const noexcept { return _block.get(); }
+    std::size_t       entry_count() const noexcept { return _n_entries; }
+
+    /// The characters of all strings of the tape
+    std::string_view strings() const noexcept {
+        return std::string_view(reinterpret_cast<const char*>(_block.get() + _n_entries),
+                                _n_chars);
+    }
+};
+
+namespace detail {
+
+/**
+ * A JSON parser that appends to a tape_builder rather than building a tree.
+ */
+class json_tape_parser : public json_cursor {
+    json_parse_options _opts;
+    tape_builder&      _out;
+
+    bool _parse_string() {
+        const auto offset = _out.strings().size();
+        if (!parse_string(_out.strings())) {
+            return false;
+        }
+        _out.push_string_from(offset);
+        return true;
+    }
+
+    template <char Close>
+    bool _parse_container(tape_kind kind, std::size_t depth) {
+        if (depth == _opts.max_depth) {
+            return _fail(json_errc::too_deep);
+        }
+        const auto  pos       = _out.open(kind);
+        std::size_t n_members = 0;
+        ++_it;
+        _it = skip_json_ws(_it, _end);
+        if (_it != _end && *_it == Close) {
+            ++_it;
+            _out.close(pos, 0);
+            return true;
+        }
+        while (true) {
+            if constexpr (Close == '}') {
+                if (_it == _end || *_it != '"') {
+                    return _fail_at_end_or(json_errc::unexpected_character);
+                }
+                if (!_parse_string()) {
+                    return false;
+                }
+                _it = skip_json_ws(_it, _end);
+                if (_it == _end || *_it != ':') {
+                    return _fail_at_end_or(json_errc::unexpected_character);
+                }
+                _it = skip_json_ws(_it + 1, _end);
+            }
+            if (!parse_value(depth + 1)) {
+                return false;
+            }
+            ++n_members;
+            _it = skip_json_ws(_it, _end);
+            if (_it == _end) {
+                return _fail(json_errc::unexpected_end);
+            }
+            if (*_it == ',') {
+                _it = skip_json_ws(_it + 1, _end);
+            } else if (*_it == Close) {
+                ++_it;
+                _out.close(pos, n_members);
+                return true;
+            } else {
+                return _fail(json_errc::unexpected_character);
+            }
+        }
+    }
+
+public:
+    json_tape_parser(std::string_view text, json_parse_options opts, tape_builder& out) noexcept
+        : json_cursor(text)
+        , _opts(opts)
+        , _out(out) {}
+
+    bool parse_value(std::size_t depth) {
+        if (_it == _end) {
+            return _fail(json_errc::unexpected_end);
+        }
+        switch (*_it) {
+        case '{':
+            return _parse_container<'}'>(tape_kind::mapping, depth);
+        case '[':
+            return _parse_container<']'>(tape_kind::array, depth);
+        case '"':
+            return _parse_string();
+        case 't':
+            _out.push_bool(true);
+            return _literal("true");
+        case 'f':
+            _out.push_bool(false);
+            return _literal("false");
+        case 'n':
+            _out.push_null();
+            return _literal("null");
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9': {
+            double n = 0;
+            if (!parse_number(n)) {
+                return false;
+            }
+            _out.push_number(n);
+            return true;
+        }
+        default:
+            return _fail(json_errc::unexpected_character);
+        }
+    }
+
+    bool parse_document() {
+        _it = skip_json_ws(_it, _end);
+        if (!parse_value(0)) {
+            return false;
+        }
+        _it = skip_json_ws(_it, _end);
+        if (_it != _end) {
+            return _fail(json_errc::trailing_characters);
+        }
+        return true;
+    }
+};
+
+}  // namespace detail
+
+/**
+ * Parse JSON text directly into a tape, without building a tree. Members of
+ * objects are stored in the order that they appear in the text, including any
+ * duplicate keys. On failure, returns a result with `error` set rather than
+ * throwing.
+ */
+inline json_parse_result<tape_document> try_parse_json_tape(std::string_view   text,
+                                                            json_parse_options opts = {}) {
+    json_parse_result<tape_document> ret;
+    detail::tape_builder             builder;
+    detail::json_tape_parser         parser{text, opts, builder};
+    if (!parser.parse_document()) {
+        ret.error  = parser.error;
+        ret.offset = parser.offset();
+    } else {
+        ret.value = tape_document(std::move(builder));
+    }
+    return ret;
+}
+
+/**
+ * Parse JSON text directly into a tape. Throws json_parse_error if the text is
+ * not valid JSON.
+ */
+inline tape_document parse_json_tape(std::string_view text, json_parse_options opts = {}) {
+    auto result = try_parse_json_tape(text, opts);
+    if (!result) {
+        SEMESTER_THROW(json_parse_error(result.error, result.offset));
+    }
+    return std::move(result.value);
+}
+
+}  // namespace semester
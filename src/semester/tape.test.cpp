@@ -0,0 +1,150 @@
+#include <semester/tape.hpp>
+
+#include <semester/json.hpp>
+#include <semester/walk.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <neo/test_concept.hpp>
+
+#include <cmath>
+
+NEO_TEST_CONCEPT(semester::supports_mappings<semester::tape_node>);
+NEO_TEST_CONCEPT(semester::supports_arrays<semester::tape_node>);
+NEO_TEST_CONCEPT(semester::supports_try_get<semester::tape_node, std::string_view>);
+NEO_TEST_CONCEPT(semester::supports_try_get<semester::tape_node, std::string>);
+
+TEST_CASE("Build a tape from data") {
+    semester::json_data dat = semester::json_data::mapping_type{
+        {"name", "Joe"},
+        {"ids", semester::json_data::array_type{1, 2, semester::json_data::array_type{3}}},
+        {"ok", true},
+        {"nothing", semester::null},
+    };
+    auto tape = semester::tape_document::from_data(dat);
+    // {, "ids", [, 1, 2, [, 3, "name", "Joe", "nothing", null, "ok", true
+    CHECK(tape.entry_count() == 13);
+    CHECK(tape.strings() == "idsnameJoenothingok");
+
+    auto root = tape.root();
+    REQUIRE(root.is_mapping());
+    CHECK(root.size() == 4);
+
+    auto map = semester::get<semester::tape_node::mapping_type>(root);
+    auto ids = map.find("ids");
+    REQUIRE(ids != map.end());
+    auto arr = semester::get<semester::tape_node::array_type>((*ids).second);
+    CHECK(arr.size() == 3);
+    std::vector<semester::tape_kind> kinds;
+    for (auto el : arr) {
+        kinds.push_back(el.kind());
+    }
+    CHECK(kinds
+          == std::vector{semester::tape_kind::number,
+                         semester::tape_kind::number,
+                         semester::tape_kind::array});
+
+    // The next sibling of a container is found by skipping over its members
+    CHECK(semester::get<std::string_view>((*map.find("name")).second) == "Joe");
+    CHECK(semester::get<std::string>((*map.find("name")).second) == "Joe");
+    CHECK(semester::get<bool>((*map.find("ok")).second));
+    CHECK(semester::holds_alternative<semester::null_t>((*map.find("nothing")).second));
+    CHECK_FALSE(semester::holds_alternative<double>((*map.find("nothing")).second));
+    CHECK(map.find("missing") == map.end());
+}
+
+TEST_CASE("Keep integers exact in a tape") {
+    auto dat  = semester::parse_json<semester::json_int_data>(
+        R"({"id": 9007199254740993, "neg": -9007199254740993, "max": 18446744073709551615})");
+    auto tape = semester::tape_document::from_data(dat);
+    auto map  = semester::get<semester::tape_node::mapping_type>(tape.root());
+
+    auto id = (*map.find("id")).second;
+    CHECK(id.kind() == semester::tape_kind::int64);
+    CHECK(id.is_number());
+    CHECK(semester::get<std::int64_t>(id) == 9007199254740993);
+    CHECK(semester::get<std::uint64_t>(id) == 9007199254740993u);
+    // Read as a double, the integer is rounded
+    CHECK(semester::get<double>(id) == 9007199254740992.0);
+
+    auto neg = (*map.find("neg")).second;
+    CHECK(semester::get<std::int64_t>(neg) == -9007199254740993);
+    CHECK_FALSE(semester::holds_alternative<std::uint64_t>(neg));
+
+    auto max = (*map.find("max")).second;
+    CHECK(max.kind() == semester::tape_kind::uint64);
+    CHECK(semester::get<std::uint64_t>(max) == 18446744073709551615u);
+    CHECK_FALSE(semester::holds_alternative<std::int64_t>(max));
+
+    std::int64_t out = 0;
+    using namespace semester::walk_ops;
+    semester::walk(id, put_into(out));
+    CHECK(out == 9007199254740993);
+}
+
+TEST_CASE("Parse JSON into a tape") {
+    auto tape = semester::parse_json_tape(R"({"b": [1.5, "two\n", {}], "a": false, "c": []})");
+    auto root = tape.root();
+
+    // Members stay in the order of the text
+    std::vector<std::string_view> keys;
+    for (auto [key, value] : semester::get<semester::tape_node::mapping_type>(root)) {
+        keys.push_back(key);
+    }
+    CHECK(keys == std::vector<std::string_view>{"b", "a", "c"});
+
+    auto b = semester::get<semester::tape_node::array_type>(
+        (*semester::get<semester::tape_node::mapping_type>(root).find("b")).second);
+    auto it = b.begin();
+    CHECK(semester::get<double>(*it++) == 1.5);
+    CHECK(semester::get<std::string_view>(*it++) == "two\n");
+    CHECK((*it++).is_mapping());
+    CHECK(it == b.end());
+    CHECK(std::signbit(semester::get<double>(semester::parse_json_tape("-0").root())));
+
+    auto bad = semester::try_parse_json_tape(R"({"a": [1, 2,]})");
+    CHECK_FALSE(bad);
+    CHECK(bad.error == semester::json_errc::unexpected_character);
+    CHECK(bad.offset == 12);
+#if !SEMESTER_NO_EXCEPTIONS
+    CHECK_THROWS_AS(semester::parse_json_tape("[1] 2"), semester::json_parse_error);
+    CHECK_THROWS_AS(semester::parse_json_tape("[[[1]]]", {.max_depth = 2}),
+                    semester::json_parse_error);
+#endif
+}
+
+TEST_CASE("Walk a tape") {
+    auto tape = semester::parse_json_tape(R"({
+        "foo": "bar",
+        "nested": {"values": [1, 2, 3], "flag": true},
+        "baz": 33
+    })");
+
+    using namespace semester::walk_ops;
+    std::string         foo;
+    std::vector<double> values;
+    bool                flag = false;
+    semester::walk(tape.root(),
+                   mapping{
+                       required_key{"foo", "'foo' is required", put_into(foo)},
+                       if_key{"nested",
+                              mapping{
+                                  if_key{"values", for_each{put_into(std::back_inserter(values))}},
+                                  if_key{"flag", put_into(flag)},
+                              }},
+                       if_key{"baz", require_type<double>("'baz' must be a number"), just_accept},
+                   });
+    CHECK(foo == "bar");
+    CHECK(values == std::vector<double>{1, 2, 3});
+    CHECK(flag);
+
+    auto rej = semester::walk.try_walk(
+        tape.root(),
+        mapping{if_key{"nested",
+                       mapping{if_key{"values", for_each{reject_with("No values")}},
+                               if_key{"flag", just_accept}}},
+                if_key{"foo", just_accept},
+                if_key{"baz", just_accept}});
+    REQUIRE(rej.rejected());
+    CHECK(rej.rejection().message() == "<root>/nested/values[0]: No values");
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "./config.hpp"
 #include "./data.hpp"
 
 #include "./get.hpp"
@@ -8,11 +9,28 @@
 #include <neo/fwd.hpp>
 #include <neo/iterator_concepts.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <variant>
+#include <vector>
 
 namespace semester {
 
@@ -20,7 +38,266 @@ namespace semester {
 
 namespace detail {
 
-inline thread_local std::string walk_path;
+/// Append a single path segment to a string
+inline void
+append_walk_path_segment(std::string& out, bool is_key, std::string_view key, std::size_t index) {
+    if (is_key) {
+        out.push_back('/');
+        out.append(key);
+    } else {
+        out.push_back('[');
+        out.append(std::to_string(index));
+        out.push_back(']');
+    }
+}
+
+/**
+ * A copy of the walk path at the point of a rejection, stored inline so that it
+ * can be captured without allocating. Keys are copied into the snapshot, so it
+ * does not refer to the walked data. If the path is too long to be stored, the
+ * innermost segments are dropped. A snapshot may also hold an argument for the
+ * message, such as a key that was not handled.
+ */
+class walk_path_snapshot {
+public:
+    constexpr static std::size_t max_segments = 16;
+    constexpr static std::size_t key_capacity = 256;
+
+private:
+    struct segment {
+        std::uint16_t key_offset;
+        std::uint16_t key_size;
+        bool          is_key;
+        std::size_t   index;
+    };
+
+    segment       _segments[max_segments];
+    char          _keys[key_capacity];
+    std::uint16_t _n_segments = 0;
+    std::uint16_t _keys_size  = 0;
+    /// The argument is stored at the beginning of _keys
+    std::uint16_t _arg_size  = 0;
+    bool          _truncated = false;
+
+public:
+    /**
+     * Set the argument of the message. This must be done before any segment is
+     * pushed, and an argument that does not fit is cut short.
+     */
+    void set_argument(std::string_view arg) noexcept {
+        arg = arg.substr(0, key_capacity);
+        std::copy(arg.begin(), arg.end(), _keys);
+        _arg_size  = static_cast<std::uint16_t>(arg.size());
+        _keys_size = _arg_size;
+    }
+
+    std::string_view argument() const noexcept { return std::string_view(_keys, _arg_size); }
+
+    /// Append a segment, unless there is no room for it
+    void push(std::string_view key, std::size_t index, bool is_key) noexcept {
+        if (_truncated || _n_segments == max_segments || key.size() > key_capacity - _keys_size) {
+            _truncated = true;
+            return;
+        }
+        std::copy(key.begin(), key.end(), _keys + _keys_size);
+        const auto key_size      = static_cast<std::uint16_t>(key.size());
+        _segments[_n_segments++] = {_keys_size, key_size, is_key, index};
+        _keys_size               = static_cast<std::uint16_t>(_keys_size + key_size);
+    }
+
+    /// Format the path, e.g. `<root>/foo/bar[2]`
+    std::string str() const {
+        std::string ret = "<root>";
+        for (auto it = _segments; it != _segments + _n_segments; ++it) {
+            const auto key = std::string_view(_keys + it->key_offset, it->key_size);
+            append_walk_path_segment(ret, it->is_key, key, it->index);
+        }
+        if (_truncated) {
+            ret.append("/...");
+        }
+        return ret;
+    }
+};
+
+/**
+ * Tracks the position of the current walk within the data as a stack of
+ * segments. Keys are held by reference, so a segment must be popped before the
+ * key that it refers to is destroyed. The path is only formatted as a string
+ * when a message needs it.
+ */
+class walk_path_stack {
+    struct segment {
+        std::string_view key;
+        std::size_t      index;
+        bool             is_key;
+    };
+
+    std::vector<segment> _segments;
+
+public:
+    void push_key(std::string_view key) { _segments.push_back({key, 0, true}); }
+    void push_index(std::size_t index) { _segments.push_back({{}, index, false}); }
+    void pop() noexcept { _segments.pop_back(); }
+
+    /// Copy the current path into a snapshot
+    walk_path_snapshot snapshot() const noexcept {
+        walk_path_snapshot ret;
+        for (const auto& seg : _segments) {
+            ret.push(seg.key, seg.index, seg.is_key);
+        }
+        return ret;
+    }
+
+    /**
+     * Copy the path of the enclosing mapping into a snapshot, with the key of
+     * the current segment as its argument. If the current segment is not a key,
+     * this is the same as snapshot().
+     */
+    walk_path_snapshot key_snapshot() const noexcept {
+        if (_segments.empty() || !_segments.back().is_key) {
+            return snapshot();
+        }
+        walk_path_snapshot ret;
+        ret.set_argument(_segments.back().key);
+        for (auto it = _segments.begin(); it != _segments.end() - 1; ++it) {
+            ret.push(it->key, it->index, it->is_key);
+        }
+        return ret;
+    }
+
+    /// Format the path, e.g. `<root>/foo/bar[2]`
+    std::string str() const {
+        std::string ret = "<root>";
+        for (const auto& seg : _segments) {
+            append_walk_path_segment(ret, seg.is_key, seg.key, seg.index);
+        }
+        return ret;
+    }
+};
+
+inline thread_local walk_path_stack walk_path;
+
+struct walk_path_node {
+    std::atomic<int>   refs{1};
+    walk_path_snapshot snapshot;
+    walk_path_node*    next_free = nullptr;
+};
+
+/// Set once the free list of the thread is destroyed, after which nodes are deleted
+inline thread_local bool walk_path_free_closed = false;
+
+/// The released walk_path_nodes of a thread, kept for reuse
+struct walk_path_free_list {
+    constexpr static std::size_t max_size = 8;
+
+    walk_path_node* head = nullptr;
+    std::size_t     size = 0;
+
+    ~walk_path_free_list() {
+        while (head) {
+            delete std::exchange(head, head->next_free);
+        }
+        walk_path_free_closed = true;
+    }
+};
+
+inline thread_local walk_path_free_list walk_path_free;
+
+/**
+ * A shared, immutable snapshot of the walk path, held by a rejection. The
+ * storage of a released snapshot is kept on a short per-thread free list and
+ * reused by the next rejection on that thread. A walk reserves storage on each
+ * of its threads before it begins, so recording the path of a rejection does
+ * not allocate. A record may be copied and released on any thread.
+ */
+class walk_path_record {
+    walk_path_node* _node = nullptr;
+
+    void _release() noexcept {
+        if (!_node || _node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        auto& free = walk_path_free;
+        if (walk_path_free_closed || free.size == free.max_size) {
+            delete _node;
+            return;
+        }
+        _node->next_free = std::exchange(free.head, _node);
+        ++free.size;
+    }
+
+    static walk_path_record _acquire() {
+        walk_path_record ret;
+        auto&            free = walk_path_free;
+        if (!walk_path_free_closed && free.head) {
+            ret._node = std::exchange(free.head, free.head->next_free);
+            --free.size;
+            ret._node->refs.store(1, std::memory_order_relaxed);
+        } else {
+            ret._node = new walk_path_node;
+        }
+        return ret;
+    }
+
+public:
+    walk_path_record() = default;
+
+    /// Make sure that the next record captured on this thread does not allocate
+    static void reserve() {
+        auto& free = walk_path_free;
+        if (!walk_path_free_closed && !free.head) {
+            free.head = new walk_path_node;
+            free.size = 1;
+        }
+    }
+
+    walk_path_record(const walk_path_record& other) noexcept
+        : _node(other._node) {
+        if (_node) {
+            _node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    walk_path_record(walk_path_record&& other) noexcept
+        : _node(std::exchange(other._node, nullptr)) {}
+
+    walk_path_record& operator=(walk_path_record other) noexcept {
+        std::swap(_node, other._node);
+        return *this;
+    }
+
+    ~walk_path_record() { _release(); }
+
+    /// Record the current walk path of this thread
+    static walk_path_record capture() {
+        auto ret            = _acquire();
+        ret._node->snapshot = walk_path.snapshot();
+        return ret;
+    }
+
+    /// Record the path of the current mapping, with the current key as the argument
+    static walk_path_record capture_key() {
+        auto ret            = _acquire();
+        ret._node->snapshot = walk_path.key_snapshot();
+        return ret;
+    }
+
+    explicit operator bool() const noexcept { return _node != nullptr; }
+    const walk_path_snapshot* operator->() const noexcept { return &_node->snapshot; }
+};
+
+/**
+ * Pushes a segment onto the walk path for the duration of a scope
+ */
+class walk_path_scope {
+public:
+    explicit walk_path_scope(std::string_view key) { walk_path.push_key(key); }
+    explicit walk_path_scope(std::size_t index) { walk_path.push_index(index); }
+    ~walk_path_scope() { walk_path.pop(); }
+
+    walk_path_scope(const walk_path_scope&) = delete;
+    walk_path_scope& operator=(const walk_path_scope&) = delete;
+};
 
 template <typename Func, typename = void>
 struct inspect_visitor {};
@@ -74,6 +351,33 @@ concept vst_invocable_for =
         &std::remove_cvref_t<Func>::operator();
     };
 
+/**
+ * Matches data whose try_get<T>() is decided by the index of its variant alone,
+ * as it is for basic_data: it yields a T exactly when the alternative is a T,
+ * or a box of a T.
+ */
+template <typename Data>
+concept variant_indexed_data = requires(const std::remove_cvref_t<Data>& dat) {
+    typename std::remove_cvref_t<Data>::variant_type;
+    { dat.variant() } -> neo::same_as<const typename std::remove_cvref_t<Data>::variant_type&>;
+};
+
+template <typename T, typename Alt>
+constexpr bool walk_alt_matches = std::is_same_v<T, Alt> || is_box_of<T, Alt>;
+
+/**
+ * The index of the alternative of `Variant` from which try_get<T>() reads, or
+ * std::variant_npos if there is none.
+ */
+template <typename Variant, typename T>
+constexpr std::size_t walk_alt_index = []<std::size_t... Is>(std::index_sequence<Is...>) {
+    std::size_t idx = std::variant_npos;
+    static_cast<void>(
+        ((walk_alt_matches<T, std::variant_alternative_t<Is, Variant>> && (idx = Is, true))
+         || ...));
+    return idx;
+}(std::make_index_sequence<std::variant_size_v<Variant>>());
+
 struct ident_project {
     template <typename T>
     constexpr T&& operator()(T&& t) const noexcept {
@@ -81,8 +385,281 @@ struct ident_project {
     }
 };
 
+/**
+ * Matches a mapping key handler that only handles a single known key. Such a
+ * handler provides `key()`, and `matched(data)` to handle the data for its key
+ * without comparing the key again.
+ */
+template <typename H>
+concept keyed_handler = requires(const H& h) {
+    { h.key() } -> neo::convertible_to<std::string_view>;
+};
+
+/**
+ * Matches a keyed handler whose key must be present. `required_message()` gives
+ * the rejection message for when the key is missing.
+ */
+template <typename H>
+concept required_handler = keyed_handler<H> && requires(const H& h) {
+    h.required_message();
+};
+
+/// A cheap hash of a mapping key, using its length and a few of its characters
+constexpr std::size_t hash_walk_key(std::string_view key) noexcept {
+    std::size_t h = key.size() * 0x9e3779b1u;
+    if (!key.empty()) {
+        const auto c = [&](std::size_t idx) {
+            return static_cast<std::size_t>(static_cast<unsigned char>(key[idx]));
+        };
+        const auto n = key.size();
+        h ^= (c(0) | (c(n / 2) << 8) | (c(n - 1) << 16) | (c(n > 1 ? n - 2 : 0) << 24))
+            * std::size_t(0x85ebca6bu);
+        h ^= h >> 15;
+    }
+    return h;
+}
+
+/**
+ * A hash table mapping the keys of a mapping's key handlers to the indices of
+ * the handlers for that key. The table does not store the keys themselves; the
+ * caller provides them (so that the table remains valid when the handlers are
+ * copied or moved).
+ */
+template <std::size_t N>
+class key_dispatch_table {
+    constexpr static std::size_t n_slots = std::bit_ceil(N * 2 + 1);
+
+    struct slot {
+        std::uint16_t first = 0;
+        std::uint16_t count = 0;
+    };
+
+    std::array<slot, n_slots>    _slots{};
+    std::array<std::uint16_t, N> _keyed{};
+    std::array<std::uint16_t, N> _keyless{};
+    std::uint16_t                _n_keyless = 0;
+
+    template <typename KeyOf>
+    constexpr std::size_t _find_slot(std::string_view key, KeyOf& key_of) const noexcept {
+        auto idx = hash_walk_key(key) & (n_slots - 1);
+        while (_slots[idx].count && key_of(_keyed[_slots[idx].first]) != key) {
+            idx = (idx + 1) & (n_slots - 1);
+        }
+        return idx;
+    }
+
+public:
+    /**
+     * Build the table. `key_of(i)` must return an optional with the key of
+     * handler `i`, or nullopt if the handler is not keyed.
+     */
+    template <typename KeyOf>
+    constexpr explicit key_dispatch_table(KeyOf&& key_of) noexcept {
+        static_assert(N < 0xffff, "Too many handlers in a single mapping");
+        // Find the slot of every keyed handler
+        std::array<std::size_t, N> slot_of{};
+        auto                       key_at  = [&](std::size_t i) { return *key_of(i); };
+        std::uint16_t              n_keyed = 0;
+        for (std::uint16_t i = 0; i < N; ++i) {
+            if (!key_of(i)) {
+                _keyless[_n_keyless++] = i;
+                continue;
+            }
+            auto& sl = _slots[_find_slot(*key_of(i), key_at)];
+            if (sl.count == 0) {
+                // First handler for this key. Temporarily record it for lookups.
+                sl.first        = n_keyed;
+                _keyed[n_keyed] = i;
+            }
+            ++sl.count;
+            slot_of[i] = static_cast<std::size_t>(&sl - _slots.data());
+            ++n_keyed;
+        }
+        // Group the handlers for each key together, in order
+        std::uint16_t next = 0;
+        for (auto& sl : _slots) {
+            if (sl.count) {
+                const auto slot_idx = static_cast<std::size_t>(&sl - _slots.data());
+                sl.first            = next;
+                for (std::uint16_t i = 0; i < N; ++i) {
+                    if (key_of(i) && slot_of[i] == slot_idx) {
+                        _keyed[next++] = i;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Call `fn(i)` for the index of each handler that may handle `key`, in
+     * order, until `fn` returns `true`. `key_of(i)` must return the key of the
+     * keyed handler `i`. Returns whether `fn` returned `true`.
+     */
+    template <typename KeyOf, typename Fn>
+    constexpr bool find_handler(std::string_view key, KeyOf&& key_of, Fn&& fn) const {
+        const auto& sl          = _slots[_find_slot(key, key_of)];
+        const auto* keyed       = _keyed.data() + sl.first;
+        const auto* keyed_end   = keyed + sl.count;
+        const auto* keyless     = _keyless.data();
+        const auto* keyless_end = keyless + _n_keyless;
+        while (keyed != keyed_end || keyless != keyless_end) {
+            const bool take_keyed
+                = keyless == keyless_end || (keyed != keyed_end && *keyed < *keyless);
+            if (fn(take_keyed ? *keyed++ : *keyless++)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/// An integral type other than bool, which put_into converts to with a range check
+template <typename T>
+concept put_integer = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+/**
+ * Convert `n` to the integer `Int`, failing if it is not an integer or is out
+ * of the range of `Int`. Never allocates.
+ */
+template <put_integer Int, typename Number>
+bool checked_integral_cast(Number n, Int& out) noexcept {
+    using limits = std::numeric_limits<Int>;
+    if constexpr (std::is_floating_point_v<Number>) {
+        // Both bounds are powers of two, and exact in the floating-point type
+        constexpr auto upper = static_cast<Number>(limits::max() / 2 + 1) * 2;
+        constexpr auto lower = std::is_signed_v<Int> ? -upper : Number(0);
+        // Written so that NaN is rejected
+        if (!(n >= lower && n < upper) || std::trunc(n) != n) {
+            return false;
+        }
+    } else if constexpr (std::is_signed_v<Number> && !std::is_signed_v<Int>) {
+        if (n < 0 || static_cast<std::make_unsigned_t<Number>>(n) > limits::max()) {
+            return false;
+        }
+    } else if constexpr (!std::is_signed_v<Number> && std::is_signed_v<Int>) {
+        if (n > static_cast<std::make_unsigned_t<Int>>(limits::max())) {
+            return false;
+        }
+    } else if (n < limits::min() || n > limits::max()) {
+        return false;
+    }
+    out = static_cast<Int>(n);
+    return true;
+}
+
+/// Matches data with a numeric alternative that put_into can convert to an integer or float
+template <typename Data>
+concept put_integer_source = variant_indexed_data<Data>
+    && []<typename... Alts>(std::variant<Alts...>*) {
+           return ((std::is_arithmetic_v<Alts> && !std::is_same_v<Alts, bool>) || ...);
+       }(static_cast<typename std::remove_cvref_t<Data>::variant_type*>(nullptr));
+
+/**
+ * Call `fn` with the number held by `dat`, branching once on the index of its
+ * alternative, and return its result. Returns `false` if the alternative is not
+ * a number.
+ */
+template <typename Data, typename Fn>
+bool visit_number(const Data& dat, Fn&& fn) noexcept {
+    const auto& var = dat.variant();
+    using variant   = std::remove_cvref_t<decltype(var)>;
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        bool ok = false;
+        static_cast<void>(((var.index() == Is && ([&] {
+                                using alt = std::variant_alternative_t<Is, variant>;
+                                if constexpr (put_integer<alt> || std::is_floating_point_v<alt>) {
+                                    ok = fn(*std::get_if<Is>(&var));
+                                }
+                            }(),
+                            true))
+                           || ...));
+        return ok;
+    }(std::make_index_sequence<std::variant_size_v<variant>>{});
+}
+
+/**
+ * Store the number held by `dat` into `out`. Fails if the alternative is not a
+ * number, or if the number does not convert exactly.
+ */
+template <put_integer Int, typename Data>
+bool put_integral(Int& out, const Data& dat) noexcept {
+    return visit_number(dat, [&](auto n) { return checked_integral_cast(n, out); });
+}
+
+/**
+ * Store the number held by `dat` into `out`, rounding integers that the
+ * floating-point type cannot represent. Fails if the alternative is not a
+ * number.
+ */
+template <typename Float, typename Data>
+bool put_floating(Float& out, const Data& dat) noexcept {
+    return visit_number(dat, [&](auto n) {
+        out = static_cast<Float>(n);
+        return true;
+    });
+}
+
+/**
+ * Holds the target of a put_into. Output iterators that are stored by value
+ * must be modified when they are written through, so they are mutable: A
+ * put_into refers to its destination, and writing through a const put_into is
+ * no different from writing through a const reference.
+ */
+template <typename T>
+struct put_target {
+    mutable T value;
+
+    constexpr T& get() const noexcept { return value; }
+};
+
+template <typename T>
+struct put_target<T&> {
+    T& value;
+
+    constexpr T& get() const noexcept { return value; }
+};
+
 }  // namespace detail
 
+/**
+ * A string that can be used as a template argument
+ */
+template <std::size_t N>
+struct fixed_string {
+    char chars[N] = {};
+
+    constexpr fixed_string(const char (&str)[N]) noexcept { std::copy_n(str, N, chars); }
+
+    constexpr std::string_view view() const noexcept { return std::string_view(chars, N - 1); }
+};
+
+/**
+ * A mapping key that is known at compile time. Pass one to if_key or
+ * required_key in place of a runtime key string. Create one with the `_key`
+ * literal (from semester::walk_ops or semester::literals), e.g. `"foo"_key`.
+ */
+template <fixed_string Key>
+struct static_key {
+    constexpr static std::string_view value = Key.view();
+
+    template <typename Other>
+    constexpr static bool matches(const Other& other) noexcept {
+        // Comparing the size first allows the comparison of the characters to
+        // be specialized for the length of the key
+        const auto str = std::string_view(other);
+        return str.size() == value.size() && str == value;
+    }
+};
+
+inline namespace literals {
+
+template <fixed_string Key>
+constexpr static_key<Key> operator""_key() noexcept {
+    return {};
+}
+
+}  // namespace literals
+
 struct walk_error : std::runtime_error {
     using std::runtime_error::runtime_error;
 };
@@ -103,42 +680,201 @@ concept supports_mappings = requires(T&& t) {
     typename mapping_t<T>;
 };
 
-struct walk_reject {
-    std::string message;
+/**
+ * The reason that a walk was rejected
+ */
+enum class walk_errc {
+    /// A rejection with a message provided by a handler or by the user
+    custom,
+    /// The data did not hold the required type (see require_type)
+    wrong_type,
+    /// A mapping key was not handled by any key handler. The key is the argument
+    /// of the rejection, and the path is that of the mapping.
+    unhandled_key,
+    /// A required mapping key was not present
+    missing_required_key,
+    /// for_each was given data that is not an array
+    expected_array,
+    /// No handler of a walk_seq accepted or rejected the data
+    no_matching_handler,
+    /// put_into was given data that cannot be stored in its target
+    put_into_mismatch,
+};
+
+/// Get the fixed message text that begins the message for a rejection
+constexpr const char* describe(walk_errc ec) noexcept {
+    switch (ec) {
+    case walk_errc::custom:
+    case walk_errc::wrong_type:
+        return "";
+    case walk_errc::unhandled_key:
+        return "Unhandled key: ";
+    case walk_errc::missing_required_key:
+        return "Missing required key/property: ";
+    case walk_errc::expected_array:
+        return "Expected an array";
+    case walk_errc::no_matching_handler:
+        return "No matching handler in walk_seq<> data visitor";
+    case walk_errc::put_into_mismatch:
+        return "Incorrect type to put-into a value";
+    }
+    return "";
+}
+
+/**
+ * The text of a rejection message. Holds either a pointer to a string literal,
+ * or a reference-counted string. Copying a walk_message never allocates, so
+ * handlers can give their messages to rejections cheaply.
+ */
+class walk_message {
+    const char*                        _static = "";
+    std::shared_ptr<const std::string> _shared;
+
+public:
+    walk_message() = default;
+
+    /// Refer to a string literal
+    template <std::size_t N>
+    consteval walk_message(const char (&literal)[N]) noexcept
+        : _static(literal) {}
+
+    /// Share ownership of a copy of the given string, which may be a temporary
+    template <typename Ptr>
+    requires std::is_pointer_v<Ptr> && neo::convertible_to<Ptr, const char*>  //
+    walk_message(Ptr str)
+        : walk_message(std::string(str)) {}
+
+    /// Share ownership of a copy of the given string
+    walk_message(std::string str)
+        : _shared(std::make_shared<const std::string>(std::move(str))) {}
+
+    std::string_view view() const noexcept {
+        return _shared ? std::string_view(*_shared) : std::string_view(_static);
+    }
+};
+
+class walk_reject;
+
+/**
+ * The message of a walk_reject, which holds the parts of the message and
+ * formats them only when the text is requested. The text is given by calling
+ * the message, by converting it to a std::string, or by comparing it with a
+ * string, e.g. `rej.message == "<root>: Unhandled key: foo"`.
+ */
+class walk_reject_message {
+    friend class walk_reject;
+
+    walk_errc    _code = walk_errc::custom;
+    walk_message _text;
+    /// Held out of line, so that a walk_result stays small
+    detail::walk_path_record _path;
+
+    walk_reject_message(walk_errc ec, walk_message text, detail::walk_path_record path) noexcept
+        : _code(ec)
+        , _text(std::move(text))
+        , _path(std::move(path)) {}
+
+public:
+    /// Format the full message, e.g. `<root>/foo: Missing required key/property: bar`
+    std::string str() const {
+        std::string ret;
+        if (_path) {
+            ret = _path->str();
+            ret.append(": ");
+        }
+        ret.append(describe(_code));
+        ret.append(_text.view());
+        if (_path) {
+            ret.append(_path->argument());
+        }
+        return ret;
+    }
+
+    std::string operator()() const { return str(); }
+    operator std::string() const { return str(); }
+
+    friend bool operator==(const walk_reject_message& msg, std::string_view str) {
+        return msg.str() == str;
+    }
+};
+
+/**
+ * A rejection from a walk. Rejections created by the walk_ops record an error
+ * code, a message, and a snapshot of the walk path, but the text of the message
+ * is only built when it is requested through `message`. The snapshot reuses the
+ * storage of an earlier rejection on the same thread, so rejecting does not
+ * allocate once a thread has rejected before.
+ */
+class walk_reject {
+public:
+    walk_reject_message message;
+
+    /// A rejection with exactly the given message, without a path
+    walk_reject(walk_message text) noexcept
+        : message(walk_errc::custom, std::move(text), {}) {}
+
+    /// A rejection at the current walk path. An unhandled_key rejection is
+    /// made at the path of the mapping, with the key as its argument.
+    walk_reject(walk_errc ec, walk_message text = {})
+        : message(ec,
+                  std::move(text),
+                  ec == walk_errc::unhandled_key ? detail::walk_path_record::capture_key()
+                                                 : detail::walk_path_record::capture()) {}
+
+    walk_errc code() const noexcept { return message._code; }
+
+    /// The variable part of the message, such as the message given to reject_with
+    std::string_view text() const noexcept { return message._text.view(); }
+
+    /// The path at which the rejection occurred, if it was recorded
+    std::optional<std::string> path() const {
+        return message._path ? std::make_optional(message._path->str()) : std::nullopt;
+    }
+
+    /// The argument that ends the message, such as the key that was not handled
+    std::string_view argument() const noexcept {
+        return message._path ? message._path->argument() : std::string_view();
+    }
 };
 inline constexpr struct walk_accept_t {
 } walk_accept;
 inline constexpr struct walk_pass_t {
 } walk_pass;
 
+/**
+ * The result of a walk handler: to pass, to accept, or to reject. The rejection
+ * is held even when the result is not a rejection, empty and unallocated, so
+ * that moving a result never branches on its state.
+ */
 class walk_result {
-    using variant_type = std::variant<walk_pass_t, walk_reject, walk_accept_t>;
-    variant_type _var;
+    enum class _state_t : unsigned char { pass, reject, accept };
+
+    _state_t    _state;
+    walk_reject _reject{walk_message{}};
 
 public:
-    template <neo::convertible_to<variant_type> T>
-    walk_result(T&& t) : _var(NEO_FWD(t)) {}
+    walk_result(walk_pass_t) noexcept
+        : _state(_state_t::pass) {}
+    walk_result(walk_accept_t) noexcept
+        : _state(_state_t::accept) {}
 
-    bool operator==(walk_accept_t) const noexcept {
-        return std::holds_alternative<walk_accept_t>(_var);
-    }
+    template <neo::convertible_to<walk_reject> T>
+    walk_result(T&& t)
+        : _state(_state_t::reject)
+        , _reject(NEO_FWD(t)) {}
 
-    bool operator==(walk_pass_t) const noexcept {
-        return std::holds_alternative<walk_pass_t>(_var);
-    }
+    bool operator==(walk_accept_t) const noexcept { return _state == _state_t::accept; }
+    bool operator==(walk_pass_t) const noexcept { return _state == _state_t::pass; }
 
-    bool rejected() const noexcept {
-        return std::holds_alternative<walk_reject>(_var);
-    }
+    bool rejected() const noexcept { return _state == _state_t::reject; }
 
-    auto& rejection() const noexcept {
-        return std::get<walk_reject>(_var);
-    }
+    /// Get the rejection. The result must be a rejection.
+    const walk_reject& rejection() const noexcept { return _reject; }
 
     template <typename E = walk_error>
     void throw_if_rejected() const {
         if (rejected()) {
-            throw E(rejection().message);
+            SEMESTER_THROW(E(rejection().message()));
         }
     }
 };
@@ -156,25 +892,30 @@ inline namespace walk_ops {
  *
  * If a visitor returns a walk_pass, then we continue down through the list.
  *
- * If no visitor either accepts or rejects the data, then we throw an exception.
+ * If no visitor either accepts or rejects the data, then the data is rejected
+ * with walk_errc::no_matching_handler.
+ *
+ * For basic_data, the list of visitors to try is chosen at compile time for
+ * each alternative of the variant, so a typed visitor costs nothing for data
+ * that holds some other type.
  */
 template <typename... Handlers>
 class walk_seq {
     std::tuple<Handlers...> _hs;
 
     /**
-     * Base case: No visitors matched, so we will throw.
+     * Base case: No visitors matched, so we reject the data.
      */
     template <typename Data>
-    walk_result _try_next(const Data&) const {
-        throw walk_error(detail::walk_path + ": No matching handler in walk_seq<> data visitor");
+    static walk_result _try_next(const Data&) {
+        return walk_reject{walk_errc::no_matching_handler};
     }
 
     /**
      * Recursive case. Attempt to invoke `c` with `dat`.
      */
     template <typename Data, typename Cand, typename... Tail>
-    walk_result _try_next(Data&& dat, Cand&& c, Tail&&... tail) {
+    static walk_result _try_next(Data&& dat, Cand&& c, Tail&&... tail) {
         if constexpr (bool(neo::invocable<Cand, Data>)) {
             // The visitor accepts the data object directly without conversion
             static_assert(
@@ -212,16 +953,107 @@ class walk_seq {
         }
     }
 
+    /**
+     * Check whether the visitor `Cand` can handle data that holds the alternative
+     * with index `I`. A typed visitor can only handle its own alternative, but
+     * generic visitors, and typed visitors for types that are not alternatives,
+     * are always tried.
+     */
+    template <std::size_t I, typename Data, typename Cand>
+    static constexpr bool _handles_alt() noexcept {
+        if constexpr (bool(neo::invocable<Cand, Data>) || !detail::vst_not_generic<Cand>) {
+            return true;
+        } else {
+            using variant_type = typename std::remove_cvref_t<Data>::variant_type;
+            constexpr auto alt = detail::walk_alt_index<variant_type, detail::vst_arg_t<Cand>>;
+            return alt == std::variant_npos || alt == I;
+        }
+    }
+
+    /**
+     * The indices of the visitors that can handle data holding the alternative
+     * with index `I`, in their original order, and the number of them.
+     */
+    template <std::size_t I, typename Self, typename Data>
+    static constexpr auto _alt_handlers = [] {
+        using tuple_ref = decltype((std::declval<Self&>()._hs));
+        std::array<std::size_t, sizeof...(Handlers)> idxs{};
+        std::size_t                                  count = 0;
+        [&]<std::size_t... Hs>(std::index_sequence<Hs...>) {
+            ((_handles_alt<I, Data, decltype(std::get<Hs>(std::declval<tuple_ref>()))>()
+                  ? static_cast<void>(idxs[count++] = Hs)
+                  : static_cast<void>(0)),
+             ...);
+        }(std::index_sequence_for<Handlers...>());
+        return std::pair(idxs, count);
+    }();
+
+    /// Get an index_sequence of the visitors that can handle the alternative with index `I`
+    template <std::size_t I, typename Self, typename Data>
+    static constexpr auto _handlers_for_alt() noexcept {
+        constexpr auto& found = _alt_handlers<I, Self, Data>;
+        return []<std::size_t... Ks>(std::index_sequence<Ks...>) {
+            return std::index_sequence<_alt_handlers<I, Self, Data>.first[Ks]...>();
+        }(std::make_index_sequence<found.second>());
+    }
+
+    /// Run the visitors that can handle data holding the alternative with index `I`
+    template <std::size_t I, typename Self, typename Data>
+    static walk_result _invoke_at(Self& self, Data&& dat) {
+        return [&]<std::size_t... Hs>(std::index_sequence<Hs...>) {
+            return _try_next(NEO_FWD(dat), std::get<Hs>(self._hs)...);
+        }(_handlers_for_alt<I, Self, Data>());
+    }
+
+    /**
+     * Dispatch to the visitors for the alternative with index `idx`, which is at
+     * least `I`.
+     */
+    template <std::size_t I, typename Self, typename Data>
+    static walk_result _dispatch(Self& self, Data&& dat, std::size_t idx) {
+        using variant_type = typename std::remove_cvref_t<Data>::variant_type;
+        if constexpr (I + 1 < std::variant_size_v<variant_type>) {
+            if (idx != I) {
+                return _dispatch<I + 1>(self, NEO_FWD(dat), idx);
+            }
+        }
+        return _invoke_at<I>(self, NEO_FWD(dat));
+    }
+
+    /**
+     * If the data is variant_indexed_data, branch once on the index of its
+     * alternative, to a list of only the visitors that can handle it. Otherwise,
+     * every visitor is tried in turn.
+     */
+    template <typename Self, typename Data>
+    static walk_result _invoke(Self& self, Data&& dat) {
+        if constexpr (detail::variant_indexed_data<Data>) {
+            if (!dat.variant().valueless_by_exception()) {
+                return _dispatch<0>(self, NEO_FWD(dat), dat.variant().index());
+            }
+        }
+        return std::apply([&](auto&&... hs) { return _try_next(NEO_FWD(dat), hs...); }, self._hs);
+    }
+
 public:
     constexpr explicit walk_seq(Handlers&&... h) noexcept
         : _hs(NEO_FWD(h)...) {}
 
+    /**
+     * Invoke the handlers. The const overloads invoke the handlers as const, and
+     * are used by all of the walk_ops, so a walker may be shared between
+     * threads.
+     */
     template <typename Data>
         requires ((detail::vst_invocable_for<Handlers, Data> || ...))
     walk_result invoke(Data&& dat) {
-        return std::apply([&](auto&&... hs) {
-            return _try_next(NEO_FWD(dat), hs...); },
-        _hs);
+        return _invoke(*this, NEO_FWD(dat));
+    }
+
+    template <typename Data>
+        requires ((detail::vst_invocable_for<const Handlers&, Data> || ...))
+    walk_result invoke(Data&& dat) const {
+        return _invoke(*this, NEO_FWD(dat));
     }
 
     template <typename Data>
@@ -229,6 +1061,12 @@ public:
     walk_result operator()(Data&& dat) {
         return invoke(NEO_FWD(dat));
     }
+
+    template <typename Data>
+        requires ((detail::vst_invocable_for<const Handlers&, Data> || ...))
+    walk_result operator()(Data&& dat) const {
+        return invoke(NEO_FWD(dat));
+    }
 };
 
 template <typename... Hs>
@@ -244,8 +1082,8 @@ walk_seq(Hs&&...) -> walk_seq<Hs...>;
  */
 template <typename Target, typename Project = std::monostate>
 struct put_into {
-    Target  _target;
-    Project _project;
+    detail::put_target<Target> _target;
+    Project                    _project;
 
     template <typename Iter, typename = void>
     struct _get_value_type {
@@ -257,17 +1095,35 @@ struct put_into {
         using type = typename Iter::container_type::value_type;
     };
 
+    /// Get the value from a try_get() result, moving it out if the result owns it
+    template <typename Ref>
+    static decltype(auto) _deref(Ref& ref) {
+        if constexpr (get_detail::is_value_holder<Ref>) {
+            return ref.take();
+        } else {
+            return *ref;
+        }
+    }
+
     template <typename Dest, typename Value>
     walk_result _put(Dest& into, Value&& val) const {
         using std::get_if;
         if constexpr (neo::assignable_from<Dest&, Value>) {
             into = NEO_FWD(val);
-        } else if constexpr (supports_alternative<Value, Dest>) {
+        } else if constexpr (detail::put_integer<Dest> && detail::put_integer_source<Value>) {
+            if (!detail::put_integral(into, val)) {
+                return walk_reject{walk_errc::put_into_mismatch};
+            }
+        } else if constexpr (std::is_floating_point_v<Dest> && detail::put_integer_source<Value>) {
+            if (!detail::put_floating(into, val)) {
+                return walk_reject{walk_errc::put_into_mismatch};
+            }
+        } else if constexpr (supports_try_get<Value, Dest>) {
             auto ref = try_get<Dest>(val);
             if (!ref) {
-                throw walk_error(detail::walk_path + ": Incorrect type to put-into a value");
+                return walk_reject{walk_errc::put_into_mismatch};
             }
-            into = *ref;
+            into = _deref(ref);
         } else {
             static_assert(std::is_void_v<Dest>,
                           "put_into cannot possibly receive the given data type");
@@ -285,49 +1141,80 @@ struct put_into {
         using dest_type = typename _get_value_type<Dest>::type;
         if constexpr (neo::assignable_from<Dest&, Value>) {
             into = NEO_FWD(val);
+        } else if constexpr (detail::put_integer<dest_type> && detail::put_integer_source<Value>) {
+            dest_type n = 0;
+            if (!detail::put_integral(n, val)) {
+                return walk_reject{walk_errc::put_into_mismatch};
+            }
+            if constexpr (neo::assignable_from<Dest&, dest_type>) {
+                into = n;
+            } else {
+                *into = n;
+            }
+        } else if constexpr (std::is_floating_point_v<dest_type>
+                             && detail::put_integer_source<Value>) {
+            dest_type n = 0;
+            if (!detail::put_floating(n, val)) {
+                return walk_reject{walk_errc::put_into_mismatch};
+            }
+            if constexpr (neo::assignable_from<Dest&, dest_type>) {
+                into = n;
+            } else {
+                *into = n;
+            }
         } else if constexpr (neo::assignable_from<Dest&, dest_type>) {
             auto ref = try_get<dest_type>(val);
             if (!ref) {
-                throw walk_error("Incorrect type to put-into a value");
+                return walk_reject{walk_errc::put_into_mismatch};
             }
-            into = *ref;
+            into = _deref(ref);
         } else if constexpr (neo::assignable_from<dest_type&, Value>) {
             *into = NEO_FWD(val);
         } else {
             auto ref = try_get<dest_type>(val);
             if (!ref) {
-                throw walk_error("Incorrect type to put-into a value");
+                return walk_reject{walk_errc::put_into_mismatch};
             }
-            *into = *ref;
+            *into = _deref(ref);
         }
         return walk_accept;
     }
 
 public:
     explicit put_into(Target&& t)
-        : _target(NEO_FWD(t)) {}
+        : _target{NEO_FWD(t)} {}
     explicit put_into(Target&& t, Project&& pr)
-        : _target(NEO_FWD(t))
+        : _target{NEO_FWD(t)}
         , _project(NEO_FWD(pr)) {}
 
     template <typename Data>
-    walk_result operator()(Data&& dat) {
+    walk_result operator()(Data&& dat) const {
         if constexpr (neo::same_as<Project, std::monostate>) {
-            return _put(_target, NEO_FWD(dat));
+            return _put(_target.get(), NEO_FWD(dat));
         } else if constexpr (detail::vst_is_generic<Project>) {
             auto&& proj = _project(NEO_FWD(dat));
-            return _put(_target, NEO_FWD(proj));
+            return _put(_target.get(), NEO_FWD(proj));
         } else {
             using arg_type        = detail::vst_arg_t<Project>;
-            constexpr bool inv_ok = neo::invocable<Project, Data>;
+            constexpr bool inv_ok = neo::invocable<const Project&, Data>;
             if constexpr (inv_ok) {
                 auto&& proj = _project(NEO_FWD(dat));
-                return _put(_target, NEO_FWD(proj));
+                return _put(_target.get(), NEO_FWD(proj));
             } else {
-                static_assert(supports_alternative<Data, arg_type>,
+                static_assert(supports_try_get<Data, arg_type>,
                               "projection function cannot handle the argument we wish to give it");
-                auto&& proj = _project(semester::get<arg_type>(NEO_FWD(dat)));
-                return _put(_target, NEO_FWD(proj));
+                auto ref = try_get<arg_type>(dat);
+                if (!ref) {
+                    return walk_reject{walk_errc::put_into_mismatch};
+                }
+                if constexpr (!get_detail::is_value_holder<decltype(ref)>
+                              && std::is_rvalue_reference_v<Data&&>) {
+                    auto&& proj = _project(std::move(*ref));
+                    return _put(_target.get(), NEO_FWD(proj));
+                } else {
+                    auto&& proj = _project(_deref(ref));
+                    return _put(_target.get(), NEO_FWD(proj));
+                }
             }
         }
     }
@@ -344,7 +1231,7 @@ struct put_into_pass : put_into<T, Proj> {
     using put_into_pass::put_into::put_into;
 
     template <typename Data>
-    constexpr walk_result operator()(Data&& dat) {
+    constexpr walk_result operator()(Data&& dat) const {
         auto result = put_into_pass::put_into::operator()(NEO_FWD(dat));
         if (result.rejected()) {
             return result;
@@ -363,87 +1250,137 @@ template <typename... KeyFuncs>
 class mapping {
     std::tuple<KeyFuncs...> _funcs;
 
-    template <typename F>
-    void _forget(F&&) {}
-
-    template <typename F>
-    void _forget(F&& fn) requires requires {
-        fn.forget();
-    }
-    { fn.forget(); }
+    using _dispatch_table = detail::key_dispatch_table<sizeof...(KeyFuncs)>;
+    _dispatch_table _table;
 
-    void _forget() {
-        std::apply([&](auto&&... fns) { (_forget(fns), ...); }, _funcs);
+    /// Get the key of the I'th handler, if it is a keyed handler
+    template <std::size_t I>
+    constexpr static std::optional<std::string_view> _key_of(const mapping& self) noexcept {
+        using handler_type = std::tuple_element_t<I, std::tuple<KeyFuncs...>>;
+        if constexpr (detail::keyed_handler<handler_type>) {
+            return std::string_view(std::get<I>(self._funcs).key());
+        } else {
+            return std::nullopt;
+        }
     }
 
-    template <typename F>
-    auto _check_unsatisfied(F&&) {
-        return std::nullopt;
+    template <std::size_t... Is>
+    std::optional<std::string_view> _key_of(std::size_t idx,
+                                            std::index_sequence<Is...>) const noexcept {
+        using fn_type = std::optional<std::string_view> (*)(const mapping&) noexcept;
+        constexpr static fn_type fns[] = {&_key_of<Is>...};
+        return fns[idx](*this);
     }
 
-    template <typename Fn>
-    std::optional<std::string> _check_unsatisfied(Fn&& fn) requires requires {
-        fn.unsat_message();
+    std::optional<std::string_view> _key_of(std::size_t idx) const noexcept {
+        return _key_of(idx, std::index_sequence_for<KeyFuncs...>{});
     }
-    { return fn.unsat_message(); }
 
-    auto _find_unsatisfied_key_1() { return std::nullopt; }
+    /// The set of handlers that have been given a key during one walk
+    using _seen_set = std::array<bool, sizeof...(KeyFuncs)>;
 
-    template <typename Fn, typename... Tail>
-    std::optional<std::string> _find_unsatisfied_key_1(Fn&& fn, Tail&&... tail) {
-        std::optional<std::string> unsat = _check_unsatisfied(fn);
-        if (unsat) {
-            return unsat;
+    /// Invoke the I'th handler for the given key
+    template <std::size_t I, typename Self, typename Key, typename Data>
+    static walk_result _invoke(Self& self, const Key& k, const Data& dat) {
+        auto& handler = std::get<I>(self._funcs);
+        if constexpr (detail::keyed_handler<std::remove_cvref_t<decltype(handler)>>) {
+            // The dispatch table has already compared the key
+            return handler.matched(dat);
+        } else {
+            return std::invoke(handler, k, dat);
         }
-        return _find_unsatisfied_key_1(tail...);
-    }
-
-    std::optional<std::string> _find_unsatisfied_key() {
-        return std::apply([&](auto&&... fns) { return _find_unsatisfied_key_1(fns...); }, _funcs);
     }
 
-    template <typename Key, typename Data>
-    walk_result _try_key(const Key& k, const Data&) const {
-        // No key matched. Ignore it.
-        return walk_reject{detail::walk_path + ": Unhandled key: " + std::string(k)};
+    template <typename Self, typename Key, typename Data, std::size_t... Is>
+    static walk_result _try_key(
+        Self& self, const Key& k, const Data& dat, _seen_set& seen, std::index_sequence<Is...>) {
+        using fn_type                  = walk_result (*)(Self&, const Key&, const Data&);
+        constexpr static fn_type fns[] = {&_invoke<Is, Self, Key, Data>...};
+
+        walk_result result = walk_pass;
+        self._table.find_handler(
+            std::string_view(k),
+            [&](std::size_t idx) { return *self._key_of(idx); },
+            [&](std::size_t idx) {
+                seen[idx] = true;
+                result    = fns[idx](self, k, dat);
+                return !(result == walk_pass);
+            });
+        if (result == walk_pass) {
+            // No key matched. Ignore it.
+            return walk_reject{walk_errc::unhandled_key};
+        }
+        return result;
     }
 
-    template <typename Key, typename Data, typename Head, typename... Tail>
-    walk_result _try_key(const Key& k, Data&& dat, Head&& h, Tail&&... tail) const {
-        auto prev_path = detail::walk_path;
-        detail::walk_path += "/" + std::string(k);
-        walk_result key_res = std::invoke(h, k, NEO_FWD(dat));
-        detail::walk_path   = prev_path;
-        if (key_res == walk_pass) {
-            return _try_key(k, NEO_FWD(dat), tail...);
+    /// Get the message of the I'th handler if it is required and was not seen
+    template <std::size_t I>
+    const walk_message* _missing_message(const _seen_set& seen) const noexcept {
+        using handler_type = std::tuple_element_t<I, std::tuple<KeyFuncs...>>;
+        if constexpr (detail::required_handler<handler_type>) {
+            return seen[I] ? nullptr : &std::get<I>(_funcs).required_message();
+        } else {
+            return nullptr;
         }
-        return key_res;
     }
 
-public:
-    explicit mapping(KeyFuncs&&... ks) noexcept
-        : _funcs(NEO_FWD(ks)...) {}
+    /// Find the first required handler that was not given a key
+    template <std::size_t... Is>
+    const walk_message* _find_missing(const _seen_set& seen, std::index_sequence<Is...>) const {
+        const walk_message* missing = nullptr;
+        static_cast<void>(((missing = _missing_message<Is>(seen)) || ...));
+        return missing;
+    }
 
-    template <typename Data>
-    requires supports_mappings<std::decay_t<Data>>  //
-        walk_result operator()(Data&& dat) {
+    template <typename Self, typename Data>
+    static walk_result _walk(Self& self, Data&& dat) {
         using mapping_type = typename std::decay_t<Data>::mapping_type;
-        _forget();
-        const mapping_type& map = semester::get<mapping_type>(NEO_FWD(dat));
+        // The handlers seen are tracked here rather than in the handlers, so
+        // that one mapping can be used by several walks at once.
+        _seen_set           seen = {};
+        const mapping_type& map  = semester::get<mapping_type>(NEO_FWD(dat));
         for (const auto& [key, value] : map) {
-            walk_result partial_result
-                = std::apply([&](auto&&... fns) { return _try_key(key, value, fns...); }, _funcs);
+            detail::walk_path_scope path_scope{std::string_view(key)};
+            walk_result             partial_result
+                = _try_key(self, key, value, seen, std::index_sequence_for<KeyFuncs...>{});
             if (partial_result.rejected()) {
                 return partial_result;
             }
         }
-        auto unsat_message = _find_unsatisfied_key();
-        if (unsat_message) {
-            return walk_reject{detail::walk_path
-                               + ": Missing required key/property: " + *unsat_message};
+        auto missing = self._find_missing(seen, std::index_sequence_for<KeyFuncs...>{});
+        if (missing) {
+            return walk_reject{walk_errc::missing_required_key, *missing};
         }
         return walk_accept;
     }
+
+    template <std::size_t... Is>
+    constexpr _dispatch_table _make_table(std::index_sequence<Is...>) const noexcept {
+        const std::array<std::optional<std::string_view>, sizeof...(Is)> keys = {
+            _key_of<Is>(*this)...};
+        return _dispatch_table([&](std::size_t idx) { return keys[idx]; });
+    }
+
+public:
+    constexpr explicit mapping(KeyFuncs&&... ks) noexcept
+        : _funcs(NEO_FWD(ks)...)
+        , _table(_make_table(std::index_sequence_for<KeyFuncs...>{})) {}
+
+    /**
+     * Walk the mapping. A mapping holds no state between walks, so the const
+     * overload may be used by many threads at once.
+     */
+    template <typename Data>
+    requires supports_mappings<std::decay_t<Data>>  //
+        walk_result operator()(Data&& dat) {
+        return _walk(*this, NEO_FWD(dat));
+    }
+
+    template <typename Data>
+    requires supports_mappings<std::decay_t<Data>>  //
+        walk_result operator()(Data&& dat) const {
+        return _walk(*this, NEO_FWD(dat));
+    }
 };
 
 template <typename... Args>
@@ -458,48 +1395,156 @@ public:
         : if_key::walk_seq(NEO_FWD(fns)...)
         , _key(std::move(k)) {}
 
+    /// The key handled by this handler
+    const std::string& key() const noexcept { return _key; }
+
+    /// Handle the value for a key that is known to match
+    template <typename Data>
+    walk_result matched(Data&& dat) {
+        return this->invoke(NEO_FWD(dat));
+    }
+
+    template <typename Data>
+    walk_result matched(Data&& dat) const {
+        return this->invoke(NEO_FWD(dat));
+    }
+
     template <typename Key, typename Data>
     walk_result operator()(Key&& k, Data&& dat) {
-        if (_key == k) {
-            return this->invoke(NEO_FWD(dat));
-        }
-        return walk_pass;
+        return _key == k ? matched(NEO_FWD(dat)) : walk_pass;
+    }
+
+    template <typename Key, typename Data>
+    walk_result operator()(Key&& k, Data&& dat) const {
+        return _key == k ? matched(NEO_FWD(dat)) : walk_pass;
     }
 };
 
 template <typename... Fs>
 if_key(std::string, Fs&&...) -> if_key<Fs...>;
 
+/**
+ * An if_key for a key that is known at compile time. Stores no key data.
+ */
+template <fixed_string Key, typename... Funcs>
+class if_key<static_key<Key>, Funcs...> : walk_seq<Funcs...> {
+public:
+    constexpr explicit if_key(static_key<Key>, Funcs&&... fns) noexcept
+        : if_key::walk_seq(NEO_FWD(fns)...) {}
+
+    /// The key handled by this handler
+    constexpr static std::string_view key() noexcept { return static_key<Key>::value; }
+
+    /// Handle the value for a key that is known to match
+    template <typename Data>
+    walk_result matched(Data&& dat) {
+        return this->invoke(NEO_FWD(dat));
+    }
+
+    template <typename Data>
+    walk_result matched(Data&& dat) const {
+        return this->invoke(NEO_FWD(dat));
+    }
+
+    template <typename K, typename Data>
+    walk_result operator()(K&& k, Data&& dat) {
+        return static_key<Key>::matches(k) ? matched(NEO_FWD(dat)) : walk_pass;
+    }
+
+    template <typename K, typename Data>
+    walk_result operator()(K&& k, Data&& dat) const {
+        return static_key<Key>::matches(k) ? matched(NEO_FWD(dat)) : walk_pass;
+    }
+};
+
+template <fixed_string Key, typename... Fs>
+if_key(static_key<Key>, Fs&&...) -> if_key<static_key<Key>, Fs...>;
+
 template <typename... Funcs>
 class required_key : walk_seq<Funcs...> {
-    std::string _key;
-    std::string _message;
-    bool        _satisfied = false;
+    std::string  _key;
+    walk_message _message;
 
 public:
-    explicit required_key(std::string k, std::string message, Funcs&&... fns) noexcept
+    explicit required_key(std::string k, walk_message message, Funcs&&... fns) noexcept
         : required_key::walk_seq(NEO_FWD(fns)...)
         , _key(std::move(k))
         , _message(std::move(message)) {}
 
-    void forget() { _satisfied = false; }
+    /// The key handled by this handler
+    const std::string& key() const noexcept { return _key; }
 
-    std::optional<std::string> unsat_message() const noexcept {
-        return _satisfied ? std::nullopt : std::make_optional(_message);
+    /// The rejection message for when the key is missing
+    const walk_message& required_message() const noexcept { return _message; }
+
+    /// Handle the value for a key that is known to match
+    template <typename Data>
+    walk_result matched(Data&& dat) {
+        return this->invoke(NEO_FWD(dat));
+    }
+
+    template <typename Data>
+    walk_result matched(Data&& dat) const {
+        return this->invoke(NEO_FWD(dat));
     }
 
     template <typename Key, typename Data>
     walk_result operator()(Key&& k, Data&& dat) {
-        if (_key == k) {
-            _satisfied = true;
-            return this->invoke(NEO_FWD(dat));
-        }
-        return walk_pass;
+        return _key == k ? matched(NEO_FWD(dat)) : walk_pass;
+    }
+
+    template <typename Key, typename Data>
+    walk_result operator()(Key&& k, Data&& dat) const {
+        return _key == k ? matched(NEO_FWD(dat)) : walk_pass;
     }
 };
 
 template <typename... Fs>
-required_key(std::string, std::string, Fs&&...) -> required_key<Fs...>;
+required_key(std::string, walk_message, Fs&&...) -> required_key<Fs...>;
+
+/**
+ * A required_key for a key that is known at compile time. Stores no key data,
+ * and no heap data if the message is a string literal.
+ */
+template <fixed_string Key, typename... Funcs>
+class required_key<static_key<Key>, Funcs...> : walk_seq<Funcs...> {
+    walk_message _message;
+
+public:
+    explicit required_key(static_key<Key>, walk_message message, Funcs&&... fns) noexcept
+        : required_key::walk_seq(NEO_FWD(fns)...)
+        , _message(std::move(message)) {}
+
+    /// The key handled by this handler
+    constexpr static std::string_view key() noexcept { return static_key<Key>::value; }
+
+    /// The rejection message for when the key is missing
+    const walk_message& required_message() const noexcept { return _message; }
+
+    /// Handle the value for a key that is known to match
+    template <typename Data>
+    walk_result matched(Data&& dat) {
+        return this->invoke(NEO_FWD(dat));
+    }
+
+    template <typename Data>
+    walk_result matched(Data&& dat) const {
+        return this->invoke(NEO_FWD(dat));
+    }
+
+    template <typename K, typename Data>
+    walk_result operator()(K&& k, Data&& dat) {
+        return static_key<Key>::matches(k) ? matched(NEO_FWD(dat)) : walk_pass;
+    }
+
+    template <typename K, typename Data>
+    walk_result operator()(K&& k, Data&& dat) const {
+        return static_key<Key>::matches(k) ? matched(NEO_FWD(dat)) : walk_pass;
+    }
+};
+
+template <fixed_string Key, typename... Fs>
+required_key(static_key<Key>, walk_message, Fs&&...) -> required_key<static_key<Key>, Fs...>;
 
 template <typename Type, typename... Fns>
 class if_type_fn : walk_seq<Fns...> {
@@ -508,10 +1553,12 @@ public:
 
     template <typename Data>
     walk_result operator()(Data&& dat) {
-        if (semester::holds_alternative<Type>(dat)) {
-            return this->invoke(NEO_FWD(dat));
-        }
-        return walk_pass;
+        return semester::holds_alternative<Type>(dat) ? this->invoke(NEO_FWD(dat)) : walk_pass;
+    }
+
+    template <typename Data>
+    walk_result operator()(Data&& dat) const {
+        return semester::holds_alternative<Type>(dat) ? this->invoke(NEO_FWD(dat)) : walk_pass;
     }
 };
 
@@ -522,25 +1569,25 @@ auto if_type(Funcs&&... fns) noexcept {
 
 template <typename T>
 struct require_type {
-    std::string message;
+    walk_message message;
 
-    explicit require_type(std::string m) noexcept
+    explicit require_type(walk_message m) noexcept
         : message(std::move(m)) {}
 
     template <typename Data>
-    walk_result operator()(Data&& dat) const noexcept {
+    walk_result operator()(Data&& dat) const {
         if (semester::holds_alternative<T>(dat)) {
             return walk_pass;
         }
-        return walk_reject{detail::walk_path + ": " + message};
+        return walk_reject{walk_errc::wrong_type, message};
     }
 };
 
 constexpr inline auto just_accept = [](auto&&...) -> walk_result { return walk_accept; };
 
-constexpr inline auto reject_with = [](std::string message) {
+constexpr inline auto reject_with = [](walk_message message) {
     return [message](auto&&...) -> walk_result {
-        return walk_reject{detail::walk_path + ": " + message};
+        return walk_reject{walk_errc::custom, message};
     };
 };
 
@@ -550,8 +1597,19 @@ struct if_mapping : walk_seq<Fns...> {
 
     template <supports_mappings Data>
     walk_result operator()(Data&& dat) {
+        return _walk(*this, NEO_FWD(dat));
+    }
+
+    template <supports_mappings Data>
+    walk_result operator()(Data&& dat) const {
+        return _walk(*this, NEO_FWD(dat));
+    }
+
+private:
+    template <typename Self, typename Data>
+    static walk_result _walk(Self& self, Data&& dat) {
         if (semester::holds_alternative<mapping_type_t<Data>>(dat)) {
-            return this->invoke(NEO_FWD(dat));
+            return self.invoke(NEO_FWD(dat));
         }
         return walk_pass;
     }
@@ -566,8 +1624,19 @@ struct if_array : walk_seq<Fns...> {
 
     template <typename Data>
     walk_result operator()(Data&& dat) {
+        return _walk(*this, NEO_FWD(dat));
+    }
+
+    template <typename Data>
+    walk_result operator()(Data&& dat) const {
+        return _walk(*this, NEO_FWD(dat));
+    }
+
+private:
+    template <typename Self, typename Data>
+    static walk_result _walk(Self& self, Data&& dat) {
         if (semester::holds_alternative<array_type_t<Data>>(dat)) {
-            return this->invoke(NEO_FWD(dat));
+            return self.invoke(NEO_FWD(dat));
         }
         return walk_pass;
     }
@@ -583,17 +1652,26 @@ public:
 
     template <typename Data>
     requires supports_arrays<std::decay_t<Data>> walk_result operator()(Data&& dat) {
+        return _walk(*this, NEO_FWD(dat));
+    }
+
+    template <typename Data>
+    requires supports_arrays<std::decay_t<Data>> walk_result operator()(Data&& dat) const {
+        return _walk(*this, NEO_FWD(dat));
+    }
+
+private:
+    template <typename Self, typename Data>
+    static walk_result _walk(Self& self, Data&& dat) {
         using array_type = typename std::decay_t<Data>::array_type;
         if (!semester::holds_alternative<array_type>(dat)) {
-            return walk_reject{detail::walk_path + ": Expected an array"};
+            return walk_reject{walk_errc::expected_array};
         }
         decltype(auto) arr   = semester::get<array_type>(NEO_FWD(dat));
-        int            index = 0;
+        std::size_t    index = 0;
         for (decltype(auto) element : arr) {
-            auto prev_path = detail::walk_path;
-            detail::walk_path += "[" + std::to_string(index) + "]";
-            walk_result interim = this->invoke(element);
-            detail::walk_path   = prev_path;
+            detail::walk_path_scope path_scope{index};
+            walk_result             interim = self.invoke(element);
             if (interim.rejected()) {
                 return interim;
             }
@@ -606,33 +1684,343 @@ public:
 template <typename... Fs>
 for_each(Fs&&...) -> for_each<Fs...>;
 
+/**
+ * A fixed set of threads on which parallel_for_each runs its chunks. The threads
+ * are started with the pool and live until it is destroyed, so walks do not
+ * start threads of their own.
+ */
+class walk_thread_pool {
+    struct _job {
+        void (*invoke)(const void* fn, std::size_t worker);
+        const void* fn;
+        /// The number of workers running the job. Guarded by the mutex of the pool.
+        std::size_t running = 0;
+    };
+
+    struct _task {
+        _job*       job;
+        std::size_t worker;
+    };
+
+    inline static thread_local bool _on_worker = false;
+
+    std::mutex                _mutex;
+    std::condition_variable   _wake;
+    std::condition_variable   _done;
+    std::deque<_task>         _tasks;
+    bool                      _stopping = false;
+    std::vector<std::jthread> _threads;
+
+    void _work() {
+        _on_worker = true;
+        std::unique_lock lock{_mutex};
+        while (true) {
+            _wake.wait(lock, [&] { return _stopping || !_tasks.empty(); });
+            if (_tasks.empty()) {
+                return;
+            }
+            const _task task = _tasks.front();
+            _tasks.pop_front();
+            ++task.job->running;
+            lock.unlock();
+            task.job->invoke(task.job->fn, task.worker);
+            lock.lock();
+            --task.job->running;
+            _done.notify_all();
+        }
+    }
+
+public:
+    /// Start a pool of `n_threads` threads
+    explicit walk_thread_pool(std::size_t n_threads) {
+        _threads.reserve(n_threads);
+        for (std::size_t n = 0; n < n_threads; ++n) {
+            _threads.emplace_back([this] { _work(); });
+        }
+    }
+
+    walk_thread_pool(const walk_thread_pool&) = delete;
+    walk_thread_pool& operator=(const walk_thread_pool&) = delete;
+
+    ~walk_thread_pool() {
+        {
+            std::lock_guard lock{_mutex};
+            _stopping = true;
+        }
+        _wake.notify_all();
+        // The threads are joined here
+    }
+
+    /// The pool used when none is given: one thread fewer than there are cores
+    static walk_thread_pool& shared() {
+        static walk_thread_pool pool{(std::max)(std::thread::hardware_concurrency(), 1u) - 1u};
+        return pool;
+    }
+
+    /// Whether the calling thread is a thread of any walk_thread_pool
+    static bool on_worker_thread() noexcept { return _on_worker; }
+
+    /// The number of threads in the pool
+    std::size_t size() const noexcept { return _threads.size(); }
+
+    /**
+     * Call `fn(0)` on the calling thread, and `fn(1)` through `fn(n_workers - 1)`
+     * on the threads of the pool. The calls that no thread has started by the
+     * time `fn(0)` returns are not made, so the calling thread must be able to
+     * do all of the work alone. Returns once every call that was started has
+     * finished. `fn` must not throw. On a thread of a pool, only `fn(0)` is
+     * called, so that nested jobs cannot wait on each other.
+     */
+    template <typename Func>
+    void run(std::size_t n_workers, const Func& fn) {
+        if (_on_worker || _threads.empty() || n_workers < 2) {
+            fn(std::size_t(0));
+            return;
+        }
+        _job job{[](const void* f, std::size_t worker) { (*static_cast<const Func*>(f))(worker); },
+                 &fn};
+        {
+            std::lock_guard lock{_mutex};
+            for (std::size_t worker = 1; worker < n_workers; ++worker) {
+                _tasks.push_back({&job, worker});
+            }
+        }
+        _wake.notify_all();
+        fn(std::size_t(0));
+        std::unique_lock lock{_mutex};
+        std::erase_if(_tasks, [&](const _task& task) { return task.job == &job; });
+        _done.wait(lock, [&] { return job.running == 0; });
+    }
+};
+
+/**
+ * Options for parallel_for_each
+ */
+struct parallel_walk_options {
+    /// The most threads to use, including the calling thread. Zero for all of the pool.
+    std::size_t max_threads = 0;
+    /// The number of consecutive elements that a thread takes at a time
+    std::size_t chunk_size = 1024;
+    /// The pool whose threads join the walk. Null for walk_thread_pool::shared().
+    walk_thread_pool* pool = nullptr;
+};
+
+/**
+ * Like for_each, but the elements of a large array are walked by several
+ * threads at once. The array is divided into chunks, and each thread takes the
+ * next unclaimed chunk until none remain. The calling thread takes part along
+ * with the threads of a walk_thread_pool, and the walk returns once every
+ * thread has finished.
+ *
+ * The handlers are invoked as const from several threads at once, so they must
+ * be safe to share (see mapping). The result is the same as from for_each: if
+ * any elements are rejected, or their handlers throw, then the rejection or
+ * exception of the element with the lowest index is reported. Elements after a
+ * known failure are not walked. Each thread reports the path to the array
+ * followed by the index of its element.
+ *
+ * Arrays that are not random-access, or that fit in a single chunk, are walked
+ * on the calling thread. So are the arrays walked by handlers that are already
+ * running on a thread of a pool, such as those of an enclosing
+ * parallel_for_each.
+ */
+template <typename... Funcs>
+class parallel_for_each : walk_seq<Funcs...> {
+    parallel_walk_options _opts;
+
+    /// The first failure found by one thread
+    struct _failure {
+        std::size_t                index = 0;
+        std::optional<walk_result> result;
+        std::exception_ptr         error;
+    };
+
+    template <typename Array>
+    walk_result _walk_sequential(const Array& arr) const {
+        std::size_t index = 0;
+        for (decltype(auto) element : arr) {
+            detail::walk_path_scope path_scope{index};
+            walk_result             interim = this->invoke(element);
+            if (interim.rejected()) {
+                return interim;
+            }
+            ++index;
+        }
+        return walk_accept;
+    }
+
+    template <typename Array>
+    walk_result _walk_parallel(const Array& arr, std::size_t n_threads) const {
+        const std::size_t size  = arr.size();
+        const std::size_t chunk = _opts.chunk_size;
+        const auto        first = arr.begin();
+
+        std::atomic<std::size_t> next_chunk{0};
+        // The lowest index known to fail. Nothing at or after it needs walking.
+        std::atomic<std::size_t> fail_index{size};
+        std::vector<_failure>    failures(n_threads);
+
+        const auto note_failure = [&](std::size_t index) {
+            auto prev = fail_index.load(std::memory_order_relaxed);
+            while (index < prev
+                   && !fail_index.compare_exchange_weak(prev, index, std::memory_order_relaxed)) {
+            }
+        };
+
+        // The workers begin their paths from a copy of the caller's path, since
+        // the caller changes its own path while it works.
+        const detail::walk_path_stack parent_path = detail::walk_path;
+
+        const auto work = [&](std::size_t worker) {
+            _failure& mine = failures[worker];
+            while (true) {
+                // Chunks are claimed in order, so once a chunk begins after a
+                // failure, so do all of the chunks that remain.
+                const std::size_t begin
+                    = next_chunk.fetch_add(1, std::memory_order_relaxed) * chunk;
+                if (begin >= size || begin >= fail_index.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                const std::size_t end = (std::min)(size - begin, chunk) + begin;
+                for (std::size_t index = begin; index < end; ++index) {
+                    if (index >= fail_index.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+                    SEMESTER_TRY {
+                        detail::walk_path_scope path_scope{index};
+                        walk_result             result = this->invoke(first[index]);
+                        if (result.rejected()) {
+                            mine.index  = index;
+                            mine.result = std::move(result);
+                            note_failure(index);
+                            return;
+                        }
+                    } SEMESTER_CATCH_ALL {
+                        mine.index = index;
+                        mine.error = std::current_exception();
+                        note_failure(index);
+                        return;
+                    }
+                }
+            }
+        };
+
+        // A rejection on any thread uses the storage that was reserved for it
+        detail::walk_path_record::reserve();
+        _pool().run(n_threads, [&](std::size_t worker) {
+            if (worker != 0) {
+                SEMESTER_TRY {
+                    detail::walk_path_record::reserve();
+                    detail::walk_path = parent_path;
+                }
+                SEMESTER_CATCH_ALL {
+                    // The other threads will walk the chunks that this one would have
+                    return;
+                }
+            }
+            work(worker);
+        });
+
+        for (auto& f : failures) {
+            if ((f.result || f.error) && f.index == fail_index.load()) {
+                if (f.error) {
+                    std::rethrow_exception(f.error);
+                }
+                return std::move(*f.result);
+            }
+        }
+        return walk_accept;
+    }
+
+    template <typename Data>
+    walk_result _walk(Data&& dat) const {
+        using array_type = typename std::decay_t<Data>::array_type;
+        if (!semester::holds_alternative<array_type>(dat)) {
+            return walk_reject{walk_errc::expected_array};
+        }
+        const auto& arr = semester::get<array_type>(NEO_FWD(dat));
+        if constexpr (std::random_access_iterator<decltype(arr.begin())>) {
+            if (!walk_thread_pool::on_worker_thread()) {
+                const std::size_t n_chunks = (arr.size() + _opts.chunk_size - 1) / _opts.chunk_size;
+                const std::size_t max_threads
+                    = _opts.max_threads ? _opts.max_threads : _pool().size() + 1;
+                const std::size_t n_threads
+                    = (std::min)({n_chunks, max_threads, _pool().size() + 1});
+                if (n_threads > 1) {
+                    return _walk_parallel(arr, n_threads);
+                }
+            }
+        }
+        return _walk_sequential(arr);
+    }
+
+    walk_thread_pool& _pool() const {
+        return _opts.pool ? *_opts.pool : walk_thread_pool::shared();
+    }
+
+    static parallel_walk_options _fix_options(parallel_walk_options opts) noexcept {
+        opts.chunk_size = (std::max)(opts.chunk_size, std::size_t(1));
+        return opts;
+    }
+
+public:
+    explicit parallel_for_each(Funcs&&... fns) noexcept
+        : parallel_for_each::walk_seq(NEO_FWD(fns)...)
+        , _opts(_fix_options({})) {}
+
+    explicit parallel_for_each(parallel_walk_options opts, Funcs&&... fns) noexcept
+        : parallel_for_each::walk_seq(NEO_FWD(fns)...)
+        , _opts(_fix_options(opts)) {}
+
+    template <typename Data>
+    requires supports_arrays<std::decay_t<Data>> walk_result operator()(Data&& dat) const {
+        return _walk(NEO_FWD(dat));
+    }
+};
+
+template <typename... Fs>
+parallel_for_each(Fs&&...) -> parallel_for_each<Fs...>;
+
+template <typename... Fs>
+parallel_for_each(parallel_walk_options, Fs&&...) -> parallel_for_each<Fs...>;
+
 }  // namespace walk_ops
 
 inline constexpr struct walk_fn {
     static inline walk_result accept = walk_accept;
     static inline walk_result pass   = walk_pass;
 
-    static walk_result reject(std::string str) { return walk_reject{NEO_FWD(str)}; }
+    static walk_result reject(walk_message str) noexcept { return walk_reject{std::move(str)}; }
+
+    /**
+     * Walk the data with the given handlers, and return the result. Data that
+     * no handler accepts is rejected rather than throwing, so try_walk() only
+     * throws if a handler does.
+     */
     template <typename Data, typename... Handlers>
     [[nodiscard]] constexpr decltype(auto) try_walk(Data&& dat, Handlers&&... hs) const {
-        if (detail::walk_path.empty()) {
-            detail::walk_path = "<root>";
-        }
+        detail::walk_path_record::reserve();
         walk_seq seq(NEO_FWD(hs)...);
         return seq(NEO_FWD(dat));
     }
 
+    /**
+     * Walk the data with the given handlers, and throw a walk_error if it is
+     * rejected. If SEMESTER_NO_EXCEPTIONS, a rejection aborts instead.
+     */
     template <typename Data, typename... Handlers>
     constexpr decltype(auto) operator()(Data&& dat, Handlers&&... hs) const {
         auto res = try_walk(NEO_FWD(dat), NEO_FWD(hs)...);
         res.throw_if_rejected();
     }
 
-    std::string_view path() const noexcept { return detail::walk_path; }
+    /// Get the path to the data currently being walked
+    std::string path() const { return detail::walk_path.str(); }
 } walk;
 
 namespace walk_ops {
 using semester::walk;
-}
+using semester::literals::operator""_key;
+}  // namespace walk_ops
 
 }  // namespace semester
\ No newline at end of file
@@ -1,11 +1,45 @@
 #include "./walk.hpp"
 
 #include <semester/json.hpp>
+#include <semester/json_parse.hpp>
 
 #include <catch2/catch.hpp>
 
 #include <neo/test_concept.hpp>
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+thread_local std::size_t n_allocations = 0;
+}
+
+// Count the allocations made by each thread, to check the paths that must not allocate
+void* operator new(std::size_t size) {
+    ++n_allocations;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    SEMESTER_THROW(std::bad_alloc());
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    ++n_allocations;
+    return std::malloc(size ? size : 1);
+}
+
+// Not inlined, so that GCC does not mistake the std::free() for a mismatched deallocation
+[[gnu::noinline]] void operator delete(void* ptr) noexcept { std::free(ptr); }
+[[gnu::noinline]] void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
 struct func {
     void operator()(int) {}
 };
@@ -47,15 +81,84 @@ TEST_CASE("Simple walk_seq") {
     CHECK(ok);
 
     ok = false;
-    CHECK_THROWS_AS(walk(
-                        dat,
-                        [&](auto) {
-                            ok = true;
-                            return walk.pass;
-                        },
-                        [](auto) { return walk.pass; }),
-                    semester::walk_error);
+    auto res = walk.try_walk(
+        dat,
+        [&](auto) {
+            ok = true;
+            return walk.pass;
+        },
+        [](auto) { return walk.pass; });
     CHECK(ok);
+    REQUIRE(res.rejected());
+    CHECK(res.rejection().code() == semester::walk_errc::no_matching_handler);
+    CHECK(res.rejection().message() == "<root>: No matching handler in walk_seq<> data visitor");
+
+#if !SEMESTER_NO_EXCEPTIONS
+    CHECK_THROWS_AS(walk(dat, [](auto) { return walk.pass; }), semester::walk_error);
+#endif
+}
+
+static_assert(semester::detail::variant_indexed_data<const semester::json_data&>);
+static_assert(semester::detail::walk_alt_index<semester::json_data::variant_type, double> == 2);
+static_assert(
+    semester::detail::walk_alt_index<semester::json_cow_data::variant_type,
+                                     semester::json_cow_data::mapping_type>
+    != std::variant_npos);
+static_assert(semester::detail::walk_alt_index<semester::json_data::variant_type, int>
+              == std::variant_npos);
+
+TEMPLATE_TEST_CASE("walk_seq dispatches by alternative in order",
+                   "",
+                   semester::json_data,
+                   semester::json_cow_data) {
+    using semester::walk;
+    std::string order;
+    auto        walker = semester::walk_seq{
+        [&](const std::string& str) {
+            order += "str:" + str + ",";
+            return walk.pass;
+        },
+        [&](double) {
+            order += "num,";
+            return walk.pass;
+        },
+        [&](const auto&) {
+            order += "any,";
+            return walk.pass;
+        },
+        [&](const typename TestType::mapping_type& map) {
+            order += "map:" + std::to_string(map.size()) + ",";
+            return walk.accept;
+        },
+        [&](double) {
+            order += "num2,";
+            return walk.accept;
+        },
+        [&](const std::string&) {
+            order += "str2,";
+            return walk.reject("Strings are rejected");
+        },
+    };
+
+    CHECK(walk.try_walk(TestType(3.0), walker) == semester::walk_accept);
+    CHECK(order == "num,any,num2,");
+
+    order.clear();
+    TestType map = typename TestType::mapping_type{{"a", 1}, {"b", 2}};
+    CHECK(walk.try_walk(map, walker) == semester::walk_accept);
+    CHECK(order == "any,map:2,");
+
+    order.clear();
+    auto res = walk.try_walk(TestType("hi"), walker);
+    REQUIRE(res.rejected());
+    CHECK(res.rejection().message() == "Strings are rejected");
+    CHECK(order == "str:hi,any,str2,");
+
+    order.clear();
+    res = walk.try_walk(TestType(true), walker);
+    REQUIRE(res.rejected());
+    CHECK(res.rejection().code() == semester::walk_errc::no_matching_handler);
+    CHECK(order == "any,");
 }
 
 TEST_CASE("put_into objects") {
@@ -84,9 +187,23 @@ TEST_CASE("put_into objects") {
     CHECK(opt_length.has_value());
     CHECK(opt_length == length);
 
-    // put-into with a bad type will throw
-    bool b = false;
+    // put-into with a bad type is rejected
+    bool b   = false;
+    auto res = walk.try_walk(data, put_into(b));
+    REQUIRE(res.rejected());
+    CHECK(res.rejection().code() == semester::walk_errc::put_into_mismatch);
+    CHECK(res.rejection().message() == "<root>: Incorrect type to put-into a value");
+#if !SEMESTER_NO_EXCEPTIONS
     CHECK_THROWS_AS(walk(data, put_into(b)), semester::walk_error);
+#endif
+
+    // A projection that cannot accept the data is rejected the same way
+    std::size_t num_length = 0;
+    res = walk.try_walk(semester::json_data(1.0),
+                        put_into(num_length, [](std::string const& str) { return str.length(); }));
+    REQUIRE(res.rejected());
+    CHECK(res.rejection().code() == semester::walk_errc::put_into_mismatch);
+    CHECK(num_length == 0);
 
     // put-into a back_inserter
     std::vector<std::size_t> vec;
@@ -94,6 +211,86 @@ TEST_CASE("put_into objects") {
     CHECKED_IF(vec.size() == 1) { CHECK(vec[0] == length); }
 }
 
+TEST_CASE("put_into integers") {
+    using namespace semester::walk_ops;
+    using semester::walk;
+    using semester::walk_errc;
+
+    auto dat = semester::parse_json<semester::json_int_data>(
+        R"([18446744073709551615, -9223372036854775808, 42, 3.0, 2.5, -1, 1e30, "7"])");
+    const auto& arr = dat.as_array();
+
+    std::uint64_t u64 = 0;
+    walk(arr[0], put_into(u64));
+    CHECK(u64 == 18446744073709551615u);
+    std::int64_t i64 = 0;
+    walk(arr[1], put_into(i64));
+    CHECK(i64 == (std::numeric_limits<std::int64_t>::min)());
+    int i = 0;
+    walk(arr[2], put_into(i));
+    CHECK(i == 42);
+    // An integral double converts exactly
+    walk(arr[3], put_into(i));
+    CHECK(i == 3);
+
+    auto code = [](const semester::walk_result& res) {
+        return res.rejected() ? res.rejection().code() : walk_errc{};
+    };
+    std::uint8_t u8 = 0;
+    CHECK(code(walk.try_walk(arr[0], put_into(i64))) == walk_errc::put_into_mismatch);
+    CHECK(code(walk.try_walk(arr[2], put_into(u8))) == walk_errc{});
+    CHECK(u8 == 42);
+    CHECK(code(walk.try_walk(arr[4], put_into(i))) == walk_errc::put_into_mismatch);
+    CHECK(code(walk.try_walk(arr[5], put_into(u64))) == walk_errc::put_into_mismatch);
+    CHECK(code(walk.try_walk(arr[6], put_into(u64))) == walk_errc::put_into_mismatch);
+    CHECK(code(walk.try_walk(arr[7], put_into(i))) == walk_errc::put_into_mismatch);
+    CHECK(i == 3);
+
+    // Plain JSON data converts from its doubles with the same checks
+    semester::json_data plain = 300;
+    CHECK(code(walk.try_walk(plain, put_into(u8))) == walk_errc::put_into_mismatch);
+    CHECK(code(walk.try_walk(plain, put_into(i))) == walk_errc{});
+    CHECK(i == 300);
+
+    // Negative doubles convert down to the minimum of a signed type
+    plain = -2e9;
+    CHECK(code(walk.try_walk(plain, put_into(i))) == walk_errc{});
+    CHECK(i == -2000000000);
+    std::int8_t i8 = 0;
+    plain          = -128;
+    CHECK(code(walk.try_walk(plain, put_into(i8))) == walk_errc{});
+    CHECK(i8 == -128);
+    plain = -129;
+    CHECK(code(walk.try_walk(plain, put_into(i8))) == walk_errc::put_into_mismatch);
+    plain = -9.2e18;
+    CHECK(code(walk.try_walk(plain, put_into(i64))) == walk_errc{});
+    CHECK(i64 == -9200000000000000000);
+    plain = -9223372036854775808.0;
+    CHECK(code(walk.try_walk(plain, put_into(i64))) == walk_errc{});
+    CHECK(i64 == (std::numeric_limits<std::int64_t>::min)());
+    plain = -1e19;
+    CHECK(code(walk.try_walk(plain, put_into(i64))) == walk_errc::put_into_mismatch);
+
+    std::vector<std::uint64_t> vec;
+    for (const auto& item : arr) {
+        static_cast<void>(walk.try_walk(item, put_into(std::back_inserter(vec))));
+    }
+    CHECK(vec == std::vector<std::uint64_t>{18446744073709551615u, 42, 3});
+
+    // Integers are read into floating-point targets as well
+    auto   obj   = semester::parse_json<semester::json_int_data>(R"({"ratio": 1})");
+    double ratio = 0;
+    walk(obj, mapping{if_key{"ratio", put_into(ratio)}});
+    CHECK(ratio == 1.0);
+    std::vector<double> doubles;
+    for (const auto& item : arr) {
+        static_cast<void>(walk.try_walk(item, put_into(std::back_inserter(doubles))));
+    }
+    CHECK(doubles
+          == std::vector<double>{
+              18446744073709551615.0, -9223372036854775808.0, 42, 3, 2.5, -1, 1e30});
+}
+
 TEST_CASE("Mappings") {
     semester::json_data dat = semester::json_data::mapping_type{
         {"foo", "bar"},
@@ -161,6 +358,111 @@ TEST_CASE("Just reject") {
     auto rej = semester::walk.try_walk(12, semester::reject_with("Dummy string"));
     REQUIRE(rej.rejected());
     CHECK(rej.rejection().message == "<root>: Dummy string");
+
+    // A message that is not a literal is copied into the rejection
+    std::string text = "Runtime string";
+    const char* ptr  = text.c_str();
+    auto        rej2 = semester::walk.try_walk(12, semester::reject_with(ptr));
+    text.clear();
+    REQUIRE(rej2.rejected());
+    CHECK(rej2.rejection().message() == "<root>: Runtime string");
+    CHECK(sizeof(rej2) <= 64);
+}
+
+TEST_CASE("Rejections report the walk path") {
+    auto dat = semester::parse_json(R"({"foo": {"bar": [1, 2, "three"]}})");
+
+    using namespace semester::walk_ops;
+    std::string path_in_handler;
+    auto        rej = semester::walk.try_walk(
+        dat,
+        mapping{if_key{"foo",
+                       mapping{if_key{"bar",
+                                      for_each{if_type<double>(just_accept),
+                                               [&](auto&&) {
+                                                   path_in_handler = semester::walk.path();
+                                                   return semester::walk.pass;
+                                               },
+                                               require_type<double>("Expected a number")}}}}});
+    REQUIRE(rej.rejected());
+    CHECK(rej.rejection().message == "<root>/foo/bar[2]: Expected a number");
+    CHECK(path_in_handler == "<root>/foo/bar[2]");
+    // The path is unwound when the walk completes
+    CHECK(semester::walk.path() == "<root>");
+}
+
+TEST_CASE("Structured rejections") {
+    using namespace semester::walk_ops;
+    semester::json_data dat = semester::json_data::mapping_type{{"foo", 1}};
+
+    // The walker is a temporary: The rejection must not refer to it
+    auto rej = semester::walk.try_walk(  //
+        dat,
+        mapping{required_key{"bar", std::string("'bar' is required"), just_accept},
+                if_key{"foo", just_accept}});
+    REQUIRE(rej.rejected());
+    CHECK(rej.rejection().code() == semester::walk_errc::missing_required_key);
+    CHECK(rej.rejection().text() == "'bar' is required");
+    CHECK(rej.rejection().path() == "<root>");
+    CHECK(rej.rejection().message() == "<root>: Missing required key/property: 'bar' is required");
+
+    rej = semester::walk.try_walk(dat, mapping{if_key{"bar", just_accept}});
+    REQUIRE(rej.rejected());
+    CHECK(rej.rejection().code() == semester::walk_errc::unhandled_key);
+    CHECK(rej.rejection().argument() == "foo");
+    CHECK(rej.rejection().path() == "<root>");
+    CHECK(rej.rejection().message() == "<root>: Unhandled key: foo");
+
+    // Rejections made directly by the user carry only their message
+    rej = semester::walk.try_walk(dat, [](auto&&) { return semester::walk.reject("Nope"); });
+    CHECK(rej.rejection().message() == "Nope");
+    CHECK_FALSE(rej.rejection().path().has_value());
+}
+
+TEST_CASE("Rejecting does not allocate") {
+    using namespace semester::walk_ops;
+    const semester::json_data dat = semester::json_data::mapping_type{{"foo", 1}, {"bar", "x"}};
+    const auto unhandled = mapping{if_key{"foo", just_accept}};
+    const auto wrong_type
+        = mapping{if_key{"foo", just_accept},
+                  if_key{"bar", require_type<double>("'bar' must be a number")}};
+
+    // Walking reserves the storage of a rejection before the first one is made
+    static_cast<void>(semester::walk.try_walk(dat, unhandled));
+
+    const auto before = n_allocations;
+    for (int i = 0; i < 100; ++i) {
+        auto rej = semester::walk.try_walk(dat, unhandled);
+        CHECK(rej.rejection().code() == semester::walk_errc::unhandled_key);
+        auto rej2 = semester::walk.try_walk(dat, wrong_type);
+        CHECK(rej2.rejection().code() == semester::walk_errc::wrong_type);
+    }
+    CHECK(n_allocations == before);
+
+    // A rejection keeps its path while its storage is in use by others
+    auto kept = semester::walk.try_walk(dat, wrong_type);
+    auto copy = kept;
+    static_cast<void>(semester::walk.try_walk(dat, unhandled));
+    CHECK(copy.rejection().message() == "<root>/bar: 'bar' must be a number");
+
+    // The first rejection on a thread does not allocate, and neither do
+    // rejections while many others are kept
+    std::vector<std::size_t> allocated;
+    std::thread([&] {
+        std::vector<semester::walk_result> results;
+        results.reserve(20);
+        allocated.reserve(20);
+        for (int i = 0; i < 20; ++i) {
+            results.push_back(semester::walk.try_walk(dat, [&](auto&&) -> semester::walk_result {
+                const auto at_start = n_allocations;
+                semester::walk_result rej
+                    = semester::walk_reject{semester::walk_errc::wrong_type, "Nope"};
+                allocated.push_back(n_allocations - at_start);
+                return rej;
+            }));
+        }
+    }).join();
+    CHECK(allocated == std::vector<std::size_t>(20, 0));
 }
 
 TEST_CASE("Just accept") {
@@ -172,4 +474,230 @@ TEST_CASE("Just accept") {
     };
 
     semester::walk(dat, mapping{if_key{"foo", just_accept}});
-}
\ No newline at end of file
+}
+
+TEST_CASE("Walk flat JSON mappings") {
+    semester::json_flat_data data = semester::json_flat_data::mapping_type{
+        {"foo", "bar"},
+        {"baz", 33.0},
+    };
+
+    using namespace semester::walk_ops;
+    std::string foo_string;
+    double      baz_value = 0;
+    semester::walk(data,
+                   mapping{
+                       required_key{"foo", "'foo' is required", put_into(foo_string)},
+                       if_key{"baz", put_into(baz_value)},
+                   });
+    CHECK(foo_string == "bar");
+    CHECK(baz_value == 33.0);
+}
+
+TEST_CASE("Mapping key handlers run in order") {
+    semester::json_data dat = semester::json_data::mapping_type{
+        {"a", 1},
+        {"b", 2},
+        {"c", 3},
+    };
+
+    using namespace semester::walk_ops;
+    std::string order;
+    auto        record = [&](std::string what) {
+        return [&order, what](auto&&...) {
+            order += what;
+            return semester::walk.accept;
+        };
+    };
+    auto record_any = [&](std::string what) {
+        return [&order, what](auto&& key, auto&&) {
+            order += what + std::string(key) + ",";
+            return semester::walk.pass;
+        };
+    };
+    semester::walk(dat,
+                   mapping{
+                       record_any("any1:"),
+                       if_key{"b", record("b,")},
+                       record_any("any2:"),
+                       if_key{"a", record("a,")},
+                       if_key{"a", reject_with("Not reached")},
+                       required_key{"c", "'c' is required", record("c,")},
+                   });
+    CHECK(order == "any1:a,any2:a,a,any1:b,b,any1:c,any2:c,c,");
+
+    auto rej = semester::walk.try_walk(dat,
+                                       mapping{
+                                           if_key{"a", just_accept},
+                                           record_any(""),
+                                           if_key{"b", just_accept},
+                                       });
+    REQUIRE(rej.rejected());
+    CHECK(rej.rejection().message() == "<root>: Unhandled key: c");
+}
+
+TEST_CASE("Static mapping keys") {
+    using namespace semester::walk_ops;
+    constexpr auto foo_key = "foo"_key;
+    static_assert(decltype(foo_key)::value == "foo");
+    static_assert(decltype(foo_key)::matches(std::string_view("foo")));
+    static_assert(!decltype(foo_key)::matches(std::string_view("fo")));
+
+    // Walkers with static keys and no state can be built at compile time
+    constexpr auto constant_walker = mapping{if_key{"foo"_key, just_accept}};
+
+    semester::json_data dat = semester::json_data::mapping_type{
+        {"foo", "bar"},
+        {"baz", 33.0},
+    };
+    auto walker = constant_walker;
+    semester::walk(semester::json_data(semester::json_data::mapping_type{{"foo", 1}}), walker);
+
+    std::string foo_string;
+    double      baz_value = 0;
+    semester::walk(dat,
+                   mapping{
+                       required_key{"foo"_key, "'foo' is required", put_into(foo_string)},
+                       if_key{"baz"_key, put_into(baz_value)},
+                   });
+    CHECK(foo_string == "bar");
+    CHECK(baz_value == 33.0);
+
+    auto rej = semester::walk.try_walk(
+        dat,
+        mapping{
+            required_key{"quux"_key, "'quux' is required", just_accept},
+            if_key{"foo"_key, just_accept},
+            if_key{"baz", just_accept},
+        });
+    REQUIRE(rej.rejected());
+    CHECK(rej.rejection().message()
+          == "<root>: Missing required key/property: 'quux' is required");
+}
+
+TEST_CASE("A const walker can be shared between threads") {
+    using namespace semester::walk_ops;
+    static const auto validate = mapping{
+        required_key{"name"_key,
+                     "A 'name' is required",
+                     require_type<std::string>("'name' must be a string"),
+                     just_accept},
+        if_key{"id"_key, require_type<double>("'id' must be a number"), just_accept},
+    };
+
+    using map_type                    = semester::json_data::mapping_type;
+    const semester::json_data good    = map_type{{"name", "Joe"}, {"id", 4}};
+    const semester::json_data missing = map_type{{"id", 4}};
+
+    std::array<int, 4>       good_accepted    = {};
+    std::array<int, 4>       missing_rejected = {};
+    std::vector<std::thread> threads;
+    for (std::size_t n = 0; n < good_accepted.size(); ++n) {
+        threads.emplace_back([&, n] {
+            for (int i = 0; i < 200; ++i) {
+                // Alternate, so a required key seen in one walk must not leak into the next
+                auto acc = semester::walk.try_walk(good, validate);
+                auto rej = semester::walk.try_walk(missing, validate);
+                good_accepted[n] += acc == semester::walk_accept;
+                missing_rejected[n]
+                    += rej.rejected()
+                    && rej.rejection().code() == semester::walk_errc::missing_required_key;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (std::size_t n = 0; n < good_accepted.size(); ++n) {
+        CHECK(good_accepted[n] == 200);
+        CHECK(missing_rejected[n] == 200);
+    }
+}
+
+TEST_CASE("Walk an array in parallel") {
+    using namespace semester::walk_ops;
+    semester::json_data::array_type items;
+    for (int i = 0; i < 10000; ++i) {
+        items.emplace_back(semester::json_data::mapping_type{{"n", i}});
+    }
+    semester::json_data dat = semester::json_data::mapping_type{{"items", items}};
+
+    std::atomic<int> count{0};
+    const auto       count_item = [&](const semester::json_data&) {
+        ++count;
+        return semester::walk.accept;
+    };
+    const auto opts = parallel_walk_options{.max_threads = 4, .chunk_size = 64};
+    semester::walk(dat, mapping{if_key{"items", parallel_for_each{opts, count_item}}});
+    CHECK(count == 10000);
+
+    // Several elements fail, but the one with the lowest index is always reported
+    auto& arr = semester::get<semester::json_data::array_type>(
+        semester::get<semester::json_data::mapping_type>(dat).find("items")->second);
+    arr[9000] = "bad";
+    arr[5000] = "bad";
+    arr[7000] = 12;
+    for (int i = 0; i < 20; ++i) {
+        auto rej = semester::walk.try_walk(
+            dat,
+            mapping{if_key{"items",
+                           parallel_for_each{opts,
+                                             require_type<semester::json_data::mapping_type>(
+                                                 "Items must be mappings"),
+                                             just_accept}}});
+        REQUIRE(rej.rejected());
+        CHECK(rej.rejection().message() == "<root>/items[5000]: Items must be mappings");
+    }
+
+#if !SEMESTER_NO_EXCEPTIONS
+    // Exceptions are reported in the same order as rejections
+    arr[4000] = semester::json_data(semester::json_data::array_type{});
+    const auto throw_array = [](const semester::json_data::array_type&) -> semester::walk_result {
+        throw std::runtime_error("An array at " + semester::walk.path());
+    };
+    CHECK_THROWS_WITH(
+        semester::walk(dat,
+                       mapping{if_key{"items",
+                                      parallel_for_each{opts,
+                                                        if_mapping{just_accept},
+                                                        throw_array,
+                                                        if_type<std::string>(
+                                                            reject_with("A string"))}}}),
+        Catch::Contains("<root>/items[4000]"));
+#endif
+
+    // Small arrays are walked on the calling thread
+    count = 0;
+    semester::walk(semester::json_data(semester::json_data::array_type{1, 2, 3}),
+                   parallel_for_each{count_item});
+    CHECK(count == 3);
+}
+
+TEST_CASE("Nested parallel walks run on the threads of the pool") {
+    using namespace semester::walk_ops;
+    semester::json_data::array_type rows;
+    for (int i = 0; i < 64; ++i) {
+        rows.emplace_back(semester::json_data::array_type(64, semester::json_data(i)));
+    }
+    const semester::json_data dat = std::move(rows);
+
+    semester::walk_thread_pool pool{3};
+    const auto opts = parallel_walk_options{.chunk_size = 4, .pool = &pool};
+
+    std::mutex                mutex;
+    std::set<std::thread::id> thread_ids;
+    std::atomic<int>          count{0};
+    const auto                record = [&](double) {
+        ++count;
+        std::lock_guard lock{mutex};
+        thread_ids.insert(std::this_thread::get_id());
+        return semester::walk.accept;
+    };
+    const auto walker = parallel_for_each{opts, parallel_for_each{opts, record}};
+    for (int i = 0; i < 3; ++i) {
+        semester::walk(dat, walker);
+    }
+    CHECK(count == 3 * 64 * 64);
+    // The pool and the calling thread do all of the work, however deep the nesting
+    CHECK(thread_ids.size() <= pool.size() + 1);
+}